@@ -0,0 +1,76 @@
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "CFADecodeBenchmark.h"
+#include "../src/Assets/CFAFile.h"
+
+#include "components/debug/Debug.h"
+#include "components/utilities/Profiler.h"
+#include "components/vfs/manager.hpp"
+
+namespace
+{
+	constexpr int RunCount = 7;
+
+	// Returns the best time in milliseconds of several runs over all the files, decoding at most
+	// the given number of frames per file.
+	double timeDecode(const std::vector<std::string> &filenames, int maxFrameCount)
+	{
+		double bestMilliseconds = std::numeric_limits<double>::infinity();
+		for (int run = 0; run < RunCount; run++)
+		{
+			Profiler::Sampler sampler;
+			sampler.setStart();
+			for (const std::string &filename : filenames)
+			{
+				CFAFile cfa;
+				if (!cfa.init(filename.c_str()))
+				{
+					continue;
+				}
+
+				const int frameCount = std::min(cfa.getImageCount(), maxFrameCount);
+				for (int i = 0; i < frameCount; i++)
+				{
+					static_cast<void>(cfa.getPixels(i));
+				}
+			}
+
+			sampler.setStop();
+			bestMilliseconds = std::min(bestMilliseconds, sampler.getMilliseconds());
+		}
+
+		return bestMilliseconds;
+	}
+}
+
+void CFADecodeBenchmark::run(const std::string &arenaPath)
+{
+	VFS::Manager::get().initialize(std::string(arenaPath));
+
+	const std::vector<std::string> filenames = VFS::Manager::get().list("*.CFA");
+	if (filenames.empty())
+	{
+		DebugLogWarning("No .CFA files in \"" + arenaPath + "\".");
+		return;
+	}
+
+	int frameCount = 0;
+	for (const std::string &filename : filenames)
+	{
+		CFAFile cfa;
+		if (cfa.init(filename.c_str()))
+		{
+			frameCount += cfa.getImageCount();
+		}
+	}
+
+	const double headerMilliseconds = timeDecode(filenames, 0);
+	const double firstFrameMilliseconds = timeDecode(filenames, 1);
+	const double allFramesMilliseconds = timeDecode(filenames, std::numeric_limits<int>::max());
+	DebugLog(std::to_string(filenames.size()) + " .CFA files, " + std::to_string(frameCount) +
+		" frames: load " + std::to_string(headerMilliseconds) + " ms, first frame " +
+		std::to_string(firstFrameMilliseconds) + " ms, all frames " +
+		std::to_string(allFramesMilliseconds) + " ms.");
+}
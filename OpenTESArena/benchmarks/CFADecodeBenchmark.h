@@ -0,0 +1,14 @@
+#ifndef CFA_DECODE_BENCHMARK_H
+#define CFA_DECODE_BENCHMARK_H
+
+#include <string>
+
+// Times loading every .CFA file in the Arena data folder, decoding only the first frame the way
+// a level with a single visible frame does, and decoding every frame the way eager loading did.
+
+namespace CFADecodeBenchmark
+{
+	void run(const std::string &arenaPath);
+}
+
+#endif
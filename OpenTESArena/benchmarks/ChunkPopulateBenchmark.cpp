@@ -0,0 +1,91 @@
+#include <string>
+
+#include "ChunkPopulateBenchmark.h"
+#include "../src/World/Chunk.h"
+#include "../src/World/ChunkManager.h"
+#include "../src/World/LevelDefinition.h"
+
+#include "components/debug/Debug.h"
+#include "components/utilities/Profiler.h"
+
+namespace
+{
+	constexpr int LevelHeight = 6;
+	constexpr int IterationCount = 2000;
+
+	// Fills the level with a repeating pattern of voxel IDs below the given count.
+	void makeLevel(SNInt width, WEInt depth, int voxelDefCount, LevelDefinition *outLevelDef)
+	{
+		outLevelDef->init(width, LevelHeight, depth);
+		for (WEInt z = 0; z < depth; z++)
+		{
+			for (int y = 0; y < LevelHeight; y++)
+			{
+				for (SNInt x = 0; x < width; x++)
+				{
+					const int voxelDefID = ((x * 7) + (y * 13) + (z * 3)) % voxelDefCount;
+					outLevelDef->setVoxel(x, y, z, voxelDefID);
+				}
+			}
+		}
+	}
+
+	// Returns the average time in microseconds to fill one chunk from the level.
+	double timePopulate(const LevelDefinition &levelDef)
+	{
+		const SNInt chunkCountX = (levelDef.getWidth() + Chunk::WIDTH - 1) / Chunk::WIDTH;
+		const WEInt chunkCountZ = (levelDef.getDepth() + Chunk::DEPTH - 1) / Chunk::DEPTH;
+
+		Chunk chunk;
+		chunk.init(ChunkInt2(0, 0), levelDef.getHeight());
+
+		// Read back a voxel each pass so the copies can't be skipped.
+		int checksum = 0;
+
+		Profiler::Sampler sampler;
+		sampler.setStart();
+		for (int i = 0; i < IterationCount; i++)
+		{
+			for (WEInt chunkZ = 0; chunkZ < chunkCountZ; chunkZ++)
+			{
+				for (SNInt chunkX = 0; chunkX < chunkCountX; chunkX++)
+				{
+					const LevelInt2 levelOffset(chunkX * Chunk::WIDTH, chunkZ * Chunk::DEPTH);
+					ChunkManager::populateChunkVoxels(chunk, levelDef, levelOffset);
+					checksum += chunk.getVoxel(i % Chunk::WIDTH, 0, chunkX % Chunk::DEPTH);
+				}
+			}
+		}
+
+		sampler.setStop();
+
+		const int populateCount = IterationCount * chunkCountX * chunkCountZ;
+		DebugLog("Checksum: " + std::to_string(checksum));
+		return (sampler.getSeconds() * 1000000.0) / static_cast<double>(populateCount);
+	}
+
+	void runCase(const std::string &name, const LevelDefinition &levelDef)
+	{
+		const double microseconds = timePopulate(levelDef);
+		DebugLog(name + ": " + std::to_string(microseconds) + " us per chunk.");
+	}
+}
+
+void ChunkPopulateBenchmark::run()
+{
+	// Wilderness blocks are one chunk wide, so whole XY planes are copied at once.
+	LevelDefinition wildLevelDef;
+	makeLevel(Chunk::WIDTH, Chunk::DEPTH, 64, &wildLevelDef);
+	runCase("Wilderness block", wildLevelDef);
+
+	// Cities span several chunks, so each X row is copied at once.
+	LevelDefinition cityLevelDef;
+	makeLevel(Chunk::WIDTH * 2, Chunk::DEPTH * 2, 64, &cityLevelDef);
+	runCase("City", cityLevelDef);
+
+	// A voxel ID too big for a chunk makes every voxel go through the range check.
+	LevelDefinition checkedLevelDef;
+	makeLevel(Chunk::WIDTH * 2, Chunk::DEPTH * 2, 64, &checkedLevelDef);
+	checkedLevelDef.setVoxel(0, 0, 0, 1 << 16);
+	runCase("City (per-voxel)", checkedLevelDef);
+}
@@ -0,0 +1,11 @@
+#ifndef CHUNK_POPULATE_BENCHMARK_H
+#define CHUNK_POPULATE_BENCHMARK_H
+
+// Times copying level voxels into chunks for the level shapes the chunk manager sees.
+
+namespace ChunkPopulateBenchmark
+{
+	void run();
+}
+
+#endif
@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <limits>
+#include <string>
+
+#include "DepthBufferBenchmark.h"
+
+#include "components/debug/Debug.h"
+#include "components/utilities/Buffer2D.h"
+#include "components/utilities/BufferAllocator.h"
+#include "components/utilities/Profiler.h"
+
+namespace
+{
+	constexpr int PassCount = 5;
+	constexpr int RunCount = 7;
+
+	// Returns the best time in milliseconds of several runs over the depth buffer.
+	double timeColumnWalk(int width, int height, BufferAllocation allocation)
+	{
+		Buffer2D<double> depthBuffer;
+		depthBuffer.init(width, height, allocation);
+
+		double *depth = depthBuffer.get();
+		double bestMilliseconds = std::numeric_limits<double>::infinity();
+		for (int run = 0; run < RunCount; run++)
+		{
+			Profiler::Sampler sampler;
+			sampler.setStart();
+			for (int pass = 0; pass < PassCount; pass++)
+			{
+				// Depth test and write each pixel one column at a time.
+				const double value = static_cast<double>(pass + 1);
+				for (int x = 0; x < width; x++)
+				{
+					for (int y = 0; y < height; y++)
+					{
+						double &pixelDepth = depth[x + (y * width)];
+						pixelDepth = (pixelDepth < value) ? value : pixelDepth;
+					}
+				}
+			}
+
+			sampler.setStop();
+			bestMilliseconds = std::min(bestMilliseconds, sampler.getMilliseconds());
+		}
+
+		return bestMilliseconds;
+	}
+
+	void runCase(int width, int height)
+	{
+		const double heapMilliseconds = timeColumnWalk(width, height, BufferAllocation::Default);
+		const double largePageMilliseconds = timeColumnWalk(width, height, BufferAllocation::LargePages);
+		DebugLog(std::to_string(width) + "x" + std::to_string(height) + ": heap " +
+			std::to_string(heapMilliseconds) + " ms, large pages " + std::to_string(largePageMilliseconds) + " ms.");
+	}
+}
+
+void DepthBufferBenchmark::run()
+{
+	const bool largePagesEnabled = BufferAllocator::isLargePagesEnabled();
+	BufferAllocator::setLargePagesEnabled(true);
+
+	runCase(1280, 720);
+	runCase(1920, 1080);
+	runCase(3840, 2160);
+
+	BufferAllocator::setLargePagesEnabled(largePagesEnabled);
+}
@@ -0,0 +1,12 @@
+#ifndef DEPTH_BUFFER_BENCHMARK_H
+#define DEPTH_BUFFER_BENCHMARK_H
+
+// Times a column-order walk over a depth buffer on the heap and with large pages, the way the
+// software renderer draws walls and flats.
+
+namespace DepthBufferBenchmark
+{
+	void run();
+}
+
+#endif
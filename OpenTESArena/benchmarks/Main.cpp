@@ -0,0 +1,28 @@
+#include <cstdlib>
+#include <string>
+
+#include "CFADecodeBenchmark.h"
+#include "ChunkPopulateBenchmark.h"
+#include "DepthBufferBenchmark.h"
+
+#include "components/debug/Debug.h"
+
+// Standalone timings of engine code that is hard to isolate in a running game. Benchmarks that
+// read game assets need the Arena data folder as the first argument.
+
+int main(int argc, char *argv[])
+{
+	ChunkPopulateBenchmark::run();
+	DepthBufferBenchmark::run();
+
+	if (argc >= 2)
+	{
+		CFADecodeBenchmark::run(std::string(argv[1]));
+	}
+	else
+	{
+		DebugLog("No Arena data folder given, skipping asset benchmarks.");
+	}
+
+	return EXIT_SUCCESS;
+}
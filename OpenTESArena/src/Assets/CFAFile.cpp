@@ -1,5 +1,7 @@
 #include <algorithm>
 #include <array>
+#include <cstring>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -10,6 +12,101 @@
 #include "components/utilities/Bytes.h"
 #include "components/vfs/manager.hpp"
 
+namespace
+{
+	// Bytes per packed group and palette indices per group for each bits-per-pixel, so every
+	// group demuxes to a whole number of pixels. Adapted from WinArena.
+	struct DemuxFormat
+	{
+		int bytesPerGroup;
+		int pixelsPerGroup;
+	};
+
+	constexpr std::array<DemuxFormat, 7> DemuxFormats =
+	{
+		{
+			{ 1, 8 }, // 1 bit per pixel
+			{ 1, 4 },
+			{ 3, 8 },
+			{ 2, 4 },
+			{ 5, 8 },
+			{ 3, 4 },
+			{ 7, 8 }
+		}
+	};
+
+	// Demuxes one group of big-endian packed values into palette indices.
+	template <int BitsPerPixel>
+	void DemuxGroup(const uint8_t *src, uint8_t *dst, const uint8_t *lookUpTable)
+	{
+		constexpr DemuxFormat format = DemuxFormats[BitsPerPixel - 1];
+		constexpr uint64_t mask = (1 << BitsPerPixel) - 1;
+
+		uint64_t bits = 0;
+		for (int i = 0; i < format.bytesPerGroup; i++)
+		{
+			bits = (bits << 8) | src[i];
+		}
+
+		for (int i = 0; i < format.pixelsPerGroup; i++)
+		{
+			const int shift = (format.bytesPerGroup * 8) - (BitsPerPixel * (i + 1));
+			dst[i] = lookUpTable[(bits >> shift) & mask];
+		}
+	}
+
+	// Demuxes a row of packed values, writing whole groups straight to the destination.
+	template <int BitsPerPixel>
+	void DemuxRow(const uint8_t *src, int srcCount, uint8_t *dst, int pixelCount,
+		const uint8_t *lookUpTable, const CFAFile::ByteTable &byteTable)
+	{
+		constexpr DemuxFormat format = DemuxFormats[BitsPerPixel - 1];
+		const int fullGroupCount = std::min(srcCount / format.bytesPerGroup,
+			pixelCount / format.pixelsPerGroup);
+
+		if constexpr ((8 % BitsPerPixel) == 0)
+		{
+			// Values don't straddle bytes, so each byte's palette indices are in the byte table.
+			constexpr int pixelsPerByte = 8 / BitsPerPixel;
+			const int fullByteCount = fullGroupCount * format.bytesPerGroup;
+			for (int i = 0; i < fullByteCount; i++)
+			{
+				std::memcpy(dst + (i * pixelsPerByte), byteTable[src[i]].data(), pixelsPerByte);
+			}
+		}
+		else
+		{
+			for (int i = 0; i < fullGroupCount; i++)
+			{
+				DemuxGroup<BitsPerPixel>(src + (i * format.bytesPerGroup),
+					dst + (i * format.pixelsPerGroup), lookUpTable);
+			}
+		}
+
+		// The last group might be cut off by the end of the row, where packed values are zero,
+		// or by the image width.
+		const int srcIndex = fullGroupCount * format.bytesPerGroup;
+		const int dstIndex = fullGroupCount * format.pixelsPerGroup;
+		if (dstIndex < pixelCount)
+		{
+			std::array<uint8_t, 8> groupSrc;
+			groupSrc.fill(0);
+			std::copy(src + srcIndex, src + std::min(srcIndex + format.bytesPerGroup, srcCount),
+				groupSrc.begin());
+
+			std::array<uint8_t, 8> groupDst;
+			DemuxGroup<BitsPerPixel>(groupSrc.data(), groupDst.data(), lookUpTable);
+			std::copy(groupDst.begin(), groupDst.begin() + (pixelCount - dstIndex), dst + dstIndex);
+		}
+	}
+
+	using DemuxRowFunc = void(*)(const uint8_t*, int, uint8_t*, int, const uint8_t*, const CFAFile::ByteTable&);
+	constexpr std::array<DemuxRowFunc, 7> DemuxRowFuncs =
+	{
+		DemuxRow<1>, DemuxRow<2>, DemuxRow<3>, DemuxRow<4>, DemuxRow<5>, DemuxRow<6>, DemuxRow<7>
+	};
+}
+
 bool CFAFile::init(const char *filename)
 {
 	Buffer<std::byte> src;
@@ -31,129 +128,88 @@ bool CFAFile::init(const char *filename)
 	const uint8_t frameCount = *(srcPtr + 11);
 	const uint16_t headerSize = Bytes::getLE16(srcPtr + 12);
 
-	// Adapted from WinArena.
-
-	// Pointer to the look-up conversion table. This is how the packed colors
-	// are converted into useful palette indices.
-	const uint8_t *lookUpTable = srcPtr + 76;
-
-	// Line buffer (generously over-allocated for demuxing).
-	Buffer<uint8_t> encoded(widthUncompressed + 16);
-	encoded.fill(0);
-
-	// Index values from demuxing are stored here each pass, and are
-	// eventually translated into color indices.
-	std::array<uint8_t, 8> translate;
+	if ((headerSize > src.getCount()) || (bitsPerPixel < 1) || (bitsPerPixel > 8))
+	{
+		DebugLogError("Invalid .CFA header in \"" + std::string(filename) + "\".");
+		return false;
+	}
 
-	// Worse-case buffer for decompressed data (due to possible padding
-	// with demux alignment).
-	std::vector<uint8_t> decomp(widthCompressed * height * frameCount *
-		sizeof(uint32_t) + (widthUncompressed * 16));
+	// The look-up conversion table after the fixed header part is how the packed values are
+	// converted into useful palette indices.
+	constexpr int lookUpTableOffset = 76;
+	this->lookUpTable.fill(0);
+	if (headerSize > lookUpTableOffset)
+	{
+		const int lookUpTableSize = std::min(headerSize - lookUpTableOffset,
+			static_cast<int>(this->lookUpTable.size()));
+		std::copy(srcPtr + lookUpTableOffset, srcPtr + lookUpTableOffset + lookUpTableSize,
+			this->lookUpTable.begin());
+	}
 
-	// Decompress the RLE data of the CFA images (they're all packed together).
-	Compression::decodeRLE(srcPtr + headerSize, widthCompressed * height * frameCount,
-		decomp.data(), static_cast<int>(decomp.size()));
+	this->width = widthUncompressed;
+	this->height = height;
+	this->widthCompressed = widthCompressed;
+	this->xOffset = xOffset;
+	this->yOffset = yOffset;
+	this->bitsPerPixel = bitsPerPixel;
 
-	// Buffers for frame palette indices.
+	// Keep the RLE data of the CFA images (they're all packed together) until a frame is needed.
+	this->compressed.assign(srcPtr + headerSize, srcPtr + src.getCount());
 	this->images.init(frameCount);
-	for (int i = 0; i < this->images.getCount(); i++)
-	{
-		Buffer2D<uint8_t> &image = this->images.get(i);
-		image.init(widthUncompressed, height);
-	}
+	this->imageFlags.init(frameCount);
 
-	// Byte offset into bit-packed data. All frames are packed together,
-	// so this value can simply be incremented by the compressed width.
-	uint32_t offset = 0;
+	return true;
+}
 
-	for (int i = 0; i < this->images.getCount(); i++)
+void CFAFile::decodePacked() const
+{
+	// The last run can write up to 127 bytes past the stop count.
+	constexpr int maxRunOvershoot = 127;
+	const int packedCount = this->widthCompressed * this->height * this->images.getCount();
+	this->packed.resize(packedCount + maxRunOvershoot);
+	Compression::decodeRLE(this->compressed.data(), packedCount, this->packed.data(),
+		static_cast<int>(this->packed.size()));
+
+	// Every frame is decompressed now, so the RLE data isn't needed anymore.
+	this->compressed.clear();
+	this->compressed.shrink_to_fit();
+
+	// Formats that don't straddle bytes demux a whole byte with one look-up.
+	if ((this->bitsPerPixel < 8) && ((8 % this->bitsPerPixel) == 0))
 	{
-		// Destination buffer for the frame's decompressed palette indices.
-		Buffer2D<uint8_t> &dst = this->images.get(i);
-		uint32_t dstOffset = 0;
-
-		for (uint32_t y = 0; y < height; y++)
+		const int pixelsPerByte = 8 / this->bitsPerPixel;
+		const int mask = (1 << this->bitsPerPixel) - 1;
+		this->byteTable.resize(256);
+		for (int i = 0; i < static_cast<int>(this->byteTable.size()); i++)
 		{
-			uint32_t count = widthUncompressed;
-
-			// Copy the current line to the scratch buffer.
-			const uint8_t *decompPtr = decomp.data() + offset;
-			std::copy(decompPtr, decompPtr + widthCompressed, encoded.get());
-
-			// Lambda for which demux routine to do, based on bits per pixel.
-			auto runDemux = [&dst, dstOffset, &count, &encoded, &translate, lookUpTable](
-				uint32_t end, void(*demux)(const uint8_t*, uint8_t*),
-				uint32_t demuxMultiplier, uint32_t upToMin)
-			{
-				for (uint32_t x = 0; x < end; x++)
-				{
-					demux(encoded.get() + (x * demuxMultiplier), translate.data());
-
-					uint32_t upTo = std::min(upToMin, count);
-					count -= upTo;
-
-					uint8_t *dstPtr = dst.get();
-					for (uint32_t i = 0; i < upTo; i++)
-					{
-						const int dstIndex = (x * upToMin) + i + dstOffset;
-						const uint8_t translateVal = translate[i];
-						dstPtr[dstIndex] = lookUpTable[translateVal];
-					}
-				}
-			};
-
-			// Choose the demuxing routine.
-			if (bitsPerPixel == 8)
-			{
-				// No demuxing needed.
-				const uint8_t *encodedPtr = encoded.get();
-				uint8_t *dstPtr = dst.get();
-				for (uint32_t x = 0; x < widthCompressed; x++)
-				{
-					const int dstIndex = x + dstOffset;
-					dstPtr[dstIndex] = encodedPtr[x];
-				}
-			}
-			else if (bitsPerPixel == 7)
-			{
-				runDemux((widthCompressed + 6) / 7, CFAFile::demux7, 7, 8);
-			}
-			else if (bitsPerPixel == 6)
-			{
-				runDemux((widthCompressed + 2) / 3, CFAFile::demux6, 3, 4);
-			}
-			else if (bitsPerPixel == 5)
-			{
-				runDemux((widthCompressed + 4) / 5, CFAFile::demux5, 5, 8);
-			}
-			else if (bitsPerPixel == 4)
-			{
-				runDemux((widthCompressed + 1) / 2, CFAFile::demux4, 2, 4);
-			}
-			else if (bitsPerPixel == 3)
-			{
-				runDemux((widthCompressed + 2) / 3, CFAFile::demux3, 3, 8);
-			}
-			else if (bitsPerPixel == 2)
-			{
-				runDemux(widthCompressed, CFAFile::demux2, 1, 4);
-			}
-			else if (bitsPerPixel == 1)
+			std::array<uint8_t, 8> &pixels = this->byteTable[i];
+			pixels.fill(0);
+			for (int j = 0; j < pixelsPerByte; j++)
 			{
-				runDemux(widthCompressed, CFAFile::demux1, 1, 8);
+				const int shift = 8 - (this->bitsPerPixel * (j + 1));
+				pixels[j] = this->lookUpTable[(i >> shift) & mask];
 			}
-
-			// Move offsets to the next compressed line of data.
-			offset += widthCompressed;
-			dstOffset += widthUncompressed;
 		}
 	}
+}
 
-	this->width = widthUncompressed;
-	this->height = height;
-	this->xOffset = xOffset;
-	this->yOffset = yOffset;
-	return true;
+void CFAFile::demuxRow(const uint8_t *src, uint8_t *dst, const ByteTable &byteTable) const
+{
+	if (this->bitsPerPixel == 8)
+	{
+		// No demuxing needed.
+		std::copy(src, src + std::min(this->widthCompressed, this->width), dst);
+		return;
+	}
+
+	const DemuxFormat &format = DemuxFormats[this->bitsPerPixel - 1];
+	const int groupCount = (this->widthCompressed + format.bytesPerGroup - 1) / format.bytesPerGroup;
+	const int pixelCount = std::min(groupCount * format.pixelsPerGroup, this->width);
+
+	const DemuxRowFunc demuxRowFunc = DemuxRowFuncs[this->bitsPerPixel - 1];
+	demuxRowFunc(src, this->widthCompressed, dst, pixelCount, this->lookUpTable.data(), byteTable);
+
+	std::fill(dst + pixelCount, dst + this->width, 0);
 }
 
 int CFAFile::getImageCount() const
@@ -181,82 +237,34 @@ int CFAFile::getYOffset() const
 	return this->yOffset;
 }
 
-const uint8_t *CFAFile::getPixels(int index) const
+void CFAFile::decodePixels(int index, uint8_t *dst) const
 {
 	DebugAssert(index >= 0);
 	DebugAssert(index < this->images.getCount());
-	const Buffer2D<uint8_t> &image = this->images.get(index);
-	return image.get();
-}
 
-void CFAFile::demux1(const uint8_t *src, uint8_t *dst)
-{
-	dst[0] = (src[0] & 0x80) >> 7;
-	dst[1] = (src[0] & 0x40) >> 6;
-	dst[2] = (src[0] & 0x20) >> 5;
-	dst[3] = (src[0] & 0x10) >> 4;
-	dst[4] = (src[0] & 0x08) >> 3;
-	dst[5] = (src[0] & 0x04) >> 2;
-	dst[6] = (src[0] & 0x02) >> 1;
-	dst[7] = src[0] & 0x01;
-}
-
-void CFAFile::demux2(const uint8_t *src, uint8_t *dst)
-{
-	dst[0] = (src[0] & 0xC0) >> 6;
-	dst[1] = (src[0] & 0x30) >> 4;
-	dst[2] = (src[0] & 0x0C) >> 2;
-	dst[3] = src[0] & 0x03;
-}
-
-void CFAFile::demux3(const uint8_t *src, uint8_t *dst)
-{
-	dst[0] = (src[0] & 0xE0) >> 5;
-	dst[1] = (src[0] & 0x1C) >> 2;
-	dst[2] = ((src[0] & 0x03) << 1) | ((src[1] & 0x80) >> 7);
-	dst[3] = (src[1] & 0x70) >> 4;
-	dst[4] = (src[1] & 0x0E) >> 1;
-	dst[5] = ((src[1] & 0x01) << 2) | ((src[2] & 0xC0) >> 6);
-	dst[6] = (src[2] & 0x38) >> 3;
-	dst[7] = src[2] & 0x07;
-}
+	std::call_once(this->packedFlag, [this]() { this->decodePacked(); });
 
-void CFAFile::demux4(const uint8_t *src, uint8_t *dst)
-{
-	dst[0] = (src[0] & 0xF0) >> 4;
-	dst[1] = src[0] & 0x0F;
-	dst[2] = (src[1] & 0xF0) >> 4;
-	dst[3] = src[1] & 0x0F;
+	// Demux the frame's rows into palette indices.
+	const int frameOffset = this->widthCompressed * this->height * index;
+	for (int y = 0; y < this->height; y++)
+	{
+		const uint8_t *srcRow = this->packed.data() + frameOffset + (y * this->widthCompressed);
+		uint8_t *dstRow = dst + (y * this->width);
+		this->demuxRow(srcRow, dstRow, this->byteTable);
+	}
 }
 
-void CFAFile::demux5(const uint8_t *src, uint8_t *dst)
+const uint8_t *CFAFile::getPixels(int index) const
 {
-	dst[0] = (src[0] & 0xF8) >> 3;
-	dst[1] = ((src[0] & 0x07) << 2) | ((src[1] & 0xC0) >> 6);
-	dst[2] = (src[1] & 0x3E) >> 1;
-	dst[3] = ((src[1] & 0x01) << 4) | ((src[2] & 0xF0) >> 4);
-	dst[4] = ((src[2] & 0x0F) << 1) | ((src[3] & 0x80) >> 7);
-	dst[5] = (src[3] & 0x7C) >> 2;
-	dst[6] = ((src[3] & 0x03) << 3) | ((src[4] & 0xE0) >> 5);
-	dst[7] = src[4] & 0x1F;
-}
+	DebugAssert(index >= 0);
+	DebugAssert(index < this->images.getCount());
 
-void CFAFile::demux6(const uint8_t *src, uint8_t *dst)
-{
-	dst[0] = (src[0] & 0xFC) >> 2;
-	dst[1] = ((src[0] & 0x03) << 4) | ((src[1] & 0xF0) >> 4);
-	dst[2] = ((src[1] & 0x0F) << 2) | ((src[2] & 0xC0) >> 6);
-	dst[3] = src[2] & 0x3F;
-}
+	Buffer2D<uint8_t> &image = this->images.get(index);
+	std::call_once(this->imageFlags.get(index), [this, index, &image]()
+	{
+		image.init(this->width, this->height);
+		this->decodePixels(index, image.get());
+	});
 
-void CFAFile::demux7(const uint8_t *src, uint8_t *dst)
-{
-	dst[0] = (src[0] & 0xFE) >> 1;
-	dst[1] = ((src[0] & 0x01) << 6) | ((src[1] & 0xFC) >> 2);
-	dst[2] = ((src[1] & 0x03) << 5) | ((src[2] & 0xF8) >> 3);
-	dst[3] = ((src[2] & 0x07) << 4) | ((src[3] & 0xF0) >> 4);
-	dst[4] = ((src[3] & 0x0F) << 3) | ((src[4] & 0xE0) >> 5);
-	dst[5] = ((src[4] & 0x1F) << 2) | ((src[5] & 0xC0) >> 6);
-	dst[6] = ((src[5] & 0x3F) << 1) | ((src[6] & 0x80) >> 7);
-	dst[7] = src[6] & 0x7F;
+	return image.get();
 }
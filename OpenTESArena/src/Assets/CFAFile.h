@@ -1,29 +1,46 @@
 #ifndef CFA_FILE_H
 #define CFA_FILE_H
 
+#include <array>
 #include <cstdint>
+#include <mutex>
+#include <vector>
 
 #include "components/utilities/Buffer.h"
 #include "components/utilities/Buffer2D.h"
 
-// A .CFA file is for creatures and spell animations.
+// A .CFA file is for creatures and spell animations. Frames stay compressed until one is requested.
 
 class CFAFile
 {
+public:
+	// Palette indices for each possible packed byte.
+	using ByteTable = std::vector<std::array<uint8_t, 8>>;
 private:
-	Buffer<Buffer2D<uint8_t>> images;
-	int width, height, xOffset, yOffset;
-
-	// CFA files have their palette indices compressed into fewer bits depending
-	// on the total number of colors in the file. These demuxing functions
-	// uncompress those bits into bytes. Adapted from WinArena.
-	static void demux1(const uint8_t *src, uint8_t *dst);
-	static void demux2(const uint8_t *src, uint8_t *dst);
-	static void demux3(const uint8_t *src, uint8_t *dst);
-	static void demux4(const uint8_t *src, uint8_t *dst);
-	static void demux5(const uint8_t *src, uint8_t *dst);
-	static void demux6(const uint8_t *src, uint8_t *dst);
-	static void demux7(const uint8_t *src, uint8_t *dst);
+	// RLE-compressed frames, all packed together in one run. Freed once decompressed.
+	mutable std::vector<uint8_t> compressed;
+
+	// Bit-packed frames, decompressed once for all frames on the first frame request.
+	mutable std::vector<uint8_t> packed;
+	mutable ByteTable byteTable;
+	mutable std::once_flag packedFlag;
+
+	// Demuxed frames, each decoded on its first request.
+	mutable Buffer<Buffer2D<uint8_t>> images;
+	mutable Buffer<std::once_flag> imageFlags;
+
+	// CFA files have their palette indices compressed into fewer bits depending on the total
+	// number of colors in the file. Packed values are converted to palette indices with this.
+	std::array<uint8_t, 256> lookUpTable;
+
+	int width, height, widthCompressed, xOffset, yOffset, bitsPerPixel;
+
+	// Demuxes one row of bit-packed values into palette indices. The byte table is only used
+	// when values don't straddle bytes (1, 2, and 4 bits per pixel).
+	void demuxRow(const uint8_t *src, uint8_t *dst, const ByteTable &byteTable) const;
+
+	// Decompresses the RLE data of all frames and builds the byte table.
+	void decodePacked() const;
 public:
 	bool init(const char *filename);
 
@@ -42,7 +59,10 @@ public:
 	// Gets the Y offset of all images.
 	int getYOffset() const;
 
-	// Gets a pointer to an image's 8-bit pixels.
+	// Decodes an image's 8-bit pixels into a width * height buffer without keeping them.
+	void decodePixels(int index, uint8_t *dst) const;
+
+	// Gets a pointer to an image's 8-bit pixels, decoding them on first access.
 	const uint8_t *getPixels(int index) const;
 };
 
@@ -1,8 +1,81 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+
 #include "Compression.h"
 
 #include "components/debug/Debug.h"
 #include "components/utilities/Bytes.h"
 
+namespace
+{
+	// LZ4 block format constants.
+	constexpr int LZ4_MIN_MATCH = 4;
+	constexpr int LZ4_MAX_OFFSET = 65535;
+	constexpr int LZ4_LAST_LITERALS = 5; // Final bytes are always literals.
+	constexpr int LZ4_MATCH_SAFE_DISTANCE = 12; // Last match must start before this many bytes from the end.
+	constexpr int LZ4_HASH_BITS = 12;
+	constexpr int LZ4_RUN_MASK = 15; // Largest length that fits in a token nibble.
+
+	int getLZ4Hash(uint32_t sequence)
+	{
+		return static_cast<int>((sequence * 2654435761u) >> (32 - LZ4_HASH_BITS));
+	}
+
+	void writeLZ4Length(int length, std::vector<uint8_t> &out)
+	{
+		while (length >= 255)
+		{
+			out.push_back(255);
+			length -= 255;
+		}
+
+		out.push_back(static_cast<uint8_t>(length));
+	}
+
+	int readLZ4Length(const uint8_t *src, int srcSize, int *srcIndex)
+	{
+		int length = 0;
+		uint8_t value;
+		do
+		{
+			DebugAssertMsg(*srcIndex < srcSize, "Unexpected end of LZ4 data.");
+			value = src[*srcIndex];
+			(*srcIndex)++;
+			length += value;
+		} while (value == 255);
+
+		return length;
+	}
+
+	void writeLZ4Sequence(const uint8_t *literals, int literalCount, int offset, int matchLength,
+		std::vector<uint8_t> &out)
+	{
+		const int literalNibble = std::min(literalCount, LZ4_RUN_MASK);
+		const int matchNibble = (matchLength > 0) ? std::min(matchLength - LZ4_MIN_MATCH, LZ4_RUN_MASK) : 0;
+		out.push_back(static_cast<uint8_t>((literalNibble << 4) | matchNibble));
+
+		if (literalNibble == LZ4_RUN_MASK)
+		{
+			writeLZ4Length(literalCount - LZ4_RUN_MASK, out);
+		}
+
+		out.insert(out.end(), literals, literals + literalCount);
+
+		// The last sequence has literals only.
+		if (matchLength > 0)
+		{
+			out.push_back(static_cast<uint8_t>(offset & 0xFF));
+			out.push_back(static_cast<uint8_t>((offset >> 8) & 0xFF));
+
+			if (matchNibble == LZ4_RUN_MASK)
+			{
+				writeLZ4Length(matchLength - LZ4_MIN_MATCH - LZ4_RUN_MASK, out);
+			}
+		}
+	}
+}
+
 void Compression::decodeRLE(const uint8_t *src, int stopCount, uint8_t *dst, int dstSize)
 {
 	// Adapted from WinArena.
@@ -87,3 +160,100 @@ void Compression::decodeRLEWords(const uint8_t *src, int stopCount,
 		}
 	}
 }
+
+void Compression::encodeLZ4(const uint8_t *src, int srcSize, std::vector<uint8_t> &out)
+{
+	out.clear();
+	out.reserve((srcSize / 2) + 16);
+
+	// Most recent position of each hashed 4-byte sequence.
+	std::array<int, 1 << LZ4_HASH_BITS> positions;
+	positions.fill(-1);
+
+	const int matchStartLimit = srcSize - LZ4_MATCH_SAFE_DISTANCE;
+	const int matchEndLimit = srcSize - LZ4_LAST_LITERALS;
+	int anchor = 0;
+	int i = 0;
+
+	while (i < matchStartLimit)
+	{
+		const uint32_t sequence = Bytes::getLE32(src + i);
+		const int hash = getLZ4Hash(sequence);
+		const int candidate = positions[hash];
+		positions[hash] = i;
+
+		const bool isMatch = (candidate >= 0) && ((i - candidate) <= LZ4_MAX_OFFSET) &&
+			(Bytes::getLE32(src + candidate) == sequence);
+		if (!isMatch)
+		{
+			i++;
+			continue;
+		}
+
+		int matchEnd = i + LZ4_MIN_MATCH;
+		while ((matchEnd < matchEndLimit) && (src[matchEnd] == src[candidate + (matchEnd - i)]))
+		{
+			matchEnd++;
+		}
+
+		writeLZ4Sequence(src + anchor, i - anchor, i - candidate, matchEnd - i, out);
+		i = matchEnd;
+		anchor = i;
+	}
+
+	writeLZ4Sequence(src + anchor, srcSize - anchor, 0, 0, out);
+}
+
+void Compression::decodeLZ4(const uint8_t *src, int srcSize, uint8_t *dst, int dstSize)
+{
+	int srcIndex = 0;
+	int dstIndex = 0;
+
+	while (srcIndex < srcSize)
+	{
+		const uint8_t token = src[srcIndex];
+		srcIndex++;
+
+		int literalCount = token >> 4;
+		if (literalCount == LZ4_RUN_MASK)
+		{
+			literalCount += readLZ4Length(src, srcSize, &srcIndex);
+		}
+
+		DebugAssertMsg((srcIndex + literalCount) <= srcSize, "Unexpected end of LZ4 data.");
+		DebugAssertMsg((dstIndex + literalCount) <= dstSize, "LZ4 output overflow.");
+		std::memcpy(dst + dstIndex, src + srcIndex, literalCount);
+		srcIndex += literalCount;
+		dstIndex += literalCount;
+
+		// The last sequence ends after its literals.
+		if (srcIndex == srcSize)
+		{
+			break;
+		}
+
+		DebugAssertMsg((srcIndex + 2) <= srcSize, "Unexpected end of LZ4 data.");
+		const int offset = Bytes::getLE16(src + srcIndex);
+		srcIndex += 2;
+
+		int matchLength = token & LZ4_RUN_MASK;
+		if (matchLength == LZ4_RUN_MASK)
+		{
+			matchLength += readLZ4Length(src, srcSize, &srcIndex);
+		}
+
+		matchLength += LZ4_MIN_MATCH;
+
+		DebugAssertMsg((offset > 0) && (offset <= dstIndex), "Invalid LZ4 match offset.");
+		DebugAssertMsg((dstIndex + matchLength) <= dstSize, "LZ4 output overflow.");
+
+		// Byte by byte since the match may overlap the bytes being written.
+		for (int j = 0; j < matchLength; j++)
+		{
+			dst[dstIndex] = dst[dstIndex - offset];
+			dstIndex++;
+		}
+	}
+
+	DebugAssertMsg(dstIndex == dstSize, "LZ4 output size mismatch.");
+}
@@ -20,6 +20,11 @@ namespace Compression
 	// Uncompresses an RLE run of words. Used with .RMD files.
 	void decodeRLEWords(const uint8_t *src, int stopCount, std::vector<uint8_t> &out);
 
+	// Fast LZ77 compression using the LZ4 block layout. Not an Arena format; used for keeping
+	// rarely-accessed data small in memory.
+	void encodeLZ4(const uint8_t *src, int srcSize, std::vector<uint8_t> &out);
+	void decodeLZ4(const uint8_t *src, int srcSize, uint8_t *dst, int dstSize);
+
 	// Works with .IMG and .CIF type 4 files.
 	template <typename T>
 	void decodeType04(T src, T srcend, std::vector<uint8_t> &out)
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <cmath>
+#include <limits>
 
 #include "DynamicEntity.h"
 #include "EntityManager.h"
@@ -62,6 +63,28 @@ namespace
 	{
 		return random.next() % static_cast<int>(CitizenDirections.size());
 	}
+
+	// Seconds until a point moving at the given velocity enters another voxel.
+	double GetSecondsToVoxelEdge(const NewDouble2 &point, const NewDouble2 &velocity)
+	{
+		auto getAxisSeconds = [](double value, double speed)
+		{
+			if (speed > 0.0)
+			{
+				return (std::floor(value) + 1.0 - value) / speed;
+			}
+			else if (speed < 0.0)
+			{
+				return (value - std::floor(value)) / -speed;
+			}
+			else
+			{
+				return std::numeric_limits<double>::infinity();
+			}
+		};
+
+		return std::min(getAxisSeconds(point.x, velocity.x), getAxisSeconds(point.y, velocity.y));
+	}
 }
 
 DynamicEntity::DynamicEntity()
@@ -316,6 +339,13 @@ void DynamicEntity::updateCitizenState(Game &game, double dt)
 }
 
 void DynamicEntity::updateCreatureState(Game &game, double dt)
+{
+	// @todo: creature AI
+
+	this->updateCreatureSound(game, dt);
+}
+
+void DynamicEntity::updateCreatureSound(Game &game, double dt)
 {
 	auto &gameData = game.getGameData();
 	const auto &worldData = gameData.getActiveWorld();
@@ -324,8 +354,6 @@ void DynamicEntity::updateCreatureState(Game &game, double dt)
 	const auto &entityDefLibrary = game.getEntityDefinitionLibrary();
 	const double ceilingHeight = levelData.getCeilingHeight();
 
-	// @todo: creature AI
-
 	// Tick down the NPC's creature sound (if any). This is done on the top level so the counter
 	// doesn't predictably begin when the player enters the creature's hearing distance.
 	this->secondsTillCreatureSound -= dt;
@@ -510,3 +538,46 @@ void DynamicEntity::tick(Game &game, double dt)
 	const auto &entityDefLibrary = game.getEntityDefinitionLibrary();
 	this->updatePhysics(worldData, entityDefLibrary, game.getRandom(), dt);
 }
+
+void DynamicEntity::catchUpCitizen(Game &game, double dt)
+{
+	// A dormant citizen is far from the player, so it would have started walking if idle.
+	this->updateCitizenState(game, 0.0);
+
+	// Walking citizens only change course when the point ahead of them enters another voxel, so
+	// they can jump from one voxel edge to the next without missing a decision.
+	const auto &worldData = game.getGameData().getActiveWorld();
+	const auto &entityDefLibrary = game.getEntityDefinitionLibrary();
+	auto &random = game.getRandom();
+	double remainingSeconds = dt;
+	while ((remainingSeconds > 0.0) && (this->velocity.lengthSquared() > 0.0))
+	{
+		const NewDouble2 absolutePosition = VoxelUtils::coordToNewPoint(this->position);
+		const NewDouble2 lookAheadPoint = absolutePosition + (this->direction * 0.50);
+		const double edgeSeconds = GetSecondsToVoxelEdge(lookAheadPoint, this->velocity) +
+			(Constants::Epsilon / this->velocity.length());
+		const double stepSeconds = std::min(edgeSeconds, remainingSeconds);
+		this->updatePhysics(worldData, entityDefLibrary, random, stepSeconds);
+		remainingSeconds -= stepSeconds;
+	}
+}
+
+void DynamicEntity::catchUp(Game &game, double dt)
+{
+	Entity::catchUp(game, dt);
+
+	if (this->derivedType == DynamicEntityType::Citizen)
+	{
+		this->catchUpCitizen(game, dt);
+	}
+}
+
+void DynamicEntity::tickDormant(Game &game, double dt)
+{
+	// Positions and animations stay frozen since nobody is around to see them, and are caught up
+	// on waking. Creatures can still be heard though.
+	if (this->derivedType == DynamicEntityType::Creature)
+	{
+		this->updateCreatureSound(game, dt);
+	}
+}
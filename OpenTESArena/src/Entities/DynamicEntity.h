@@ -49,11 +49,17 @@ private:
 	// Update functions for various dynamic entity types.
 	void updateCitizenState(Game &game, double dt);
 	void updateCreatureState(Game &game, double dt);
+	void updateCreatureSound(Game &game, double dt);
 	void updateProjectileState(Game &game, double dt);
 
 	// Updates the entity's physics in the world (if any).
 	void updatePhysics(const WorldData &worldData, const EntityDefinitionLibrary &entityDefLibrary,
 		Random &random, double dt);
+
+	// Walks a citizen for time spent dormant, one voxel at a time instead of one frame at a time.
+	void catchUpCitizen(Game &game, double dt);
+protected:
+	virtual void catchUp(Game &game, double dt) override;
 public:
 	DynamicEntity();
 	virtual ~DynamicEntity() = default;
@@ -87,6 +93,10 @@ public:
 
 	virtual void reset() override;
 	virtual void tick(Game &game, double dt) override;
+
+	// Updates what still matters while the entity is dormant, like creature sounds that can be
+	// heard past the fog.
+	void tickDormant(Game &game, double dt);
 };
 
 #endif
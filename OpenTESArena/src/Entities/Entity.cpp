@@ -1,14 +1,23 @@
+#include <algorithm>
+
 #include "Entity.h"
 #include "EntityManager.h"
 #include "EntityType.h"
 #include "../Game/Game.h"
 
+namespace
+{
+	int NextEntityGeneration = 0;
+}
+
 Entity::Entity()
 	: position(ChunkInt2::Zero, VoxelDouble2::Zero)
 {
 	this->id = EntityManager::NO_ID;
 	this->defID = EntityManager::NO_DEF_ID;
 	this->renderID = EntityManager::NO_RENDER_ID;
+	this->generation = -1;
+	this->dormantStartSeconds = -1.0;
 	this->animInst.reset();
 }
 
@@ -34,6 +43,11 @@ EntityRenderID Entity::getRenderID() const
 	return this->renderID;
 }
 
+int Entity::getGeneration() const
+{
+	return this->generation;
+}
+
 const CoordDouble2 &Entity::getPosition() const
 {
 	return this->position;
@@ -49,9 +63,16 @@ const EntityAnimationInstance &Entity::getAnimInstance() const
 	return this->animInst;
 }
 
+bool Entity::isDormant() const
+{
+	return this->dormantStartSeconds >= 0.0;
+}
+
 void Entity::setID(EntityID id)
 {
 	this->id = id;
+	this->generation = NextEntityGeneration;
+	NextEntityGeneration++;
 }
 
 void Entity::setRenderID(EntityRenderID id)
@@ -73,10 +94,33 @@ void Entity::reset()
 	this->id = EntityManager::NO_ID;
 	this->defID = EntityManager::NO_DEF_ID;
 	this->renderID = EntityManager::NO_RENDER_ID;
+	this->generation = -1;
+	this->dormantStartSeconds = -1.0;
 	this->position = CoordDouble2(ChunkInt2::Zero, VoxelDouble2::Zero);
 	this->animInst.reset();
 }
 
+void Entity::sleep(double currentSeconds)
+{
+	DebugAssert(!this->isDormant());
+	DebugAssert(currentSeconds >= 0.0);
+	this->dormantStartSeconds = currentSeconds;
+}
+
+void Entity::wake(Game &game, double currentSeconds)
+{
+	DebugAssert(this->isDormant());
+	const double dormantSeconds = std::max(currentSeconds - this->dormantStartSeconds, 0.0);
+	this->dormantStartSeconds = -1.0;
+	this->catchUp(game, dormantSeconds);
+}
+
+void Entity::catchUp(Game &game, double dt)
+{
+	// Looping animations wrap around, so one large step lands on the same frame as many small ones.
+	Entity::tick(game, dt);
+}
+
 void Entity::tick(Game &game, double dt)
 {
 	const EntityAnimationDefinition &animDef = [this, &game]() -> const EntityAnimationDefinition&
@@ -22,11 +22,16 @@ private:
 	EntityID id;
 	EntityDefID defID;
 	EntityRenderID renderID;
+	int generation; // Unique per entity lifetime, since IDs are reused after removal.
+	double dormantStartSeconds; // Entity manager time when the entity went dormant, or negative if awake.
 protected:
 	CoordDouble2 position;
 
 	// Initializes the entity state (some values are initialized separately).
 	void init(EntityDefID defID, const EntityAnimationInstance &animInst);
+
+	// Advances the entity's state by time spent dormant in as few steps as possible.
+	virtual void catchUp(Game &game, double dt);
 public:
 	Entity();
 	virtual ~Entity() = default;
@@ -40,6 +45,9 @@ public:
 	// Gets the entity's render ID.
 	EntityRenderID getRenderID() const;
 
+	// Gets the value that tells this entity apart from earlier ones that had the same ID.
+	int getGeneration() const;
+
 	// Gets the chunk + point of the entity.
 	const CoordDouble2 &getPosition() const;
 
@@ -50,7 +58,10 @@ public:
 	// Gets the entity's derived type (NPC, doodad, etc.).
 	virtual EntityType getEntityType() const = 0;
 
-	// Sets the entity's ID.
+	// Whether the entity's state is frozen because it is far away from the player.
+	bool isDormant() const;
+
+	// Sets the entity's ID. This starts a new generation.
 	void setID(EntityID id);
 
 	// Sets the entity's render ID which may be shared with other identical-looking entities.
@@ -60,6 +71,12 @@ public:
 	void setPosition(const CoordDouble2 &position, EntityManager &entityManager,
 		const VoxelGrid &voxelGrid);
 
+	// Freezes the entity's state at the given entity manager time until it is woken.
+	void sleep(double currentSeconds);
+
+	// Unfreezes the entity and catches its state up on the time it spent dormant.
+	void wake(Game &game, double currentSeconds);
+
 	// Clears all entity data so it can be used for another entity of the same type.
 	virtual void reset();
 
@@ -11,6 +11,7 @@
 #include "../Math/MathUtils.h"
 #include "../Math/Matrix4.h"
 #include "../World/ChunkUtils.h"
+#include "../World/PotentiallyVisibleSet.h"
 
 #include "components/debug/Debug.h"
 
@@ -40,6 +41,29 @@ void EntityManager::EntityVisibilityData::init(const Entity *entity, const Coord
 	this->keyframeIndex = keyframeIndex;
 }
 
+EntityManager::VisibilityCache::VisibilityCache() :
+	eye2D(ChunkInt2::Zero, VoxelDouble2::Zero)
+{
+	this->ceilingHeight = 0.0;
+	this->isValid = false;
+}
+
+bool EntityManager::VisibilityCache::matches(const CoordDouble2 &eye2D, double ceilingHeight) const
+{
+	return this->isValid && (this->eye2D.chunk == eye2D.chunk) && (this->eye2D.point == eye2D.point) &&
+		(this->ceilingHeight == ceilingHeight);
+}
+
+void EntityManager::VisibilityCache::clear()
+{
+	// Cheap when already cleared since this is called for every entity modification.
+	if (this->isValid)
+	{
+		this->entries.clear();
+		this->isValid = false;
+	}
+}
+
 template <typename T>
 int EntityManager::EntityGroup<T>::getCount() const
 {
@@ -265,6 +289,9 @@ void EntityManager::init(SNInt chunkCountX, WEInt chunkCountZ)
 	this->staticGroups.init(chunkCountX, chunkCountZ);
 	this->dynamicGroups.init(chunkCountX, chunkCountZ);
 	this->nextID = FIRST_ENTITY_ID;
+	this->tickSeconds = 0.0;
+	this->activeCount = 0;
+	this->dormantCount = 0;
 }
 
 EntityID EntityManager::nextFreeID()
@@ -294,6 +321,8 @@ bool EntityManager::isValidChunk(const ChunkInt2 &chunk) const
 
 EntityRef EntityManager::makeEntity(EntityType type)
 {
+	this->visibilityCache.clear();
+
 	const EntityID id = this->nextFreeID();
 	EntityRef entityRef = [this, type, id]()
 	{
@@ -346,6 +375,9 @@ const Entity *EntityManager::getInternal(EntityID id, const EntityGroup<T> &grou
 
 Entity *EntityManager::getEntityHandle(EntityID id, EntityType type)
 {
+	// The caller might modify the entity.
+	this->visibilityCache.clear();
+
 	// Use the given entity type to determine which entity group to look in.
 	auto tryGetEntityHandle = [this, id](auto &entityGroups) -> Entity*
 	{
@@ -508,6 +540,16 @@ int EntityManager::getCount(EntityType entityType) const
 	}
 }
 
+int EntityManager::getActiveCount() const
+{
+	return this->activeCount;
+}
+
+int EntityManager::getDormantCount() const
+{
+	return this->dormantCount;
+}
+
 int EntityManager::getTotalCountInChunk(const ChunkInt2 &chunk) const
 {
 	DebugAssert(this->staticGroups.getWidth() == this->dynamicGroups.getWidth());
@@ -530,6 +572,9 @@ int EntityManager::getTotalCount() const
 
 int EntityManager::getEntities(EntityType entityType, Entity **outEntities, int outSize)
 {
+	// The caller might modify the entities.
+	this->visibilityCache.clear();
+
 	DebugAssert(outEntities != nullptr);
 	DebugAssert(outSize >= 0);
 
@@ -701,6 +746,69 @@ EntityDefID EntityManager::addEntityDef(EntityDefinition &&def,
 void EntityManager::getEntityVisibilityData(const Entity &entity, const CoordDouble2 &eye2D,
 	double ceilingHeight, const VoxelGrid &voxelGrid, const EntityDefinitionLibrary &entityDefLibrary,
 	EntityVisibilityData &outVisData) const
+{
+	if (this->visibilityCache.matches(eye2D, ceilingHeight))
+	{
+		const auto iter = this->visibilityCache.entries.find(entity.getID());
+		if (iter != this->visibilityCache.entries.end())
+		{
+			outVisData = iter->second;
+			return;
+		}
+	}
+
+	this->calculateEntityVisibilityData(entity, eye2D, ceilingHeight, voxelGrid, entityDefLibrary, outVisData);
+}
+
+void EntityManager::updateVisibilityCache(const CoordDouble2 &eye2D, int chunkDistance, double ceilingHeight,
+	const VoxelGrid &voxelGrid, const EntityDefinitionLibrary &entityDefLibrary)
+{
+	this->visibilityCache.clear();
+
+	ChunkInt2 minChunk, maxChunk;
+	ChunkUtils::getSurroundingChunks(eye2D.chunk, chunkDistance, &minChunk, &maxChunk);
+
+	// Gather up entities in nearby chunks.
+	std::vector<const Entity*> entities;
+	for (WEInt z = minChunk.y; z <= maxChunk.y; z++)
+	{
+		for (SNInt x = minChunk.x; x <= maxChunk.x; x++)
+		{
+			const ChunkInt2 chunk(x, z);
+			if (!this->isValidChunk(chunk))
+			{
+				continue;
+			}
+
+			const int chunkEntityCount = this->getTotalCountInChunk(chunk);
+			const int insertIndex = static_cast<int>(entities.size());
+			entities.resize(insertIndex + chunkEntityCount);
+			const int writtenCount = this->getTotalEntitiesInChunk(chunk, entities.data() + insertIndex,
+				chunkEntityCount);
+			entities.resize(insertIndex + writtenCount);
+		}
+	}
+
+	// Entities can be null because of EntityGroup implementation details.
+	entities.erase(std::remove(entities.begin(), entities.end(), nullptr), entities.end());
+
+	const int entityCount = static_cast<int>(entities.size());
+	this->visibilityCache.entries.reserve(entityCount);
+	for (const Entity *entity : entities)
+	{
+		EntityVisibilityData visData;
+		this->calculateEntityVisibilityData(*entity, eye2D, ceilingHeight, voxelGrid, entityDefLibrary, visData);
+		this->visibilityCache.entries.emplace(entity->getID(), visData);
+	}
+
+	this->visibilityCache.eye2D = eye2D;
+	this->visibilityCache.ceilingHeight = ceilingHeight;
+	this->visibilityCache.isValid = true;
+}
+
+void EntityManager::calculateEntityVisibilityData(const Entity &entity, const CoordDouble2 &eye2D,
+	double ceilingHeight, const VoxelGrid &voxelGrid, const EntityDefinitionLibrary &entityDefLibrary,
+	EntityVisibilityData &outVisData) const
 {
 	outVisData.entity = &entity;
 	const EntityDefinition &entityDef = this->getEntityDef(entity.getDefinitionID(), entityDefLibrary);
@@ -847,6 +955,8 @@ void EntityManager::getEntityBoundingBox(const Entity &entity, const EntityVisib
 
 void EntityManager::updateEntityChunk(Entity *entity, const VoxelGrid &voxelGrid)
 {
+	this->visibilityCache.clear();
+
 	if (entity == nullptr)
 	{
 		DebugLogWarning("Can't update null entity's chunk.");
@@ -921,6 +1031,8 @@ void EntityManager::updateEntityChunk(Entity *entity, const VoxelGrid &voxelGrid
 
 void EntityManager::remove(EntityID id)
 {
+	this->visibilityCache.clear();
+
 	DebugAssert(this->staticGroups.getWidth() == this->dynamicGroups.getWidth());
 	DebugAssert(this->staticGroups.getHeight() == this->dynamicGroups.getHeight());
 
@@ -962,6 +1074,8 @@ void EntityManager::remove(EntityID id)
 
 void EntityManager::clear()
 {
+	this->visibilityCache.clear();
+
 	for (WEInt z = 0; z < this->staticGroups.getHeight(); z++)
 	{
 		for (SNInt x = 0; x < this->staticGroups.getWidth(); x++)
@@ -980,21 +1094,26 @@ void EntityManager::clear()
 
 void EntityManager::clearChunk(const ChunkInt2 &coord)
 {
+	this->visibilityCache.clear();
+
 	auto &staticGroup = this->staticGroups.get(coord.x, coord.y);
 	auto &dynamicGroup = this->dynamicGroups.get(coord.x, coord.y);
 	staticGroup.clear();
 	dynamicGroup.clear();
 }
 
-void EntityManager::tick(Game &game, double dt)
+void EntityManager::tick(Game &game, double dt, const PotentiallyVisibleSet &potentiallyVisibleSet)
 {
+	this->visibilityCache.clear();
+	this->activeCount = 0;
+	this->dormantCount = 0;
+
 	// Only want to tick entities near the player, so get the chunks near the player.
-	const ChunkInt2 playerChunk = [&game]()
-	{
-		auto &gameData = game.getGameData();
-		const CoordDouble3 &playerCoord = gameData.getPlayer().getPosition();
-		return playerCoord.chunk;
-	}();
+	const CoordDouble3 &playerCoord = game.getGameData().getPlayer().getPosition();
+	const ChunkInt2 &playerChunk = playerCoord.chunk;
+	const CoordDouble2 playerCoordXZ(playerChunk, VoxelDouble2(playerCoord.point.x, playerCoord.point.z));
+	const NewInt3 playerVoxel = VoxelUtils::pointToVoxel(VoxelUtils::coordToNewPoint(playerCoord));
+	const NewInt2 playerVoxelXZ(playerVoxel.x, playerVoxel.z);
 
 	const int chunkDistance = [&game]()
 	{
@@ -1005,7 +1124,14 @@ void EntityManager::tick(Game &game, double dt)
 	ChunkInt2 minChunk, maxChunk;
 	ChunkUtils::getSurroundingChunks(playerChunk, chunkDistance, &minChunk, &maxChunk);
 
-	auto tickNearbyEntityGroups = [&game, dt, &minChunk, &maxChunk](auto &entityGroups)
+	// Entities past the fog can't be seen, so they only need ticking once the player gets near.
+	const double wakeDistance = game.getGameData().getFogDistance() + EntityManager::WAKE_DISTANCE_PADDING;
+	const double sleepDistance = wakeDistance + EntityManager::SLEEP_DISTANCE_MARGIN;
+	const double wakeDistanceSqr = wakeDistance * wakeDistance;
+	const double sleepDistanceSqr = sleepDistance * sleepDistance;
+
+	auto tickNearbyEntityGroups = [this, &game, dt, &potentiallyVisibleSet, &playerCoordXZ, &playerVoxelXZ,
+		&minChunk, &maxChunk, wakeDistanceSqr, sleepDistanceSqr](auto &entityGroups)
 	{
 		for (WEInt z = minChunk.y; z <= maxChunk.y; z++)
 		{
@@ -1022,10 +1148,55 @@ void EntityManager::tick(Game &game, double dt)
 					for (int i = 0; i < entityCount; i++)
 					{
 						auto *entity = entityGroup.getEntityAtIndex(i);
-						if (entity != nullptr)
+						if (entity == nullptr)
+						{
+							continue;
+						}
+
+						const bool isDormant = entity->isDormant();
+						const double distSqr = (entity->getPosition() - playerCoordXZ).lengthSquared();
+						bool shouldBeAwake = isDormant ? (distSqr < wakeDistanceSqr) : (distSqr <= sleepDistanceSqr);
+
+						using EntityClass = std::remove_pointer_t<decltype(entity)>;
+						if constexpr (std::is_same_v<EntityClass, StaticEntity>)
+						{
+							// Static entities only animate, so they can also sleep when out of sight.
+							if (shouldBeAwake)
+							{
+								const NewInt2 entityVoxel = VoxelUtils::pointToVoxel(
+									VoxelUtils::coordToNewPoint(entity->getPosition()));
+								shouldBeAwake = potentiallyVisibleSet.isVisible(playerVoxelXZ, entityVoxel);
+							}
+						}
+						else
 						{
-							entity->tick(game, dt);
+							// Projectiles always need to finish their flight.
+							shouldBeAwake |= entity->getDerivedType() == DynamicEntityType::Projectile;
 						}
+
+						if (!shouldBeAwake)
+						{
+							if (!isDormant)
+							{
+								entity->sleep(this->tickSeconds);
+							}
+
+							if constexpr (std::is_same_v<EntityClass, DynamicEntity>)
+							{
+								entity->tickDormant(game, dt);
+							}
+
+							this->dormantCount++;
+							continue;
+						}
+
+						if (isDormant)
+						{
+							entity->wake(game, this->tickSeconds);
+						}
+
+						entity->tick(game, dt);
+						this->activeCount++;
 					}
 				}
 			}
@@ -1034,4 +1205,7 @@ void EntityManager::tick(Game &game, double dt)
 
 	tickNearbyEntityGroups(this->staticGroups);
 	tickNearbyEntityGroups(this->dynamicGroups);
+
+	// Advanced after ticking so a dormant entity's missed time is exactly the frames it skipped.
+	this->tickSeconds += dt;
 }
@@ -20,6 +20,7 @@
 
 class EntityDefinitionLibrary;
 class Game;
+class PotentiallyVisibleSet;
 
 enum class EntityType;
 
@@ -102,12 +103,43 @@ private:
 	std::vector<EntityID> freeIDs;
 	EntityID nextID;
 
+	// Visibility data of nearby entities for one eye position, calculated once per frame and
+	// shared by the renderer, ray casts, and anything else querying visibility that frame.
+	// Anything that might change an entity clears it.
+	struct VisibilityCache
+	{
+		std::unordered_map<EntityID, EntityVisibilityData> entries;
+		CoordDouble2 eye2D;
+		double ceilingHeight;
+		bool isValid;
+
+		VisibilityCache();
+
+		// Returns whether the entries were calculated for the given view.
+		bool matches(const CoordDouble2 &eye2D, double ceilingHeight) const;
+
+		void clear();
+	};
+
+	VisibilityCache visibilityCache;
+
+	// Seconds the manager has been ticked for, used to time how long entities are dormant.
+	double tickSeconds;
+
+	// Nearby entities that were ticked or left dormant by the last tick.
+	int activeCount, dormantCount;
+
 	// Obtains an available ID to be assigned to a new entity, incrementing the current max
 	// if no previously owned IDs are available to reuse.
 	EntityID nextFreeID();
 
 	bool isValidChunk(const ChunkInt2 &chunk) const;
 
+	// Calculates an entity's visibility data without looking in the visibility cache.
+	void calculateEntityVisibilityData(const Entity &entity, const CoordDouble2 &eye2D,
+		double ceilingHeight, const VoxelGrid &voxelGrid, const EntityDefinitionLibrary &entityDefLibrary,
+		EntityVisibilityData &outVisData) const;
+
 	// Helper functions for looking up an entity in the given group by ID.
 	template <typename T>
 	Entity *getInternal(EntityID id, EntityGroup<T> &group);
@@ -119,6 +151,12 @@ public:
 	static constexpr EntityDefID NO_DEF_ID = -1;
 	static constexpr EntityRenderID NO_RENDER_ID = -1;
 
+	// Distance past the fog that entities wake up at (so flats fading in at the fog edge are
+	// animated), and the extra distance before they go dormant again so they don't flip between
+	// states at the boundary.
+	static constexpr double WAKE_DISTANCE_PADDING = 1.0;
+	static constexpr double SLEEP_DISTANCE_MARGIN = 2.0;
+
 	// Requires the chunks per X and Z side in the voxel grid for allocating entity groups.
 	void init(SNInt chunkCountX, WEInt chunkCountZ);
 
@@ -148,6 +186,10 @@ public:
 	// Gets total number of entities in the manager.
 	int getTotalCount() const;
 
+	// Gets number of nearby entities that were ticked or left dormant last frame.
+	int getActiveCount() const;
+	int getDormantCount() const;
+
 	// Gets pointers to entities of the given type. Returns number of entities written.
 	int getEntities(EntityType entityType, Entity **outEntities, int outSize);
 	int getEntities(EntityType entityType, const Entity **outEntities, int outSize) const;
@@ -169,11 +211,17 @@ public:
 	// Adds an entity definition and returns its ID.
 	EntityDefID addEntityDef(EntityDefinition &&def, const EntityDefinitionLibrary &entityDefLibrary);
 
-	// Gets the data necessary for rendering and ray cast selection.
+	// Gets the data necessary for rendering and ray cast selection. Uses the visibility cache if
+	// it was updated for the same view.
 	void getEntityVisibilityData(const Entity &entity, const CoordDouble2 &eye2D,
 		double ceilingHeight, const VoxelGrid &voxelGrid, const EntityDefinitionLibrary &entityDefLibrary,
 		EntityVisibilityData &outVisData) const;
 
+	// Calculates visibility data for every entity within the chunk distance of the eye so later
+	// queries this frame can reuse it.
+	void updateVisibilityCache(const CoordDouble2 &eye2D, int chunkDistance, double ceilingHeight,
+		const VoxelGrid &voxelGrid, const EntityDefinitionLibrary &entityDefLibrary);
+
 	// Convenience function for getting the active keyframe from an entity, given some
 	// visibility data.
 	const EntityAnimationDefinition::Keyframe &getEntityAnimKeyframe(const Entity &entity,
@@ -195,8 +243,10 @@ public:
 	// Deletes all entities in the given chunk.
 	void clearChunk(const ChunkInt2 &coord);
 
-	// Ticks the entity manager by delta time.
-	void tick(Game &game, double dt);
+	// Ticks the entity manager by delta time. Entities beyond the fog (and static entities out of
+	// the player's sight) go dormant with their state frozen, and are caught up when woken. Dormant
+	// creatures keep making sounds.
+	void tick(Game &game, double dt, const PotentiallyVisibleSet &potentiallyVisibleSet);
 };
 
 #endif
@@ -184,6 +184,14 @@ void Player::rotate(double dx, double dy, double hSensitivity, double vSensitivi
 		dy * (100.0 * vSensitivity), pitchLimit);
 }
 
+Double3 Player::getRotatedDirection(double dx, double dy, double hSensitivity,
+	double vSensitivity, double pitchLimit) const
+{
+	Camera3D rotatedCamera = this->camera;
+	rotatedCamera.rotate(dx * (100.0 * hSensitivity), dy * (100.0 * vSensitivity), pitchLimit);
+	return rotatedCamera.getDirection();
+}
+
 void Player::lookAt(const CoordDouble3 &point)
 {
 	this->camera.lookAt(point);
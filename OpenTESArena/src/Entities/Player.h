@@ -91,6 +91,11 @@ public:
 	// Rotates the player's camera based on some change in X (left/right) and Y (up/down).
 	void rotate(double dx, double dy, double hSensitivity, double vSensitivity, double pitchLimit);
 
+	// Gets the direction the player would face after rotating by the given amount, without
+	// changing the player's camera.
+	Double3 getRotatedDirection(double dx, double dy, double hSensitivity, double vSensitivity,
+		double pitchLimit) const;
+
 	// Recalculates the player's view so they look at a point.
 	void lookAt(const CoordDouble3 &point);
 
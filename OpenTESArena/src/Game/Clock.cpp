@@ -1,3 +1,5 @@
+#include <cmath>
+
 #include "Clock.h"
 
 #include "components/debug/Debug.h"
@@ -99,11 +101,17 @@ void Clock::incrementSecond()
 
 void Clock::tick(double dt)
 {
-	this->currentSecond += dt;
-
-	while (this->currentSecond >= 1.0)
-	{
-		this->incrementSecond();
-		this->currentSecond -= 1.0;
-	}
+	DebugAssert(dt >= 0.0);
+
+	const double totalSecondFraction = this->currentSecond + dt;
+	const double wholeSeconds = std::floor(totalSecondFraction);
+	this->currentSecond = totalSecondFraction - wholeSeconds;
+
+	// Wrap around to the same time of day, ignoring how many days passed.
+	const double totalSeconds = std::fmod(static_cast<double>(this->getTotalSeconds()) + wholeSeconds,
+		static_cast<double>(Clock::SECONDS_IN_A_DAY));
+	const int daySeconds = static_cast<int>(totalSeconds);
+	this->hours = daySeconds / 3600;
+	this->minutes = (daySeconds / 60) % 60;
+	this->seconds = daySeconds % 60;
 }
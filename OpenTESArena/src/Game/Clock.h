@@ -63,7 +63,7 @@ public:
 	// Increments the second by 1.
 	void incrementSecond();
 
-	// Ticks the clock by delta time.
+	// Ticks the clock by delta time. Any amount of time is added in constant time.
 	void tick(double dt);
 };
 
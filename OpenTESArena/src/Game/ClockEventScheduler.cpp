@@ -0,0 +1,125 @@
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+#include "Clock.h"
+#include "ClockEventScheduler.h"
+
+#include "components/debug/Debug.h"
+
+namespace
+{
+	constexpr double SECONDS_PER_SLOT = static_cast<double>(Clock::SECONDS_IN_A_DAY) / 24.0;
+}
+
+ClockEventScheduler::Event::Event(EventID id, double seconds, const Callback &callback)
+	: callback(callback)
+{
+	this->id = id;
+	this->seconds = seconds;
+}
+
+ClockEventScheduler::DueEvent::DueEvent(double lastSeconds, EventID id, const Callback &callback)
+	: callback(callback)
+{
+	this->lastSeconds = lastSeconds;
+	this->id = id;
+}
+
+ClockEventScheduler::ClockEventScheduler()
+{
+	this->nextID = 0;
+}
+
+ClockEventScheduler::EventID ClockEventScheduler::addDailyEvent(double seconds, const Callback &callback)
+{
+	DebugAssert(seconds >= 0.0);
+	DebugAssert(seconds < static_cast<double>(Clock::SECONDS_IN_A_DAY));
+
+	const EventID id = this->nextID;
+	this->nextID++;
+
+	const int slotIndex = std::clamp(static_cast<int>(seconds / SECONDS_PER_SLOT), 0, SLOT_COUNT - 1);
+	std::vector<Event> &slot = this->slots[slotIndex];
+	const auto insertIter = std::upper_bound(slot.begin(), slot.end(), seconds,
+		[](double value, const Event &event)
+	{
+		return value < event.seconds;
+	});
+
+	slot.insert(insertIter, Event(id, seconds, callback));
+	return id;
+}
+
+void ClockEventScheduler::removeEvent(EventID id)
+{
+	for (std::vector<Event> &slot : this->slots)
+	{
+		const auto iter = std::find_if(slot.begin(), slot.end(),
+			[id](const Event &event) { return event.id == id; });
+
+		if (iter != slot.end())
+		{
+			slot.erase(iter);
+			return;
+		}
+	}
+
+	DebugLogWarning("No clock event with ID \"" + std::to_string(id) + "\".");
+}
+
+void ClockEventScheduler::clear()
+{
+	for (std::vector<Event> &slot : this->slots)
+	{
+		slot.clear();
+	}
+}
+
+void ClockEventScheduler::advance(double startSeconds, double elapsedSeconds)
+{
+	DebugAssert(elapsedSeconds >= 0.0);
+	if (elapsedSeconds <= 0.0)
+	{
+		return;
+	}
+
+	constexpr double secondsPerDay = static_cast<double>(Clock::SECONDS_IN_A_DAY);
+	const double endSeconds = startSeconds + elapsedSeconds;
+
+	// Only the slots passed through need checking unless the advance covers a whole day.
+	const int firstSlot = static_cast<int>(std::floor(startSeconds / SECONDS_PER_SLOT));
+	const int lastSlot = static_cast<int>(std::floor(endSeconds / SECONDS_PER_SLOT));
+	const int slotCount = std::min((lastSlot - firstSlot) + 1, SLOT_COUNT);
+
+	this->dueEvents.clear();
+	for (int i = 0; i < slotCount; i++)
+	{
+		const int slotIndex = ((firstSlot + i) % SLOT_COUNT + SLOT_COUNT) % SLOT_COUNT;
+		for (const Event &event : this->slots[slotIndex])
+		{
+			// The event is due if its time lies in (start, end] on any day.
+			const double lastDay = std::floor((endSeconds - event.seconds) / secondsPerDay);
+			const double firstDay = std::floor((startSeconds - event.seconds) / secondsPerDay);
+			if (lastDay > firstDay)
+			{
+				const double lastSeconds = event.seconds + (lastDay * secondsPerDay);
+				this->dueEvents.emplace_back(lastSeconds, event.id, event.callback);
+			}
+		}
+	}
+
+	// Run in the order the events were last reached so the latest one decides any shared
+	// state (i.e., lampposts turning off after turning on during a long rest). Ties keep
+	// the order the events were added.
+	std::sort(this->dueEvents.begin(), this->dueEvents.end(),
+		[](const DueEvent &a, const DueEvent &b)
+	{
+		return (a.lastSeconds < b.lastSeconds) || ((a.lastSeconds == b.lastSeconds) && (a.id < b.id));
+	});
+
+	for (const DueEvent &dueEvent : this->dueEvents)
+	{
+		dueEvent.callback();
+	}
+}
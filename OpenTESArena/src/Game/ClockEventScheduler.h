@@ -0,0 +1,59 @@
+#ifndef CLOCK_EVENT_SCHEDULER_H
+#define CLOCK_EVENT_SCHEDULER_H
+
+#include <array>
+#include <functional>
+#include <vector>
+
+// Runs callbacks when the game clock reaches certain times of day. Events are kept in a timer
+// wheel with one slot per hour so a normal frame only looks at the slots it passed through.
+// Advancing by any amount of game time runs each event at most once, so resting or travelling
+// for days costs the same as one frame.
+
+class ClockEventScheduler
+{
+public:
+	using EventID = int;
+
+	// Called once per advance that reaches the event's time of day at least once.
+	using Callback = std::function<void()>;
+private:
+	static constexpr int SLOT_COUNT = 24;
+
+	struct Event
+	{
+		EventID id;
+		double seconds; // Time of day.
+		Callback callback;
+
+		Event(EventID id, double seconds, const Callback &callback);
+	};
+
+	struct DueEvent
+	{
+		double lastSeconds; // Latest time reached, relative to the advance's start day.
+		EventID id;
+		Callback callback;
+
+		DueEvent(double lastSeconds, EventID id, const Callback &callback);
+	};
+
+	std::array<std::vector<Event>, SLOT_COUNT> slots;
+	std::vector<DueEvent> dueEvents; // Scratch list, reused between advances.
+	EventID nextID;
+public:
+	ClockEventScheduler();
+
+	// Adds an event that recurs each day at the given time of day in seconds.
+	EventID addDailyEvent(double seconds, const Callback &callback);
+
+	void removeEvent(EventID id);
+
+	void clear();
+
+	// Runs events whose time of day is reached after the start time (exclusive) through the
+	// elapsed time (inclusive). Events are run in order of when they were last reached.
+	void advance(double startSeconds, double elapsedSeconds);
+};
+
+#endif
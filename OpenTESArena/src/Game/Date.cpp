@@ -102,3 +102,14 @@ void Date::incrementDay()
 		this->day = 0;
 	}
 }
+
+void Date::incrementDays(int count)
+{
+	DebugAssert(count >= 0);
+
+	const int totalDays = this->day + count;
+	const int totalMonths = this->month + (totalDays / Date::DAYS_PER_MONTH);
+	this->day = totalDays % Date::DAYS_PER_MONTH;
+	this->month = totalMonths % Date::MONTHS_PER_YEAR;
+	this->year += totalMonths / Date::MONTHS_PER_YEAR;
+}
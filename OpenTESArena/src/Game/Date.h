@@ -37,6 +37,9 @@ public:
 	void incrementYear();
 	void incrementMonth();
 	void incrementDay();
+
+	// Adds any number of days at once.
+	void incrementDays(int count);
 };
 
 #endif
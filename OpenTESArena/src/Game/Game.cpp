@@ -1,3 +1,4 @@
+#include <array>
 #include <chrono>
 #include <cmath>
 #include <cstdint>
@@ -19,6 +20,7 @@
 #include "../Utilities/Platform.h"
 
 #include "components/debug/Debug.h"
+#include "components/utilities/BufferAllocator.h"
 #include "components/utilities/File.h"
 #include "components/utilities/String.h"
 #include "components/utilities/TextLinesFile.h"
@@ -67,6 +69,9 @@ Game::Game()
 		DebugLogError("Couldn't init music library at \"" + musicLibraryPath + "\".");
 	}
 
+	// Large pages must be decided before any large buffers are allocated.
+	BufferAllocator::setLargePagesEnabled(this->options.getGraphics_LargePageBuffers());
+
 	// Initialize the renderer and window with the given settings.
 	constexpr RendererSystemType2D rendererSystemType2D = RendererSystemType2D::SDL2;
 	constexpr RendererSystemType3D rendererSystemType3D = RendererSystemType3D::SoftwareClassic;
@@ -312,6 +317,11 @@ const FPSCounter &Game::getFPSCounter() const
 	return this->fpsCounter;
 }
 
+FrameTimings &Game::getFrameTimings()
+{
+	return this->frameTimings;
+}
+
 void Game::setPanel(std::unique_ptr<Panel> nextPanel)
 {
 	this->nextPanel = std::move(nextPanel);
@@ -496,15 +506,55 @@ void Game::handleEvents(bool &running)
 
 void Game::tick(double dt)
 {
+	// Entity, chunk and voxel updates record their own times, so leave them out of the simulation time.
+	auto getNestedTickTime = [this]()
+	{
+		return this->frameTimings.getCurrentStageTime(FrameTimings::Stage::EntityTick) +
+			this->frameTimings.getCurrentStageTime(FrameTimings::Stage::ChunkUpdate) +
+			this->frameTimings.getCurrentStageTime(FrameTimings::Stage::VoxelUpdate);
+	};
+
+	const double startNestedTime = getNestedTickTime();
+	const FrameTimings::TimePoint startTime = FrameTimings::now();
+
 	// Tick the active panel.
 	this->getActivePanel()->tick(dt);
 
 	// See if the panel tick requested any changes in active panels.
 	this->handlePanelChanges();
+
+	const std::chrono::duration<double> tickTime = FrameTimings::now() - startTime;
+	const double nestedTime = getNestedTickTime() - startNestedTime;
+	this->frameTimings.addStageTime(FrameTimings::Stage::Simulation, tickTime.count() - nestedTime);
 }
 
 void Game::render()
 {
+	// Game world visibility and 3D rendering record their own times, so leave them out of the
+	// interface time.
+	auto getNestedRenderTime = [this]()
+	{
+		constexpr std::array<FrameTimings::Stage, 5> nestedStages =
+		{
+			FrameTimings::Stage::Visibility,
+			FrameTimings::Stage::RenderSky,
+			FrameTimings::Stage::RenderVoxels,
+			FrameTimings::Stage::RenderPlanes,
+			FrameTimings::Stage::RenderFlats
+		};
+
+		double nestedTime = 0.0;
+		for (const FrameTimings::Stage stage : nestedStages)
+		{
+			nestedTime += this->frameTimings.getCurrentStageTime(stage);
+		}
+
+		return nestedTime;
+	};
+
+	const double startNestedTime = getNestedRenderTime();
+	const FrameTimings::TimePoint startTime = FrameTimings::now();
+
 	// Draw the panel's main content.
 	this->panel->render(this->renderer);
 
@@ -531,7 +581,14 @@ void Game::render()
 			this->inputManager.getMousePosition(), this->options.getGraphics_CursorScale(), this->textureManager);
 	}
 
+	const std::chrono::duration<double> renderTime = FrameTimings::now() - startTime;
+	const double nestedTime = getNestedRenderTime() - startNestedTime;
+	this->frameTimings.addStageTime(FrameTimings::Stage::Interface, renderTime.count() - nestedTime);
+
+	const FrameTimings::TimePoint presentStartTime = FrameTimings::now();
 	this->renderer.present();
+	this->frameTimings.addStageTime(FrameTimings::Stage::Present, presentStartTime);
+	this->inputManager.onFramePresented();
 }
 
 void Game::loop()
@@ -592,11 +649,20 @@ void Game::loop()
 		const double dt = static_cast<double>(frameTime.count()) / timeUnitsReal;
 		const double clampedDt = std::fmin(frameTime.count(), maxFrameTime.count()) / timeUnitsReal;
 
+		// Finish the previous frame's stage timings.
+		this->frameTimings.nextFrame(dt);
+
 		// Reset scratch allocator for use with this frame.
 		this->scratchAllocator.clear();
 
+		// Compress any texture builders that have gone unused. No texture references are held
+		// between frames.
+		this->textureManager.compressColdTextureBuilders();
+
 		// Update the input manager's state.
+		const FrameTimings::TimePoint inputStartTime = FrameTimings::now();
 		this->inputManager.update();
+		this->frameTimings.addStageTime(FrameTimings::Stage::Input, inputStartTime);
 
 		// Update the audio manager listener (if any) and check for finished sounds.
 		if (this->gameDataIsActive())
@@ -622,7 +688,9 @@ void Game::loop()
 		// Listen for input events.
 		try
 		{
+			const FrameTimings::TimePoint eventsStartTime = FrameTimings::now();
 			this->handleEvents(running);
+			this->frameTimings.addStageTime(FrameTimings::Stage::Input, eventsStartTime);
 		}
 		catch (const std::exception &e)
 		{
@@ -15,6 +15,7 @@
 #include "../Entities/EntityDefinitionLibrary.h"
 #include "../Input/InputManager.h"
 #include "../Interface/FPSCounter.h"
+#include "../Interface/FrameTimings.h"
 #include "../Interface/Panel.h"
 #include "../Media/AudioManager.h"
 #include "../Media/CinematicLibrary.h"
@@ -66,6 +67,7 @@ private:
 	ScratchAllocator scratchAllocator;
 	Profiler profiler;
 	FPSCounter fpsCounter;
+	FrameTimings frameTimings;
 	std::string basePath, optionsPath;
 	bool requestedSubPanelPop;
 
@@ -164,6 +166,9 @@ public:
 	// Gets the frames-per-second counter. This is updated in the game loop.
 	const FPSCounter &getFPSCounter() const;
 
+	// Gets the per-stage frame timings for the profiler. Stages add their times as they run.
+	FrameTimings &getFrameTimings();
+
 	// Sets the panel after the current SDL event has been processed (to avoid 
 	// interfering with the current panel). This uses template parameters for
 	// convenience (to avoid writing a unique_ptr at each callsite).
@@ -581,6 +581,11 @@ Clock &GameData::getClock()
 	return this->clock;
 }
 
+ClockEventScheduler &GameData::getClockEvents()
+{
+	return this->clockEvents;
+}
+
 ArenaRandom &GameData::getRandom()
 {
 	return this->arenaRandom;
@@ -835,30 +840,41 @@ void GameData::updateWeather(const ExeData &exeData)
 	}
 }
 
-void GameData::tick(double dt, Game &game)
+void GameData::advanceClock(double gameSeconds, const ExeData &exeData)
 {
-	DebugAssert(dt >= 0.0);
+	DebugAssert(gameSeconds >= 0.0);
 
-	// Tick the game clock.
-	const int oldHour = this->clock.getHours24();
-	this->clock.tick(dt * GameData::TIME_SCALE);
-	const int newHour = this->clock.getHours24();
+	constexpr double secondsPerHour = 3600.0;
+	const double oldSeconds = this->clock.getPreciseTotalSeconds();
+	const double newSeconds = oldSeconds + gameSeconds;
+	this->clock.tick(gameSeconds);
 
-	// Check if the hour changed.
-	if (newHour != oldHour)
+	// Increment the day for each time the clock looped back around.
+	const int elapsedDays = static_cast<int>(newSeconds / static_cast<double>(Clock::SECONDS_IN_A_DAY));
+	if (elapsedDays > 0)
 	{
-		// Update the weather.
-		const auto &exeData = game.getBinaryAssetLibrary().getExeData();
-		this->updateWeather(exeData);
+		this->date.incrementDays(elapsedDays);
 	}
 
-	// Check if the clock hour looped back around.
-	if (newHour < oldHour)
+	// Weather is only recalculated once no matter how many hours passed since only the last
+	// one is observable.
+	const bool hourChanged = std::floor(newSeconds / secondsPerHour) > std::floor(oldSeconds / secondsPerHour);
+	if (hourChanged)
 	{
-		// Increment the day.
-		this->date.incrementDay();
+		this->updateWeather(exeData);
 	}
 
+	this->clockEvents.advance(oldSeconds, gameSeconds);
+}
+
+void GameData::tick(double dt, Game &game)
+{
+	DebugAssert(dt >= 0.0);
+
+	// Tick the game clock.
+	const auto &exeData = game.getBinaryAssetLibrary().getExeData();
+	this->advanceClock(dt * GameData::TIME_SCALE, exeData);
+
 	// Tick chasm animation.
 	this->chasmAnimSeconds += dt;
 	if (this->chasmAnimSeconds >= ArenaVoxelUtils::CHASM_ANIM_SECONDS)
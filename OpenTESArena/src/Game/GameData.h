@@ -8,6 +8,7 @@
 #include <vector>
 
 #include "Clock.h"
+#include "ClockEventScheduler.h"
 #include "Date.h"
 #include "../Assets/ArenaTypes.h"
 #include "../Assets/BinaryAssetLibrary.h"
@@ -83,6 +84,7 @@ private:
 
 	Date date;
 	Clock clock;
+	ClockEventScheduler clockEvents; // Time-of-day events outside the game data (lampposts, music, etc.).
 	ArenaRandom arenaRandom;
 	double fogDistance;
 	double chasmAnimSeconds;
@@ -169,6 +171,7 @@ public:
 	LocationInstance &getLocationInstance();
 	Date &getDate();
 	Clock &getClock();
+	ClockEventScheduler &getClockEvents();
 	ArenaRandom &getRandom();
 
 	// Gets a percentage representing how far along the current day is. 0.0 is 
@@ -215,6 +218,10 @@ public:
 	// Recalculates the weather for each global quarter (done hourly).
 	void updateWeather(const ExeData &exeData);
 
+	// Moves the clock forward by some game seconds, updating the date and weather and running
+	// any clock events that were passed. Costs the same regardless of how much time passes.
+	void advanceClock(double gameSeconds, const ExeData &exeData);
+
 	// Ticks the game clock (for the current time of day and date).
 	void tick(double dt, Game &game);
 };
@@ -27,7 +27,8 @@ namespace
 		{ "LetterboxMode", OptionType::Int },
 		{ "CursorScale", OptionType::Double },
 		{ "ModernInterface", OptionType::Bool },
-		{ "RenderThreadsMode", OptionType::Int }
+		{ "RenderThreadsMode", OptionType::Int },
+		{ "LargePageBuffers", OptionType::Bool }
 	};
 
 	const std::vector<std::pair<std::string, OptionType>> AudioMappings =
@@ -45,7 +46,8 @@ namespace
 		{ "HorizontalSensitivity", OptionType::Double },
 		{ "VerticalSensitivity", OptionType::Double },
 		{ "CameraPitchLimit", OptionType::Double },
-		{ "PixelPerfectSelection", OptionType::Bool }
+		{ "PixelPerfectSelection", OptionType::Bool },
+		{ "PickFromFrame", OptionType::Bool }
 	};
 
 	const std::vector<std::pair<std::string, OptionType>> MiscMappings =
@@ -86,7 +86,7 @@ public:
 	static constexpr int MIN_STAR_DENSITY_MODE = 0;
 	static constexpr int MAX_STAR_DENSITY_MODE = 2;
 	static constexpr int MIN_PROFILER_LEVEL = 0;
-	static constexpr int MAX_PROFILER_LEVEL = 3;
+	static constexpr int MAX_PROFILER_LEVEL = 4;
 
 #define OPTION_BOOL(section, name) \
 bool get##section##_##name() const \
@@ -147,6 +147,7 @@ void set##section##_##name(const std::string &value) \
 	OPTION_DOUBLE(Graphics, CursorScale)
 	OPTION_BOOL(Graphics, ModernInterface)
 	OPTION_INT(Graphics, RenderThreadsMode)
+	OPTION_BOOL(Graphics, LargePageBuffers)
 
 	OPTION_DOUBLE(Audio, MusicVolume)
 	OPTION_DOUBLE(Audio, SoundVolume)
@@ -159,6 +160,7 @@ void set##section##_##name(const std::string &value) \
 	OPTION_DOUBLE(Input, VerticalSensitivity)
 	OPTION_DOUBLE(Input, CameraPitchLimit)
 	OPTION_BOOL(Input, PixelPerfectSelection)
+	OPTION_BOOL(Input, PickFromFrame)
 
 	OPTION_STRING(Misc, ArenaPath)
 	OPTION_STRING(Misc, ArenaSavesPath)
@@ -1,5 +1,7 @@
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <unordered_set>
 
 #include "Physics.h"
 #include "../Assets/ArenaTypes.h"
@@ -25,6 +27,12 @@ namespace Physics
 {
 	using VoxelEntityMap = std::unordered_map<NewInt3, std::vector<EntityManager::EntityVisibilityData>>;
 
+	// Occupancy blocks (XZ block coordinate and Y level) touched by entities at each occupancy level.
+	using EntityBlockSets = std::array<std::unordered_set<NewInt3>, VoxelGrid::OCCUPANCY_LEVEL_COUNT>;
+
+	// Reused between ray casts so the sets keep their buckets instead of allocating each time.
+	thread_local EntityBlockSets EntityBlockSetsScratch;
+
 	// Converts the normal to the associated voxel facing on success. Not all conversions
 	// exist, for example, diagonals have normals but do not have a voxel facing.
 	bool TryGetFacingFromNormal(const Double3 &normal, VoxelFacing3D *outFacing)
@@ -133,7 +141,8 @@ namespace Physics
 				continue;
 			}
 
-			const CoordDouble2 cameraCoordXZ = VoxelUtils::newPointToCoord(absoluteCameraPositionXZ);
+			// Same eye as the renderer so this frame's cached visibility data can be reused.
+			const CoordDouble2 cameraCoordXZ(cameraCoord.chunk, VoxelDouble2(cameraCoord.point.x, cameraCoord.point.z));
 			EntityManager::EntityVisibilityData visData;
 			entityManager.getEntityVisibilityData(entity, cameraCoordXZ, ceilingHeight, voxelGrid,
 				entityDefLibrary, visData);
@@ -993,13 +1002,33 @@ namespace Physics
 		}
 	}
 
+	// Gets the occupancy blocks that contain entities so the ray cast doesn't skip over them.
+	void makeEntityBlockSets(const VoxelEntityMap &voxelEntityMap, EntityBlockSets &entityBlockSets)
+	{
+		for (std::unordered_set<NewInt3> &entityBlockSet : entityBlockSets)
+		{
+			entityBlockSet.clear();
+		}
+
+		for (const auto &pair : voxelEntityMap)
+		{
+			const NewInt3 &voxel = pair.first;
+			for (int i = 0; i < VoxelGrid::OCCUPANCY_LEVEL_COUNT; i++)
+			{
+				const int blockShift = VoxelGrid::OCCUPANCY_BLOCK_SHIFTS[i];
+				entityBlockSets[i].emplace(voxel.x >> blockShift, voxel.y, voxel.z >> blockShift);
+			}
+		}
+	}
+
 	// Internal ray casting loop for stepping through individual voxels and checking
-	// ray intersections with voxel data and entities.
+	// ray intersections with voxel data and entities. Blocks of air without entities are
+	// jumped over.
 	template <bool NonNegativeDirX, bool NonNegativeDirY, bool NonNegativeDirZ>
 	void rayCastInternal(const CoordDouble3 &rayStart, const NewDouble3 &rayDirection, const NewDouble3 &cameraForward,
 		double ceilingHeight, const LevelData &levelData, const VoxelEntityMap &voxelEntityMap,
-		bool pixelPerfect, const Palette &palette, const EntityDefinitionLibrary &entityDefLibrary,
-		const Renderer &renderer, Physics::Hit &hit)
+		const EntityBlockSets &entityBlockSets, bool pixelPerfect, const Palette &palette,
+		const EntityDefinitionLibrary &entityDefLibrary, const Renderer &renderer, Physics::Hit &hit)
 	{
 		const VoxelGrid &voxelGrid = levelData.getVoxelGrid();
 		const EntityManager &entityManager = levelData.getEntityManager();
@@ -1178,10 +1207,92 @@ namespace Physics
 		// Step forward in the grid once to leave the initial voxel and update the ray distance.
 		doDDAStep();
 
+		// Returns the block shift of the coarsest occupancy block around the current voxel that has
+		// nothing to hit on its Y level, or -1 if there isn't one.
+		auto getEmptyBlockShift = [&voxelGrid, &currentVoxel, &entityBlockSets]()
+		{
+			for (int i = 0; i < VoxelGrid::OCCUPANCY_LEVEL_COUNT; i++)
+			{
+				if (voxelGrid.isOccupancyBlockEmpty(i, currentVoxel.x, currentVoxel.y, currentVoxel.z))
+				{
+					const int blockShift = VoxelGrid::OCCUPANCY_BLOCK_SHIFTS[i];
+					const NewInt3 block(currentVoxel.x >> blockShift, currentVoxel.y, currentVoxel.z >> blockShift);
+					if (entityBlockSets[i].find(block) == entityBlockSets[i].end())
+					{
+						return blockShift;
+					}
+				}
+			}
+
+			return -1;
+		};
+
 		// Step through the grid while the current voxel coordinate is valid. There doesn't
 		// really need to be a max distance check here.
 		while (voxelIsValid)
 		{
+			const int emptyBlockShift = getEmptyBlockShift();
+			if (emptyBlockShift >= 0)
+			{
+				// Jump to where the ray leaves the block. Blocks are one voxel tall, so stepping in Y
+				// always leaves it. Ties between axes are broken the same way as in a DDA step.
+				const int exitStepsX = VoxelUtils::getDDABlockExitStepCount(currentVoxel.x, emptyBlockShift, NonNegativeDirX);
+				const int exitStepsZ = VoxelUtils::getDDABlockExitStepCount(currentVoxel.z, emptyBlockShift, NonNegativeDirZ);
+				const double exitDistX = VoxelUtils::getDDABoundaryDistance(deltaDistSumX, deltaDist.x, exitStepsX);
+				const double exitDistY = deltaDistSumY;
+				const double exitDistZ = VoxelUtils::getDDABoundaryDistance(deltaDistSumZ, deltaDist.z, exitStepsZ);
+
+				int stepsX, stepsY, stepsZ;
+				if ((exitDistX < exitDistY) && (exitDistX < exitDistZ))
+				{
+					stepsX = exitStepsX;
+					stepsY = 0;
+					stepsZ = VoxelUtils::getDDACrossingCount(deltaDistSumZ, deltaDist.z, exitDistX, true, exitStepsZ - 1);
+					facing = visibleWallFacings[0];
+					rayDistance = ((static_cast<double>(currentVoxel.x + (stepsX * stepX)) - absoluteRayStart.x) +
+						halfOneMinusStepXReal) / rayDirection.x;
+				}
+				else if (exitDistY < exitDistZ)
+				{
+					stepsX = VoxelUtils::getDDACrossingCount(deltaDistSumX, deltaDist.x, exitDistY, false, exitStepsX - 1);
+					stepsY = 1;
+					stepsZ = VoxelUtils::getDDACrossingCount(deltaDistSumZ, deltaDist.z, exitDistY, true, exitStepsZ - 1);
+					facing = visibleWallFacings[1];
+					rayDistance = ((static_cast<double>(currentVoxel.y + stepY) - absoluteRayStart.y) +
+						halfOneMinusStepYReal) / rayDirection.y;
+				}
+				else
+				{
+					stepsX = VoxelUtils::getDDACrossingCount(deltaDistSumX, deltaDist.x, exitDistZ, false, exitStepsX - 1);
+					stepsY = 0;
+					stepsZ = exitStepsZ;
+					facing = visibleWallFacings[2];
+					rayDistance = ((static_cast<double>(currentVoxel.z + (stepsZ * stepZ)) - absoluteRayStart.z) +
+						halfOneMinusStepZReal) / rayDirection.z;
+				}
+
+				if (stepsX > 0)
+				{
+					deltaDistSumX = VoxelUtils::getDDABoundaryDistance(deltaDistSumX, deltaDist.x, stepsX) + deltaDist.x;
+					currentVoxel.x += stepsX * stepX;
+				}
+
+				if (stepsY > 0)
+				{
+					deltaDistSumY += deltaDist.y;
+					currentVoxel.y += stepY;
+				}
+
+				if (stepsZ > 0)
+				{
+					deltaDistSumZ = VoxelUtils::getDDABoundaryDistance(deltaDistSumZ, deltaDist.z, stepsZ) + deltaDist.z;
+					currentVoxel.z += stepsZ * stepZ;
+				}
+
+				voxelIsValid = voxelGrid.coordIsValid(currentVoxel.x, currentVoxel.y, currentVoxel.z);
+				continue;
+			}
+
 			// Store part of the current DDA state. The loop needs to do another DDA step to calculate
 			// the point on the far side of this voxel.
 			const NewInt3 savedVoxel = currentVoxel;
@@ -1295,6 +1406,9 @@ bool Physics::rayCast(const CoordDouble3 &rayStart, const NewDouble3 &rayDirecti
 			ceilingHeight, voxelGrid, entityManager, entityDefLibrary);
 	}
 
+	EntityBlockSets &entityBlockSets = Physics::EntityBlockSetsScratch;
+	Physics::makeEntityBlockSets(voxelEntityMap, entityBlockSets);
+
 	// Ray cast through the voxel grid, populating the output hit data. Use the ray direction
 	// booleans for better code generation (at the expense of having a pile of if/else branches
 	// here).
@@ -1309,12 +1423,12 @@ bool Physics::rayCast(const CoordDouble3 &rayStart, const NewDouble3 &rayDirecti
 			if (nonNegativeDirZ)
 			{
 				Physics::rayCastInternal<true, true, true>(rayStart, rayDirection, cameraForward, ceilingHeight,
-					levelData, voxelEntityMap, pixelPerfect, palette, entityDefLibrary, renderer, hit);
+					levelData, voxelEntityMap, entityBlockSets, pixelPerfect, palette, entityDefLibrary, renderer, hit);
 			}
 			else
 			{
 				Physics::rayCastInternal<true, true, false>(rayStart, rayDirection, cameraForward, ceilingHeight,
-					levelData, voxelEntityMap, pixelPerfect, palette, entityDefLibrary, renderer, hit);
+					levelData, voxelEntityMap, entityBlockSets, pixelPerfect, palette, entityDefLibrary, renderer, hit);
 			}
 		}
 		else
@@ -1322,12 +1436,12 @@ bool Physics::rayCast(const CoordDouble3 &rayStart, const NewDouble3 &rayDirecti
 			if (nonNegativeDirZ)
 			{
 				Physics::rayCastInternal<true, false, true>(rayStart, rayDirection, cameraForward, ceilingHeight,
-					levelData, voxelEntityMap, pixelPerfect, palette, entityDefLibrary, renderer, hit);
+					levelData, voxelEntityMap, entityBlockSets, pixelPerfect, palette, entityDefLibrary, renderer, hit);
 			}
 			else
 			{
 				Physics::rayCastInternal<true, false, false>(rayStart, rayDirection, cameraForward, ceilingHeight,
-					levelData, voxelEntityMap, pixelPerfect, palette, entityDefLibrary, renderer, hit);
+					levelData, voxelEntityMap, entityBlockSets, pixelPerfect, palette, entityDefLibrary, renderer, hit);
 			}
 		}
 	}
@@ -1338,12 +1452,12 @@ bool Physics::rayCast(const CoordDouble3 &rayStart, const NewDouble3 &rayDirecti
 			if (nonNegativeDirZ)
 			{
 				Physics::rayCastInternal<false, true, true>(rayStart, rayDirection, cameraForward, ceilingHeight,
-					levelData, voxelEntityMap, pixelPerfect, palette, entityDefLibrary, renderer, hit);
+					levelData, voxelEntityMap, entityBlockSets, pixelPerfect, palette, entityDefLibrary, renderer, hit);
 			}
 			else
 			{
 				Physics::rayCastInternal<false, true, false>(rayStart, rayDirection, cameraForward, ceilingHeight,
-					levelData, voxelEntityMap, pixelPerfect, palette, entityDefLibrary, renderer, hit);
+					levelData, voxelEntityMap, entityBlockSets, pixelPerfect, palette, entityDefLibrary, renderer, hit);
 			}
 		}
 		else
@@ -1351,12 +1465,12 @@ bool Physics::rayCast(const CoordDouble3 &rayStart, const NewDouble3 &rayDirecti
 			if (nonNegativeDirZ)
 			{
 				Physics::rayCastInternal<false, false, true>(rayStart, rayDirection, cameraForward, ceilingHeight,
-					levelData, voxelEntityMap, pixelPerfect, palette, entityDefLibrary, renderer, hit);
+					levelData, voxelEntityMap, entityBlockSets, pixelPerfect, palette, entityDefLibrary, renderer, hit);
 			}
 			else
 			{
 				Physics::rayCastInternal<false, false, false>(rayStart, rayDirection, cameraForward, ceilingHeight,
-					levelData, voxelEntityMap, pixelPerfect, palette, entityDefLibrary, renderer, hit);
+					levelData, voxelEntityMap, entityBlockSets, pixelPerfect, palette, entityDefLibrary, renderer, hit);
 			}
 		}
 	}
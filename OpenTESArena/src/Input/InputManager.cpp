@@ -1,7 +1,12 @@
 #include "InputManager.h"
 
 InputManager::InputManager()
-	: mouseDelta(0, 0) { }
+	: mouseDelta(0, 0), lateMouseDelta(0, 0)
+{
+	this->mouseDeltaLatched = false;
+	this->inputLatency = 0.0;
+	this->lateInputLatency = 0.0;
+}
 
 bool InputManager::keyPressed(const SDL_Event &e, SDL_Keycode keycode) const
 {
@@ -79,6 +84,16 @@ Int2 InputManager::getMouseDelta() const
 	return this->mouseDelta;
 }
 
+double InputManager::getInputLatency() const
+{
+	return this->inputLatency;
+}
+
+double InputManager::getLateInputLatency() const
+{
+	return this->lateInputLatency;
+}
+
 void InputManager::setRelativeMouseMode(bool active)
 {
 	SDL_bool enabled = active ? SDL_TRUE : SDL_FALSE;
@@ -87,6 +102,42 @@ void InputManager::setRelativeMouseMode(bool active)
 
 void InputManager::update()
 {
-	// Refresh the mouse delta.
-	SDL_GetRelativeMouseState(&this->mouseDelta.x, &this->mouseDelta.y);
+	// Refresh the mouse delta. Motion that was late-latched last frame hasn't been given to
+	// the simulation yet, so include it here.
+	int dx, dy;
+	SDL_GetRelativeMouseState(&dx, &dy);
+	this->mouseDelta = Int2(dx, dy) + this->lateMouseDelta;
+	this->lateMouseDelta = Int2(0, 0);
+	this->mouseDeltaLatched = false;
+	this->mouseSampleTime = std::chrono::steady_clock::now();
+}
+
+Int2 InputManager::latchMouseDelta()
+{
+	// Get the OS to deliver any mouse motion that happened since the start of the frame.
+	SDL_PumpEvents();
+
+	int dx, dy;
+	SDL_GetRelativeMouseState(&dx, &dy);
+	this->lateMouseDelta = this->lateMouseDelta + Int2(dx, dy);
+	this->mouseDeltaLatched = true;
+	this->lateMouseSampleTime = std::chrono::steady_clock::now();
+	return this->lateMouseDelta;
+}
+
+void InputManager::onFramePresented()
+{
+	const auto presentTime = std::chrono::steady_clock::now();
+	const std::chrono::duration<double> latency = presentTime - this->mouseSampleTime;
+	this->inputLatency = latency.count();
+
+	if (this->mouseDeltaLatched)
+	{
+		const std::chrono::duration<double> lateLatency = presentTime - this->lateMouseSampleTime;
+		this->lateInputLatency = lateLatency.count();
+	}
+	else
+	{
+		this->lateInputLatency = this->inputLatency;
+	}
 }
@@ -1,6 +1,7 @@
 #ifndef INPUT_MANAGER_H
 #define INPUT_MANAGER_H
 
+#include <chrono>
 #include <cstdint>
 
 #include "SDL.h"
@@ -16,6 +17,16 @@ class InputManager
 {
 private:	
 	Int2 mouseDelta;
+
+	// Mouse motion sampled late in the frame. It has already been shown on screen by the
+	// renderer and is folded into the next frame's mouse delta so the simulation catches up.
+	Int2 lateMouseDelta;
+	bool mouseDeltaLatched;
+
+	// When the mouse was last sampled, and how long it took for those samples to reach a
+	// presented frame (in seconds).
+	std::chrono::steady_clock::time_point mouseSampleTime, lateMouseSampleTime;
+	double inputLatency, lateInputLatency;
 public:
 	InputManager();
 
@@ -34,12 +45,26 @@ public:
 	Int2 getMousePosition() const;
 	Int2 getMouseDelta() const;
 
+	// Gets the time between sampling the mouse and presenting the frame that used it. The late
+	// latency is for the late-latched sample, and equals the regular one when no late latch
+	// happened in that frame.
+	double getInputLatency() const;
+	double getLateInputLatency() const;
+
 	// Sets whether the mouse should move during motion events (for player camera).
 	void setRelativeMouseMode(bool active);
 
 	// Updates input values whose associated SDL functions should only be called once 
 	// per frame.
 	void update();
+
+	// Pumps pending events and returns any mouse motion since update(). Intended to be called
+	// right before rendering so the view uses the freshest input. The returned delta is also
+	// added to the next frame's mouse delta.
+	Int2 latchMouseDelta();
+
+	// Records that the current frame was presented, for measuring input latency.
+	void onFramePresented();
 };
 
 #endif
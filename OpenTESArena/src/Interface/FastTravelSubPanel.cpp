@@ -323,27 +323,15 @@ void FastTravelSubPanel::tickTravelTime(Random &random) const
 {
 	auto &game = this->getGame();
 	auto &gameData = game.getGameData();
+	const auto &exeData = game.getBinaryAssetLibrary().getExeData();
 
-	// Tick the game date by the number of travel days.
-	auto &date = gameData.getDate();
-	for (int i = 0; i < this->travelData.travelDays; i++)
-	{
-		date.incrementDay();
-	}
-
-	// Add between 0 and 22 random hours to the clock time.
-	auto &clock = gameData.getClock();
+	// Advance by the number of travel days plus between 0 and 22 random hours. This also
+	// updates the weather since at least one day passes.
+	constexpr int secondsPerHour = Clock::SECONDS_IN_A_DAY / 24;
 	const int randomHours = random.next(23);
-	for (int i = 0; i < randomHours; i++)
-	{
-		clock.incrementHour();
-
-		// Increment day if the clock loops around.
-		if (clock.getHours24() == 0)
-		{
-			date.incrementDay();
-		}
-	}
+	const double travelSeconds = (static_cast<double>(this->travelData.travelDays) *
+		static_cast<double>(Clock::SECONDS_IN_A_DAY)) + static_cast<double>(randomHours * secondsPerHour);
+	gameData.advanceClock(travelSeconds, exeData);
 }
 
 void FastTravelSubPanel::switchToNextPanel()
@@ -352,15 +340,11 @@ void FastTravelSubPanel::switchToNextPanel()
 	auto &game = this->getGame();
 	auto &gameData = game.getGameData();
 	const auto &binaryAssetLibrary = game.getBinaryAssetLibrary();
-	const auto &exeData = binaryAssetLibrary.getExeData();
 	const WorldMapDefinition &worldMapDef = gameData.getWorldMapDefinition();
 
-	// Update game clock.
+	// Update game clock and weathers.
 	this->tickTravelTime(game.getRandom());
 
-	// Update weathers.
-	gameData.updateWeather(exeData);
-
 	// Clear the lore text (action text and effect text are unchanged).
 	gameData.resetTriggerText();
 
@@ -34,7 +34,7 @@ private:
 	// - @todo: holiday pop-up function.
 	std::unique_ptr<Panel> makeCityArrivalPopUp() const;
 
-	// Updates the game clock based on the travel data.
+	// Updates the game clock, date, and weather based on the travel data.
 	void tickTravelTime(Random &random) const;
 
 	// Called when the target animation time has been reached. Decides whether to go
@@ -0,0 +1,88 @@
+#include "FrameTimings.h"
+
+#include "components/debug/Debug.h"
+
+namespace
+{
+	// Display names of each stage in enum order.
+	const std::array<const char*, FrameTimings::STAGE_COUNT> StageNames =
+	{
+		"Input",
+		"Simulation",
+		"Entities",
+		"Chunk update",
+		"Voxel update",
+		"Visibility",
+		"Sky",
+		"Voxels",
+		"Planes",
+		"Flats",
+		"Interface",
+		"Present"
+	};
+}
+
+FrameTimings::FrameTimings()
+{
+	for (auto &frameStageTimes : this->stageTimes)
+	{
+		frameStageTimes.fill(0.0);
+	}
+
+	this->frameTimes.fill(0.0);
+	this->currentIndex = 0;
+}
+
+FrameTimings::TimePoint FrameTimings::now()
+{
+	return std::chrono::high_resolution_clock::now();
+}
+
+const char *FrameTimings::getStageName(Stage stage)
+{
+	const int index = static_cast<int>(stage);
+	DebugAssertIndex(StageNames, index);
+	return StageNames[index];
+}
+
+int FrameTimings::getRingIndex(int index) const
+{
+	DebugAssert(index >= 0);
+	DebugAssert(index < FRAME_COUNT);
+
+	// The oldest completed frame is the one right after the frame in progress.
+	return (this->currentIndex + 1 + index) % FRAME_COUNT;
+}
+
+double FrameTimings::getFrameTime(int index) const
+{
+	return this->frameTimes[this->getRingIndex(index)];
+}
+
+double FrameTimings::getStageTime(int index, Stage stage) const
+{
+	return this->stageTimes[this->getRingIndex(index)][static_cast<int>(stage)];
+}
+
+double FrameTimings::getCurrentStageTime(Stage stage) const
+{
+	return this->stageTimes[this->currentIndex][static_cast<int>(stage)];
+}
+
+void FrameTimings::addStageTime(Stage stage, double seconds)
+{
+	this->stageTimes[this->currentIndex][static_cast<int>(stage)] += seconds;
+}
+
+void FrameTimings::addStageTime(Stage stage, const TimePoint &startTime)
+{
+	const std::chrono::duration<double> elapsed = FrameTimings::now() - startTime;
+	this->addStageTime(stage, elapsed.count());
+}
+
+void FrameTimings::nextFrame(double dt)
+{
+	this->frameTimes[this->currentIndex] = dt;
+	this->currentIndex = (this->currentIndex + 1) % FRAME_COUNT;
+	this->stageTimes[this->currentIndex].fill(0.0);
+}
@@ -0,0 +1,64 @@
+#ifndef FRAME_TIMINGS_H
+#define FRAME_TIMINGS_H
+
+#include <array>
+#include <chrono>
+
+// Rolling history of how long each part of a frame took, for the profiler graphs. Stages add
+// their time to the frame in progress, and the ring advances once per frame.
+
+class FrameTimings
+{
+public:
+	enum class Stage
+	{
+		Input,
+		Simulation,
+		EntityTick,
+		ChunkUpdate,
+		VoxelUpdate,
+		Visibility,
+		RenderSky,
+		RenderVoxels,
+		RenderPlanes,
+		RenderFlats,
+		Interface,
+		Present
+	};
+
+	static constexpr int STAGE_COUNT = static_cast<int>(Stage::Present) + 1;
+	static constexpr int FRAME_COUNT = 96;
+
+	using TimePoint = std::chrono::high_resolution_clock::time_point;
+private:
+	// Seconds per stage for each frame. The current index is the frame in progress.
+	std::array<std::array<double, STAGE_COUNT>, FRAME_COUNT> stageTimes;
+	std::array<double, FRAME_COUNT> frameTimes;
+	int currentIndex;
+
+	int getRingIndex(int index) const;
+public:
+	FrameTimings();
+
+	static TimePoint now();
+
+	// Gets the display name of a stage.
+	static const char *getStageName(Stage stage);
+
+	// Gets timings of completed frames. Index 0 is the oldest and FRAME_COUNT - 1 the newest.
+	double getFrameTime(int index) const;
+	double getStageTime(int index, Stage stage) const;
+
+	// Gets the time recorded so far for a stage in the frame in progress.
+	double getCurrentStageTime(Stage stage) const;
+
+	// Adds time to a stage of the frame in progress.
+	void addStageTime(Stage stage, double seconds);
+	void addStageTime(Stage stage, const TimePoint &startTime);
+
+	// Finishes the frame in progress with its total duration and starts a new one. This should
+	// be called once per frame.
+	void nextFrame(double dt);
+};
+
+#endif
@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <cmath>
+#include <optional>
 
 #include "SDL.h"
 
@@ -65,6 +66,7 @@
 #include "../World/WeatherUtils.h"
 
 #include "components/debug/Debug.h"
+#include "components/utilities/BufferAllocator.h"
 #include "components/utilities/String.h"
 
 namespace
@@ -100,6 +102,23 @@ namespace
 		CursorAlignment::Right
 	};
 
+	// Colors of each frame stage in the profiler graph, in FrameTimings::Stage order.
+	const std::array<Color, FrameTimings::STAGE_COUNT> ProfilerStageColors =
+	{
+		Color(128, 128, 255), // Input
+		Color(0, 192, 255), // Simulation
+		Color(0, 255, 128), // Entity tick
+		Color(192, 128, 64), // Chunk update
+		Color(128, 192, 0), // Voxel update
+		Color(255, 255, 0), // Visibility
+		Color(96, 160, 255), // Sky
+		Color(255, 128, 0), // Voxels
+		Color(255, 64, 64), // Planes
+		Color(255, 0, 255), // Flats
+		Color(255, 255, 255), // Interface
+		Color(160, 160, 160) // Present
+	};
+
 	// @temp: keep until 3D-DDA ray casting is fully correct (i.e. entire ground is red dots for
 	// levels where ceilingHeight < 1.0, and same with ceiling blue dots).
 	void DEBUG_ColorRaycastPixel(Game &game, Renderer &renderer)
@@ -675,6 +694,35 @@ GameWorldPanel::GameWorldPanel(Game &game)
 	{
 		this->setFreeLookActive(true);
 	}
+
+	this->paused = false;
+
+	// Listen for times of day that change lampposts and exterior music. These are driven by
+	// the game clock so they still fire when time jumps forward by more than a frame.
+	auto &clockEvents = game.getGameData().getClockEvents();
+	this->clockEventIDs.push_back(clockEvents.addDailyEvent(
+		ArenaClockUtils::LamppostActivate.getPreciseTotalSeconds(), [this]()
+	{
+		this->handleNightLightChange(true);
+	}));
+
+	this->clockEventIDs.push_back(clockEvents.addDailyEvent(
+		ArenaClockUtils::LamppostDeactivate.getPreciseTotalSeconds(), [this]()
+	{
+		this->handleNightLightChange(false);
+	}));
+
+	this->clockEventIDs.push_back(clockEvents.addDailyEvent(
+		ArenaClockUtils::MusicSwitchToDay.getPreciseTotalSeconds(), [this]()
+	{
+		this->handleExteriorMusicChange(false);
+	}));
+
+	this->clockEventIDs.push_back(clockEvents.addDailyEvent(
+		ArenaClockUtils::MusicSwitchToNight.getPreciseTotalSeconds(), [this]()
+	{
+		this->handleExteriorMusicChange(true);
+	}));
 }
 
 GameWorldPanel::~GameWorldPanel()
@@ -688,6 +736,16 @@ GameWorldPanel::~GameWorldPanel()
 	{
 		this->setFreeLookActive(false);
 	}
+
+	// The game data might already be gone (i.e., when returning to the main menu).
+	if (game.gameDataIsActive())
+	{
+		auto &clockEvents = game.getGameData().getClockEvents();
+		for (const ClockEventScheduler::EventID eventID : this->clockEventIDs)
+		{
+			clockEvents.removeEvent(eventID);
+		}
+	}
 }
 
 Int2 GameWorldPanel::getInterfaceCenter(bool modernInterface, TextureManager &textureManager)
@@ -1128,9 +1186,18 @@ void GameWorldPanel::handleEvent(const SDL_Event &e)
 	}
 }
 
+bool GameWorldPanel::WorldFrameView::equals(const WorldFrameView &other) const
+{
+	return (this->eye.chunk == other.eye.chunk) && (this->eye.point == other.eye.point) &&
+		(this->direction == other.direction) && (this->fovY == other.fovY) &&
+		(this->chunkDistance == other.chunkDistance) && (this->entityCount == other.entityCount) &&
+		(this->playerHasLight == other.playerHasLight);
+}
+
 void GameWorldPanel::onPauseChanged(bool paused)
 {
 	auto &game = this->getGame();
+	this->paused = paused;
 
 	// If in modern mode, set free-look to the given value.
 	const auto &options = game.getOptions();
@@ -1148,6 +1215,39 @@ void GameWorldPanel::resize(int windowWidth, int windowHeight)
 	this->updateCursorRegions(windowWidth, windowHeight);
 }
 
+std::optional<Double2> GameWorldPanel::getMouseLookDelta(const Int2 &mouseDelta) const
+{
+	auto &game = this->getGame();
+	const auto &options = game.getOptions();
+	if (!options.getGraphics_ModernInterface())
+	{
+		return std::nullopt;
+	}
+
+	const int dx = mouseDelta.x;
+	const int dy = mouseDelta.y;
+	const auto &inputManager = game.getInputManager();
+	const bool rightClick = inputManager.mouseButtonIsDown(SDL_BUTTON_RIGHT);
+
+	const auto &player = game.getGameData().getPlayer();
+	const auto &weaponAnim = player.getWeaponAnimation();
+	const bool turning = ((dx != 0) || (dy != 0)) && (weaponAnim.isSheathed() || !rightClick);
+	if (!turning)
+	{
+		return std::nullopt;
+	}
+
+	const Int2 dimensions = game.getRenderer().getWindowDimensions();
+
+	// Get the smaller of the two dimensions, so the look sensitivity is relative
+	// to a square instead of a rectangle. This keeps the camera look independent
+	// of the aspect ratio.
+	const int minDimension = std::min(dimensions.x, dimensions.y);
+	const double dxx = static_cast<double>(dx) / static_cast<double>(minDimension);
+	const double dyy = static_cast<double>(dy) / static_cast<double>(minDimension);
+	return Double2(dxx, -dyy);
+}
+
 void GameWorldPanel::handlePlayerTurning(double dt, const Int2 &mouseDelta)
 {
 	// In the future, maybe this could be separated into two methods:
@@ -1247,27 +1347,12 @@ void GameWorldPanel::handlePlayerTurning(double dt, const Int2 &mouseDelta)
 	else
 	{
 		// Modern interface. Make the camera look around if the player's weapon is not in use.
-		const int dx = mouseDelta.x;
-		const int dy = mouseDelta.y;
-		const bool rightClick = inputManager.mouseButtonIsDown(SDL_BUTTON_RIGHT);
-
-		auto &player = game.getGameData().getPlayer();
-		const auto &weaponAnim = player.getWeaponAnimation();
-		const bool turning = ((dx != 0) || (dy != 0)) && (weaponAnim.isSheathed() || !rightClick);
-
-		if (turning)
+		const std::optional<Double2> lookDelta = this->getMouseLookDelta(mouseDelta);
+		if (lookDelta.has_value())
 		{
-			const Int2 dimensions = game.getRenderer().getWindowDimensions();
-
-			// Get the smaller of the two dimensions, so the look sensitivity is relative
-			// to a square instead of a rectangle. This keeps the camera look independent
-			// of the aspect ratio.
-			const int minDimension = std::min(dimensions.x, dimensions.y);
-			const double dxx = static_cast<double>(dx) / static_cast<double>(minDimension);
-			const double dyy = static_cast<double>(dy) / static_cast<double>(minDimension);
-
 			// Pitch and/or yaw the camera.
-			player.rotate(dxx, -dyy, options.getInput_HorizontalSensitivity(),
+			auto &player = game.getGameData().getPlayer();
+			player.rotate(lookDelta->x, lookDelta->y, options.getInput_HorizontalSensitivity(),
 				options.getInput_VerticalSensitivity(), options.getInput_CameraPitchLimit());
 		}
 	}
@@ -1703,12 +1788,62 @@ void GameWorldPanel::handleClickInWorld(const Int2 &nativePoint, bool primaryCli
 	}
 
 	const Palette &palette = textureManager.getPaletteHandle(*paletteID);
-	const bool includeEntities = true;
+	const auto &renderer = game.getRenderer();
+
+	// Entities and voxels can be picked straight from the most recent frame when the hit buffer is
+	// on. The ray cast still handles everything when there's no usable frame, the picked entity has
+	// changed since, or the pixel has nothing the frame could identify (i.e., screen-space chasms).
+	const bool canPickFromFrame = options.getInput_PickFromFrame() && renderer.hasHitBuffer();
 
 	Physics::Hit hit;
-	const bool success = Physics::rayCast(rayStart, rayDirection, chunkDistance, ceilingHeight,
-		cameraDirection, pixelPerfectSelection, palette, includeEntities, level,
-		game.getEntityDefinitionLibrary(), game.getRenderer(), hit);
+	bool success = false;
+	bool isFrameEntityStale = false;
+	if (canPickFromFrame)
+	{
+		// Frame depths are in the XZ plane, so they're converted to distance along the ray.
+		const double rayLengthXZ = NewDouble2(rayDirection.x, rayDirection.z).length();
+
+		EntityID entityID;
+		int entityGeneration;
+		double entityDepth;
+		NewInt3 frameVoxel;
+		std::optional<VoxelFacing3D> frameFacing;
+		double voxelDepth;
+		if (renderer.tryGetEntityHit(nativePoint, &entityID, &entityGeneration, &entityDepth))
+		{
+			// The entity might have been removed and its ID given to another one since the frame.
+			ConstEntityRef entityRef = entityManager.getEntityRef(entityID);
+			isFrameEntityStale = (entityRef.getID() == EntityManager::NO_ID) ||
+				(entityRef.get()->getGeneration() != entityGeneration);
+
+			if (!isFrameEntityStale)
+			{
+				const double t = entityDepth / rayLengthXZ;
+				const NewDouble3 hitPoint = VoxelUtils::coordToNewPoint(rayStart) + (rayDirection * t);
+				hit.initEntity(t, hitPoint, entityID, entityRef.get()->getEntityType());
+				success = true;
+			}
+		}
+		else if (renderer.tryGetVoxelHit(nativePoint, &frameVoxel, &frameFacing, &voxelDepth))
+		{
+			const double t = voxelDepth / rayLengthXZ;
+			const NewDouble3 hitPoint = VoxelUtils::coordToNewPoint(rayStart) + (rayDirection * t);
+			const uint16_t frameVoxelID = voxelGrid.getVoxel(frameVoxel.x, frameVoxel.y, frameVoxel.z);
+			const CoordInt3 frameCoord = VoxelUtils::newVoxelToCoord(frameVoxel);
+			const VoxelFacing3D *frameFacingPtr = frameFacing.has_value() ? &(*frameFacing) : nullptr;
+			hit.initVoxel(t, hitPoint, frameVoxelID, frameCoord, frameFacingPtr);
+			success = true;
+		}
+	}
+
+	if (!success)
+	{
+		// The frame already showed no entity at this pixel unless the one it had is stale.
+		const bool includeEntities = !canPickFromFrame || isFrameEntityStale;
+		success = Physics::rayCast(rayStart, rayDirection, chunkDistance, ceilingHeight,
+			cameraDirection, pixelPerfectSelection, palette, includeEntities, level,
+			game.getEntityDefinitionLibrary(), renderer, hit);
+	}
 
 	// See if the ray hit anything.
 	if (success)
@@ -2034,6 +2169,58 @@ void GameWorldPanel::handleNightLightChange(bool active)
 	renderer.setNightLightsActive(active, palette);
 }
 
+void GameWorldPanel::handleExteriorMusicChange(bool night)
+{
+	auto &game = this->getGame();
+	auto &gameData = game.getGameData();
+	const auto &worldData = gameData.getActiveWorld();
+	const MapType mapType = worldData.getMapType();
+
+	// Only exteriors have time-of-day music.
+	if ((mapType != MapType::City) && (mapType != MapType::Wilderness))
+	{
+		return;
+	}
+
+	const MusicLibrary &musicLibrary = game.getMusicLibrary();
+	const MusicDefinition *musicDef = nullptr;
+
+	if (!night)
+	{
+		const LocationDefinition &locationDef = gameData.getLocationDefinition();
+		const LocationDefinition::CityDefinition &cityDef = locationDef.getCityDefinition();
+		const WeatherType filteredWeatherType = WeatherUtils::getFilteredWeatherType(
+			gameData.getWeatherType(), cityDef.climateType);
+
+		musicDef = musicLibrary.getRandomMusicDefinitionIf(
+			MusicDefinition::Type::Weather, game.getRandom(),
+			[filteredWeatherType](const MusicDefinition &def)
+		{
+			DebugAssert(def.getType() == MusicDefinition::Type::Weather);
+			const auto &weatherMusicDef = def.getWeatherMusicDefinition();
+			return weatherMusicDef.type == filteredWeatherType;
+		});
+
+		if (musicDef == nullptr)
+		{
+			DebugLogWarning("Missing weather music.");
+		}
+	}
+	else
+	{
+		musicDef = musicLibrary.getRandomMusicDefinition(
+			MusicDefinition::Type::Night, game.getRandom());
+
+		if (musicDef == nullptr)
+		{
+			DebugLogWarning("Missing night music.");
+		}
+	}
+
+	AudioManager &audioManager = game.getAudioManager();
+	audioManager.setMusic(musicDef);
+}
+
 void GameWorldPanel::handleTriggers(const NewInt2 &voxel)
 {
 	auto &game = this->getGame();
@@ -2831,6 +3018,23 @@ void GameWorldPanel::drawProfiler(int profilerLevel, Renderer &renderer)
 		const std::string renderResScale = String::fixedPrecision(resolutionScale, 2);
 		const std::string renderThreadCount = std::to_string(profilerData.threadCount);
 
+		const auto &textureManager = game.getTextureManager();
+		constexpr double bytesPerMB = 1024.0 * 1024.0;
+		const std::string expandedTextureMB = String::fixedPrecision(
+			static_cast<double>(textureManager.getExpandedTextureBuilderByteCount()) / bytesPerMB, 1);
+		const std::string compressedTextureMB = String::fixedPrecision(
+			static_cast<double>(textureManager.getCompressedTextureBuilderByteCount()) / bytesPerMB, 1);
+		const std::string largePageMB = String::fixedPrecision(
+			static_cast<double>(BufferAllocator::getLargePageByteCount()) / bytesPerMB, 1);
+
+		// Voxel and flat texture reuse for the last level transition.
+		const std::string residentTextureMB = String::fixedPrecision(
+			static_cast<double>(profilerData.residentTextureBytes) / bytesPerMB, 1);
+		const std::string textureHitCount = std::to_string(profilerData.textureHitCount);
+		const std::string textureMissCount = std::to_string(profilerData.textureMissCount);
+		const std::string textureConversionTime = String::fixedPrecision(
+			profilerData.textureConversionTime * 1000.0, 1);
+
 		const std::string posX = String::fixedPrecision(absolutePosition.x, 2);
 		const std::string posY = String::fixedPrecision(absolutePosition.y, 2);
 		const std::string posZ = String::fixedPrecision(absolutePosition.z, 2);
@@ -2842,6 +3046,10 @@ void GameWorldPanel::drawProfiler(int profilerLevel, Renderer &renderer)
 			"Screen: " + windowWidth + "x" + windowHeight + '\n' +
 			"Render: " + renderWidth + "x" + renderHeight + " (" + renderResScale + "), " +
 			renderThreadCount + " thread" + ((profilerData.threadCount > 1) ? "s" : "") + '\n' +
+			"Textures: " + expandedTextureMB + "MB (compressed " + compressedTextureMB + "MB), " +
+			"large pages: " + largePageMB + "MB" + '\n' +
+			"3D textures: " + residentTextureMB + "MB, " + textureHitCount + " reused, " +
+			textureMissCount + " converted (" + textureConversionTime + "ms)" + '\n' +
 			"Pos: " + posX + ", " + posY + ", " + posZ + '\n' +
 			"Dir: " + dirX + ", " + dirY + ", " + dirZ;
 
@@ -2898,15 +3106,31 @@ void GameWorldPanel::drawProfiler(int profilerLevel, Renderer &renderer)
 		// Draw frame times and graph.
 		const Renderer::ProfilerData &profilerData = renderer.getProfilerData();
 		const std::string renderTime = String::fixedPrecision(profilerData.frameTime * 1000.0, 2);
+		const std::string bufferWaitTime = String::fixedPrecision(profilerData.bufferWaitTime * 1000.0, 2);
+
+		const auto &inputManager = game.getInputManager();
+		const std::string inputLatency = String::fixedPrecision(inputManager.getInputLatency() * 1000.0, 2);
+		const std::string lateInputLatency = String::fixedPrecision(inputManager.getLateInputLatency() * 1000.0, 2);
+
+		// Nearby entities that were ticked or frozen for being out of the player's reach.
+		const auto &entityManager = game.getGameData().getActiveWorld().getActiveLevel().getEntityManager();
+		const std::string activeEntityCount = std::to_string(entityManager.getActiveCount());
+		const std::string dormantEntityCount = std::to_string(entityManager.getDormantCount());
 
 		const std::string text =
-			"3D render: " + renderTime + "ms" + "\n" +
+			"3D render: " + renderTime + "ms (buffer wait " + bufferWaitTime + "ms)" + "\n" +
 			"Vis flats: " + std::to_string(profilerData.visFlatCount) + " (" +
 			std::to_string(profilerData.potentiallyVisFlatCount) + ")" +
 			", lights: " + std::to_string(profilerData.visLightCount) + "\n" +
 			"FPS Graph:" + '\n' +
 			"                               " + std::to_string(targetFps) + "\n\n\n\n" +
-			"                               " + std::to_string(0);
+			"                               " + std::to_string(0) + "\n" +
+			"Ray steps: " + std::to_string(profilerData.voxelRayStepCount) + " (skipped " +
+			std::to_string(profilerData.skippedVoxelRayStepCount) + ")" + "\n" +
+			"Input latency: " + inputLatency + "ms (late " + lateInputLatency + "ms)" + "\n" +
+			"Culled: " + std::to_string(profilerData.culledFlatCount) + " flats, " +
+			std::to_string(profilerData.culledLightCount) + " lights" + "\n" +
+			"Entities: " + activeEntityCount + " active, " + dormantEntityCount + " dormant";
 
 		const auto &fontLibrary = game.getFontLibrary();
 		const RichTextString richText(
@@ -2984,6 +3208,118 @@ void GameWorldPanel::drawProfiler(int profilerLevel, Renderer &renderer)
 		renderer.drawOriginal(textBox.getTexture(), textBox.getX(), textBox.getY());
 		renderer.drawOriginal(frameTimesGraph, textBox.getX(), 94);
 	}
+
+	if (profilerLevel >= 4)
+	{
+		this->drawProfilerGraph(renderer);
+	}
+}
+
+void GameWorldPanel::drawProfilerGraph(Renderer &renderer)
+{
+	auto &game = this->getGame();
+	const FrameTimings &frameTimings = game.getFrameTimings();
+	const int width = FrameTimings::FRAME_COUNT;
+	const int height = 64;
+
+	// The graph texture and legend are created once and reused every frame.
+	if (this->profilerGraphTexture.get() == nullptr)
+	{
+		this->profilerGraphTexture = renderer.createTexture(Renderer::DEFAULT_PIXELFORMAT,
+			SDL_TEXTUREACCESS_STREAMING, width, height);
+		SDL_SetTextureBlendMode(this->profilerGraphTexture.get(), SDL_BLENDMODE_BLEND);
+
+		const auto &fontLibrary = game.getFontLibrary();
+		for (int i = 0; i < FrameTimings::STAGE_COUNT; i++)
+		{
+			const RichTextString richText(
+				FrameTimings::getStageName(static_cast<FrameTimings::Stage>(i)),
+				FontName::D,
+				ProfilerStageColors[i],
+				TextAlignment::Left,
+				fontLibrary);
+
+			this->profilerLegendTextBoxes.emplace_back(
+				std::make_unique<TextBox>(0, 0, richText, fontLibrary, renderer));
+		}
+	}
+
+	uint32_t *pixels;
+	int pitch;
+	if (SDL_LockTexture(this->profilerGraphTexture.get(), nullptr,
+		reinterpret_cast<void**>(&pixels), &pitch) != 0)
+	{
+		DebugLogError("Couldn't lock profiler graph texture for updating.");
+		return;
+	}
+
+	const int pixelsPerRow = pitch / sizeof(*pixels);
+	auto toARGB = [](const Color &color)
+	{
+		return (0xFF << 24) | (color.r << 16) | (color.g << 8) | color.b;
+	};
+
+	std::fill(pixels, pixels + (pixelsPerRow * height), 0x80000000);
+
+	// Graph maximum is twice the target frame time so frame spikes are still visible.
+	const auto &options = game.getOptions();
+	const double targetFrameTime = 1.0 / static_cast<double>(options.getGraphics_TargetFPS());
+	const double graphMaxTime = targetFrameTime * 2.0;
+	auto timeToPixels = [height, graphMaxTime](double time)
+	{
+		return std::clamp(static_cast<int>((time / graphMaxTime) *
+			static_cast<double>(height)), 0, height);
+	};
+
+	auto fillColumn = [pixels, pixelsPerRow, height](int x, int yBottom, int pixelCount, uint32_t color)
+	{
+		const int yEnd = std::max(yBottom - pixelCount, 0);
+		for (int y = yBottom - 1; y >= yEnd; y--)
+		{
+			pixels[x + (y * pixelsPerRow)] = color;
+		}
+	};
+
+	const uint32_t unaccountedColor = toARGB(Color(64, 64, 64));
+	for (int x = 0; x < width; x++)
+	{
+		// Stack each stage's time bottom-up, then whatever wasn't measured by any stage.
+		int yBottom = height;
+		double stageTimeSum = 0.0;
+		for (int i = 0; i < FrameTimings::STAGE_COUNT; i++)
+		{
+			const double stageTime = frameTimings.getStageTime(x, static_cast<FrameTimings::Stage>(i));
+			const int stagePixels = timeToPixels(stageTimeSum + stageTime) - timeToPixels(stageTimeSum);
+			fillColumn(x, yBottom, stagePixels, toARGB(ProfilerStageColors[i]));
+			yBottom -= stagePixels;
+			stageTimeSum += stageTime;
+		}
+
+		const double frameTime = frameTimings.getFrameTime(x);
+		const int unaccountedPixels = timeToPixels(frameTime) - timeToPixels(stageTimeSum);
+		if (unaccountedPixels > 0)
+		{
+			fillColumn(x, yBottom, unaccountedPixels, unaccountedColor);
+		}
+	}
+
+	// Target frame time line.
+	const int targetY = std::clamp(height - timeToPixels(targetFrameTime), 0, height - 1);
+	std::fill(pixels + (targetY * pixelsPerRow), pixels + (targetY * pixelsPerRow) + width,
+		toARGB(Color::Green));
+
+	SDL_UnlockTexture(this->profilerGraphTexture.get());
+
+	const int x = ArenaRenderUtils::SCREEN_WIDTH - width - 2;
+	const int y = 2;
+	renderer.drawOriginal(this->profilerGraphTexture, x, y);
+
+	int legendY = y + height + 2;
+	for (const auto &textBox : this->profilerLegendTextBoxes)
+	{
+		renderer.drawOriginal(textBox->getTexture(), x, legendY);
+		legendY += textBox->getRect().getHeight();
+	}
 }
 
 void GameWorldPanel::tick(double dt)
@@ -3002,88 +3338,11 @@ void GameWorldPanel::tick(double dt)
 	// Tick the game world clock time.
 	auto &gameData = game.getGameData();
 	const bool debugFastForwardClock = inputManager.keyIsDown(SDL_SCANCODE_R); // @todo: camp button
-	const Clock oldClock = gameData.getClock();
 	gameData.tick(debugFastForwardClock ? (dt * 250.0) : dt, game);
-	const Clock newClock = gameData.getClock();
 
 	auto &renderer = game.getRenderer();
 
-	// See if the clock passed the boundary between night and day, and vice versa.
-	const double oldClockTime = oldClock.getPreciseTotalSeconds();
-	const double newClockTime = newClock.getPreciseTotalSeconds();
-	const double lamppostActivateTime = ArenaClockUtils::LamppostActivate.getPreciseTotalSeconds();
-	const double lamppostDeactivateTime = ArenaClockUtils::LamppostDeactivate.getPreciseTotalSeconds();
-	const bool activateNightLights =
-		(oldClockTime < lamppostActivateTime) &&
-		(newClockTime >= lamppostActivateTime);
-	const bool deactivateNightLights =
-		(oldClockTime < lamppostDeactivateTime) &&
-		(newClockTime >= lamppostDeactivateTime);
-
-	if (activateNightLights)
-	{
-		this->handleNightLightChange(true);
-	}
-	else if (deactivateNightLights)
-	{
-		this->handleNightLightChange(false);
-	}
-
 	auto &worldData = gameData.getActiveWorld();
-	const MapType mapType = worldData.getMapType();
-
-	// Check for changes in exterior music depending on the time.
-	if ((mapType == MapType::City) || (mapType == MapType::Wilderness))
-	{
-		const double dayMusicStartTime = ArenaClockUtils::MusicSwitchToDay.getPreciseTotalSeconds();
-		const double nightMusicStartTime = ArenaClockUtils::MusicSwitchToNight.getPreciseTotalSeconds();
-		const bool changeToDayMusic =
-			(oldClockTime < dayMusicStartTime) &&
-			(newClockTime >= dayMusicStartTime);
-		const bool changeToNightMusic =
-			(oldClockTime < nightMusicStartTime) &&
-			(newClockTime >= nightMusicStartTime);
-
-		const MusicLibrary &musicLibrary = game.getMusicLibrary();
-
-		if (changeToDayMusic)
-		{
-			const LocationDefinition &locationDef = gameData.getLocationDefinition();
-			const LocationDefinition::CityDefinition &cityDef = locationDef.getCityDefinition();
-			const WeatherType filteredWeatherType = WeatherUtils::getFilteredWeatherType(
-				gameData.getWeatherType(), cityDef.climateType);
-
-			const MusicDefinition *musicDef = musicLibrary.getRandomMusicDefinitionIf(
-				MusicDefinition::Type::Weather, game.getRandom(),
-				[filteredWeatherType](const MusicDefinition &def)
-			{
-				DebugAssert(def.getType() == MusicDefinition::Type::Weather);
-				const auto &weatherMusicDef = def.getWeatherMusicDefinition();
-				return weatherMusicDef.type == filteredWeatherType;
-			});
-
-			if (musicDef == nullptr)
-			{
-				DebugLogWarning("Missing weather music.");
-			}
-
-			AudioManager &audioManager = game.getAudioManager();
-			audioManager.setMusic(musicDef);
-		}
-		else if (changeToNightMusic)
-		{
-			const MusicDefinition *musicDef = musicLibrary.getRandomMusicDefinition(
-				MusicDefinition::Type::Night, game.getRandom());
-
-			if (musicDef == nullptr)
-			{
-				DebugLogWarning("Missing night music.");
-			}
-
-			AudioManager &audioManager = game.getAudioManager();
-			audioManager.setMusic(musicDef);
-		}
-	}
 
 	// Tick the player.
 	auto &player = gameData.getPlayer();
@@ -3097,7 +3356,10 @@ void GameWorldPanel::tick(double dt)
 	// Handle door animations.
 	const NewDouble3 newAbsolutePlayerPoint = VoxelUtils::coordToNewPoint(newPlayerPoint);
 	const NewDouble2 newAbsolutePlayerPointXZ(newAbsolutePlayerPoint.x, newAbsolutePlayerPoint.z);
+	FrameTimings &frameTimings = game.getFrameTimings();
+	const FrameTimings::TimePoint doorsStartTime = FrameTimings::now();
 	this->handleDoors(dt, newAbsolutePlayerPointXZ);
+	frameTimings.addStageTime(FrameTimings::Stage::VoxelUpdate, doorsStartTime);
 
 	// Tick level data (entities, animated distant land, etc.).
 	auto &levelData = worldData.getActiveLevel();
@@ -3147,8 +3409,8 @@ void GameWorldPanel::render(Renderer &renderer)
 	auto &game = this->getGame();
 	auto &gameData = game.getGameData();
 	auto &player = gameData.getPlayer();
-	const auto &worldData = gameData.getActiveWorld();
-	const auto &level = worldData.getActiveLevel();
+	auto &worldData = gameData.getActiveWorld();
+	auto &level = worldData.getActiveLevel();
 	const auto &options = game.getOptions();
 	const double ambientPercent = gameData.getAmbientPercent();
 
@@ -3171,11 +3433,68 @@ void GameWorldPanel::render(Renderer &renderer)
 
 	const Palette &defaultPalette = textureManager.getPaletteHandle(*defaultPaletteID);
 
-	renderer.renderWorld(player.getPosition(), player.getDirection(), options.getGraphics_VerticalFOV(),
-		ambientPercent, gameData.getDaytimePercent(), gameData.getChasmAnimPercent(), latitude,
-		gameData.nightLightsAreActive(), isExterior, options.getMisc_PlayerHasLight(),
-		options.getMisc_ChunkDistance(), level.getCeilingHeight(), level, game.getEntityDefinitionLibrary(),
-		defaultPalette);
+	// Late-latch the view direction. Mouse motion that arrived while the game world was ticking
+	// is applied to this frame's camera only; the player catches up with it next tick.
+	Double3 cameraDirection = player.getDirection();
+	if (!this->paused)
+	{
+		const Int2 lateMouseDelta = game.getInputManager().latchMouseDelta();
+		const std::optional<Double2> lateLookDelta = this->getMouseLookDelta(lateMouseDelta);
+		if (lateLookDelta.has_value())
+		{
+			cameraDirection = player.getRotatedDirection(lateLookDelta->x, lateLookDelta->y,
+				options.getInput_HorizontalSensitivity(), options.getInput_VerticalSensitivity(),
+				options.getInput_CameraPitchLimit());
+		}
+	}
+
+	EntityManager &entityManager = level.getEntityManager();
+	WorldFrameView worldFrameView;
+	worldFrameView.eye = player.getPosition();
+	worldFrameView.direction = cameraDirection;
+	worldFrameView.fovY = options.getGraphics_VerticalFOV();
+	worldFrameView.chunkDistance = options.getMisc_ChunkDistance();
+	worldFrameView.entityCount = entityManager.getTotalCount();
+	worldFrameView.playerHasLight = options.getMisc_PlayerHasLight();
+
+	// Nothing in the world changes while paused, so the last frame can be shown again as long as
+	// the view is the same and the renderer hasn't been resized or changed.
+	const bool canRedrawWorld = this->paused && renderer.hasWorldFrame() &&
+		this->worldFrameView.has_value() && this->worldFrameView->equals(worldFrameView);
+
+	if (canRedrawWorld)
+	{
+		renderer.redrawWorld();
+	}
+	else
+	{
+		// Calculate entity visibility once for this frame's view. The renderer and any ray casts
+		// before the next tick reuse it.
+		const CoordDouble3 &playerPosition = player.getPosition();
+		const CoordDouble2 playerPositionXZ(playerPosition.chunk,
+			VoxelDouble2(playerPosition.point.x, playerPosition.point.z));
+		FrameTimings &frameTimings = game.getFrameTimings();
+		const FrameTimings::TimePoint visibilityStartTime = FrameTimings::now();
+		entityManager.updateVisibilityCache(playerPositionXZ, worldFrameView.chunkDistance,
+			level.getCeilingHeight(), level.getVoxelGrid(), game.getEntityDefinitionLibrary());
+		frameTimings.addStageTime(FrameTimings::Stage::Visibility, visibilityStartTime);
+
+		// Clicks can pick entities and voxels from the frame if the hit buffer is on.
+		renderer.setHitBufferActive(options.getInput_PickFromFrame());
+		renderer.renderWorld(worldFrameView.eye, worldFrameView.direction, worldFrameView.fovY,
+			ambientPercent, gameData.getDaytimePercent(), gameData.getChasmAnimPercent(), latitude,
+			gameData.nightLightsAreActive(), isExterior, worldFrameView.playerHasLight,
+			worldFrameView.chunkDistance, level.getCeilingHeight(), level, game.getEntityDefinitionLibrary(),
+			defaultPalette);
+
+		const Renderer::ProfilerData &rendererProfilerData = renderer.getProfilerData();
+		frameTimings.addStageTime(FrameTimings::Stage::RenderSky, rendererProfilerData.skyTime);
+		frameTimings.addStageTime(FrameTimings::Stage::RenderVoxels, rendererProfilerData.voxelTime);
+		frameTimings.addStageTime(FrameTimings::Stage::RenderPlanes, rendererProfilerData.planeTime);
+		frameTimings.addStageTime(FrameTimings::Stage::RenderFlats, rendererProfilerData.flatTime);
+
+		this->worldFrameView = worldFrameView;
+	}
 
 	const TextureBuilderID gameWorldInterfaceTextureBuilderID =
 		GameWorldPanel::getGameWorldInterfaceTextureBuilderID(textureManager);
@@ -3435,7 +3754,7 @@ void GameWorldPanel::renderSecondary(Renderer &renderer)
 
 	// @temp: keep until 3D-DDA ray casting is fully correct (i.e. entire ground is red dots for
 	// levels where ceilingHeight < 1.0, and same with ceiling blue dots).
-	if (profilerLevel == Options::MAX_PROFILER_LEVEL)
+	if (profilerLevel >= 3)
 	{
 		DEBUG_PhysicsRaycast(this->getGame(), renderer);
 	}	
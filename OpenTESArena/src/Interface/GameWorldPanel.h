@@ -2,11 +2,13 @@
 #define GAME_WORLD_PANEL_H
 
 #include <array>
+#include <optional>
 #include <vector>
 
 #include "Button.h"
 #include "Panel.h"
 #include "TextBox.h"
+#include "../Game/ClockEventScheduler.h"
 #include "../Game/Physics.h"
 #include "../Math/Rect.h"
 #include "../Media/TextureUtils.h"
@@ -26,6 +28,20 @@ class TextureManager;
 class GameWorldPanel : public Panel
 {
 private:
+	// Camera and settings the most recent 3D frame was rendered with. Nothing in the world ticks
+	// while paused, so the frame is redrawn as-is until one of these changes.
+	struct WorldFrameView
+	{
+		CoordDouble3 eye;
+		Double3 direction;
+		double fovY;
+		int chunkDistance;
+		int entityCount;
+		bool playerHasLight;
+
+		bool equals(const WorldFrameView &other) const;
+	};
+
 	std::unique_ptr<TextBox> playerNameTextBox;
 	Button<Game&> characterSheetButton, statusButton,
 		logbookButton, pauseButton;
@@ -35,6 +51,11 @@ private:
 	Button<Game&, bool> mapButton;
 	std::array<Rect, 9> nativeCursorRegions;
 	std::vector<Int2> weaponOffsets;
+	std::vector<ClockEventScheduler::EventID> clockEventIDs;
+	bool paused; // True while a sub-panel is on top.
+	std::optional<WorldFrameView> worldFrameView;
+	Texture profilerGraphTexture; // Streaming texture for per-stage frame times.
+	std::vector<std::unique_ptr<TextBox>> profilerLegendTextBoxes;
 
 	// Helper functions for various UI textures.
 	static TextureBuilderID getGameWorldInterfaceTextureBuilderID(TextureManager &textureManager);
@@ -52,6 +73,10 @@ private:
 	// Sets whether to change the mouse input for modern mode.
 	void setFreeLookActive(bool active);
 
+	// Converts relative mouse motion to camera rotation for modern mode, or returns nothing if
+	// the mouse isn't currently controlling the camera.
+	std::optional<Double2> getMouseLookDelta(const Int2 &mouseDelta) const;
+
 	// Handles input for the player camera.
 	void handlePlayerTurning(double dt, const Int2 &mouseDelta);
 
@@ -69,6 +94,9 @@ private:
 	// Handles changing night-light-related things on and off.
 	void handleNightLightChange(bool active);
 
+	// Handles switching between day and night music in exteriors.
+	void handleExteriorMusicChange(bool night);
+
 	// Sends an "on voxel enter" message for the given voxel and triggers any text or
 	// sound events.
 	void handleTriggers(const NewInt2 &voxel);
@@ -93,6 +121,9 @@ private:
 
 	// Draws some debug profiler text.
 	void drawProfiler(int profilerLevel, Renderer &renderer);
+
+	// Draws a stacked graph of recent frame times split by frame stage.
+	void drawProfilerGraph(Renderer &renderer);
 public:
 	// Constructs the game world panel. The GameData object in Game must be initialized.
 	GameWorldPanel(Game &game);
@@ -238,6 +238,7 @@ const std::string OptionsPanel::HORIZONTAL_SENSITIVITY_NAME = "Horizontal Sensit
 const std::string OptionsPanel::VERTICAL_SENSITIVITY_NAME = "Vertical Sensitivity";
 const std::string OptionsPanel::CAMERA_PITCH_LIMIT_NAME = "Camera Pitch Limit";
 const std::string OptionsPanel::PIXEL_PERFECT_SELECTION_NAME = "Pixel-Perfect Selection";
+const std::string OptionsPanel::PICK_FROM_FRAME_NAME = "Pick From Frame";
 
 // Misc.
 const std::string OptionsPanel::SHOW_COMPASS_NAME = "Show Compass";
@@ -626,6 +627,17 @@ OptionsPanel::OptionsPanel(Game &game)
 		options.setInput_PixelPerfectSelection(value);
 	}));
 
+	this->inputOptions.push_back(std::make_unique<BoolOption>(
+		OptionsPanel::PICK_FROM_FRAME_NAME,
+		"Looks up clicked entities and voxels in the last drawn frame\ninstead of ray casting, if enabled.",
+		options.getInput_PickFromFrame(),
+		[this](bool value)
+	{
+		auto &game = this->getGame();
+		auto &options = game.getOptions();
+		options.setInput_PickFromFrame(value);
+	}));
+
 	// Create miscellaneous options.
 	this->miscOptions.push_back(std::make_unique<BoolOption>(
 		OptionsPanel::SHOW_COMPASS_NAME,
@@ -154,6 +154,7 @@ private:
 	static const std::string VERTICAL_SENSITIVITY_NAME;
 	static const std::string CAMERA_PITCH_LIMIT_NAME;
 	static const std::string PIXEL_PERFECT_SELECTION_NAME;
+	static const std::string PICK_FROM_FRAME_NAME;
 
 	// Misc.
 	static const std::string SHOW_COMPASS_NAME;
@@ -1,6 +1,9 @@
 #include <algorithm>
 
 #include "TextureBuilder.h"
+#include "../Assets/Compression.h"
+
+#include "components/debug/Debug.h"
 
 void TextureBuilder::PalettedTexture::init(int width, int height, const uint8_t *texels)
 {
@@ -17,65 +20,179 @@ void TextureBuilder::TrueColorTexture::init(int width, int height, const uint32_
 TextureBuilder::TextureBuilder()
 {
 	this->type = static_cast<TextureBuilder::Type>(-1);
+	this->width = 0;
+	this->height = 0;
+	this->compressed = false;
 }
 
 void TextureBuilder::initPaletted(int width, int height, const uint8_t *texels)
 {
 	this->type = TextureBuilder::Type::Paletted;
+	this->width = width;
+	this->height = height;
 	this->paletteTexture.init(width, height, texels);
+	this->compressedTexels.clear();
+	this->compressed = false;
+	this->deferredTexelsFunc = nullptr;
 }
 
 void TextureBuilder::initTrueColor(int width, int height, const uint32_t *texels)
 {
 	this->type = TextureBuilder::Type::TrueColor;
+	this->width = width;
+	this->height = height;
 	this->trueColorTexture.init(width, height, texels);
+	this->compressedTexels.clear();
+	this->compressed = false;
+	this->deferredTexelsFunc = nullptr;
+}
+
+void TextureBuilder::initPalettedDeferred(int width, int height, PalettedTexelsFunc &&texelsFunc)
+{
+	DebugAssert(texelsFunc != nullptr);
+	this->type = TextureBuilder::Type::Paletted;
+	this->width = width;
+	this->height = height;
+	this->paletteTexture.texels.clear();
+	this->compressedTexels.clear();
+	this->compressed = false;
+	this->deferredTexelsFunc = std::move(texelsFunc);
 }
 
 int TextureBuilder::getWidth() const
 {
+	return this->width;
+}
+
+int TextureBuilder::getHeight() const
+{
+	return this->height;
+}
+
+TextureBuilder::Type TextureBuilder::getType() const
+{
+	return this->type;
+}
+
+const TextureBuilder::PalettedTexture &TextureBuilder::getPaletted() const
+{
+	DebugAssert(this->type == TextureBuilder::Type::Paletted);
+	DebugAssert(!this->compressed);
+	DebugAssert(!this->isDeferred());
+	return this->paletteTexture;
+}
+
+const TextureBuilder::TrueColorTexture &TextureBuilder::getTrueColor() const
+{
+	DebugAssert(this->type == TextureBuilder::Type::TrueColor);
+	DebugAssert(!this->compressed);
+	return this->trueColorTexture;
+}
+
+bool TextureBuilder::isCompressed() const
+{
+	return this->compressed;
+}
+
+bool TextureBuilder::isDeferred() const
+{
+	return this->deferredTexelsFunc != nullptr;
+}
+
+int TextureBuilder::getExpandedByteCount() const
+{
+	if (this->compressed || this->isDeferred())
+	{
+		return 0;
+	}
+
 	if (this->type == TextureBuilder::Type::Paletted)
 	{
-		return this->paletteTexture.texels.getWidth();
+		return this->width * this->height * static_cast<int>(sizeof(uint8_t));
 	}
 	else if (this->type == TextureBuilder::Type::TrueColor)
 	{
-		return this->trueColorTexture.texels.getWidth();
+		return this->width * this->height * static_cast<int>(sizeof(uint32_t));
 	}
 	else
 	{
-		DebugUnhandledReturnMsg(int, std::to_string(static_cast<int>(this->type)));
+		return 0;
 	}
 }
 
-int TextureBuilder::getHeight() const
+int TextureBuilder::getCompressedByteCount() const
+{
+	return static_cast<int>(this->compressedTexels.size());
+}
+
+void TextureBuilder::compress()
 {
+	DebugAssert(!this->compressed);
+	DebugAssert(!this->isDeferred());
+
+	const int texelCount = this->width * this->height;
 	if (this->type == TextureBuilder::Type::Paletted)
 	{
-		return this->paletteTexture.texels.getHeight();
+		const uint8_t *texels = this->paletteTexture.texels.get();
+		Compression::encodeLZ4(texels, texelCount * static_cast<int>(sizeof(uint8_t)),
+			this->compressedTexels);
+
+		this->paletteTexture.texels.clear();
 	}
 	else if (this->type == TextureBuilder::Type::TrueColor)
 	{
-		return this->trueColorTexture.texels.getHeight();
+		const uint8_t *texels = reinterpret_cast<const uint8_t*>(this->trueColorTexture.texels.get());
+		Compression::encodeLZ4(texels, texelCount * static_cast<int>(sizeof(uint32_t)),
+			this->compressedTexels);
+
+		this->trueColorTexture.texels.clear();
 	}
 	else
 	{
-		DebugUnhandledReturnMsg(int, std::to_string(static_cast<int>(this->type)));
+		DebugNotImplementedMsg(std::to_string(static_cast<int>(this->type)));
 	}
+
+	this->compressedTexels.shrink_to_fit();
+	this->compressed = true;
 }
 
-TextureBuilder::Type TextureBuilder::getType() const
+void TextureBuilder::expand()
 {
-	return this->type;
+	DebugAssert(this->compressed);
+
+	const int texelCount = this->width * this->height;
+	const uint8_t *src = this->compressedTexels.data();
+	const int srcSize = static_cast<int>(this->compressedTexels.size());
+	if (this->type == TextureBuilder::Type::Paletted)
+	{
+		Buffer2D<uint8_t> &texels = this->paletteTexture.texels;
+		texels.init(this->width, this->height);
+		Compression::decodeLZ4(src, srcSize, texels.get(), texelCount * static_cast<int>(sizeof(uint8_t)));
+	}
+	else if (this->type == TextureBuilder::Type::TrueColor)
+	{
+		Buffer2D<uint32_t> &texels = this->trueColorTexture.texels;
+		texels.init(this->width, this->height);
+		Compression::decodeLZ4(src, srcSize, reinterpret_cast<uint8_t*>(texels.get()),
+			texelCount * static_cast<int>(sizeof(uint32_t)));
+	}
+	else
+	{
+		DebugNotImplementedMsg(std::to_string(static_cast<int>(this->type)));
+	}
+
+	this->compressedTexels.clear();
+	this->compressedTexels.shrink_to_fit();
+	this->compressed = false;
 }
 
-const TextureBuilder::PalettedTexture &TextureBuilder::getPaletted() const
+void TextureBuilder::resolve()
 {
+	DebugAssert(this->isDeferred());
 	DebugAssert(this->type == TextureBuilder::Type::Paletted);
-	return this->paletteTexture;
-}
 
-const TextureBuilder::TrueColorTexture &TextureBuilder::getTrueColor() const
-{
-	DebugAssert(this->type == TextureBuilder::Type::TrueColor);
-	return this->trueColorTexture;
+	Buffer2D<uint8_t> &texels = this->paletteTexture.texels;
+	texels.init(this->width, this->height);
+	this->deferredTexelsFunc(texels.get());
+	this->deferredTexelsFunc = nullptr;
 }
@@ -2,6 +2,8 @@
 #define TEXTURE_BUILDER_H
 
 #include <cstdint>
+#include <functional>
+#include <vector>
 
 #include "components/utilities/Buffer2D.h"
 
@@ -29,21 +31,57 @@ public:
 
 		void init(int width, int height, const uint32_t *texels);
 	};
+
+	// Writes paletted texels into a width * height buffer.
+	using PalettedTexelsFunc = std::function<void(uint8_t *dst)>;
 private:
 	Type type;
+	int width, height;
 	PalettedTexture paletteTexture;
 	TrueColorTexture trueColorTexture;
+
+	// Texels in compressed form. Only held while the expanded texels are freed, so a builder never
+	// uses more memory than it did before compression.
+	std::vector<uint8_t> compressedTexels;
+	bool compressed;
+
+	// Decodes the texels on first access, for files whose images can be decoded one at a time.
+	PalettedTexelsFunc deferredTexelsFunc;
 public:
 	TextureBuilder();
 
 	void initPaletted(int width, int height, const uint8_t *texels);
 	void initTrueColor(int width, int height, const uint32_t *texels);
 
+	// Initializes a paletted texture whose texels aren't decoded until it's resolved.
+	void initPalettedDeferred(int width, int height, PalettedTexelsFunc &&texelsFunc);
+
 	int getWidth() const;
 	int getHeight() const;
 	Type getType() const;
+
+	// Texel accessors. The builder must not be compressed or deferred.
 	const PalettedTexture &getPaletted() const;
 	const TrueColorTexture &getTrueColor() const;
+
+	// Whether the texels are only held in compressed form.
+	bool isCompressed() const;
+
+	// Whether the texels haven't been decoded yet.
+	bool isDeferred() const;
+
+	// Bytes used by expanded texels or by compressed texels, whichever form the builder is in.
+	int getExpandedByteCount() const;
+	int getCompressedByteCount() const;
+
+	// Replaces the expanded texels with a compressed copy.
+	void compress();
+
+	// Restores the expanded texels and frees the compressed copy.
+	void expand();
+
+	// Decodes deferred texels and frees the decoder.
+	void resolve();
 };
 
 #endif
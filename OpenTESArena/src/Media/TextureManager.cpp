@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <memory>
+
 #include "SDL.h"
 
 #include "TextureManager.h"
@@ -26,6 +29,13 @@ namespace
 	constexpr const char *EXTENSION_BMP = "BMP";
 }
 
+TextureManager::TextureManager()
+{
+	this->expandedTextureBuilderByteCount = 0;
+	this->compressedTextureBuilderByteCount = 0;
+	this->frameIndex = 0;
+}
+
 bool TextureManager::matchesExtension(const char *filename, const char *extension)
 {
 	return StringView::caseInsensitiveEquals(StringView::getExtension(filename), extension);
@@ -125,17 +135,21 @@ bool TextureManager::tryLoadTextureBuilders(const char *filename, Buffer<Texture
 	}
 	else if (TextureManager::matchesExtension(filename, ArenaAssetUtils::EXTENSION_CFA))
 	{
-		CFAFile cfa;
-		if (!cfa.init(filename))
+		auto cfa = std::make_shared<CFAFile>();
+		if (!cfa->init(filename))
 		{
 			DebugLogWarning("Couldn't init .CFA file \"" + std::string(filename) + "\".");
 			return false;
 		}
 
-		outTextures->init(cfa.getImageCount());
-		for (int i = 0; i < cfa.getImageCount(); i++)
+		// Creature animations have many frames that are never seen, so each one is decoded on first
+		// access. The file is freed once every frame has been decoded.
+		outTextures->init(cfa->getImageCount());
+		for (int i = 0; i < cfa->getImageCount(); i++)
 		{
-			TextureBuilder textureBuilder = makePaletted(cfa.getWidth(), cfa.getHeight(), cfa.getPixels(i));
+			TextureBuilder textureBuilder;
+			textureBuilder.initPalettedDeferred(cfa->getWidth(), cfa->getHeight(),
+				[cfa, i](uint8_t *dst) { cfa->decodePixels(i, dst); });
 			outTextures->set(i, std::move(textureBuilder));
 		}
 	}
@@ -278,8 +292,10 @@ std::optional<TextureFileMetadata> TextureManager::tryGetMetadata(const char *fi
 		Buffer<std::pair<int, int>> dimensions(ids->getCount());
 		for (int i = 0; i < ids->getCount(); i++)
 		{
+			// Dimensions are known without decoding or expanding the texels.
 			const TextureBuilderID id = ids->getID(i);
-			const TextureBuilder &textureBuilder = this->getTextureBuilderHandle(id);
+			DebugAssertIndex(this->textureBuilders, id);
+			const TextureBuilder &textureBuilder = this->textureBuilders[id];
 			dimensions.set(i, std::make_pair(textureBuilder.getWidth(), textureBuilder.getHeight()));
 		}
 
@@ -379,7 +395,10 @@ std::optional<TextureBuilderIdGroup> TextureManager::tryGetTextureBuilderIDs(con
 
 		for (int i = 0; i < textureBuilders.getCount(); i++)
 		{
-			this->textureBuilders.emplace_back(std::move(textureBuilders.get(i)));
+			TextureBuilder &textureBuilder = textureBuilders.get(i);
+			this->expandedTextureBuilderByteCount += textureBuilder.getExpandedByteCount();
+			this->textureBuilders.emplace_back(std::move(textureBuilder));
+			this->textureBuilderAccessFrames.emplace_back(this->frameIndex);
 		}
 
 		iter = this->textureBuilderIDs.emplace(
@@ -423,6 +442,7 @@ PaletteRef TextureManager::getPaletteRef(PaletteID id) const
 
 TextureBuilderRef TextureManager::getTextureBuilderRef(TextureBuilderID id) const
 {
+	this->touchTextureBuilder(id);
 	return TextureBuilderRef(&this->textureBuilders, static_cast<int>(id));
 }
 
@@ -435,5 +455,88 @@ const Palette &TextureManager::getPaletteHandle(PaletteID id) const
 const TextureBuilder &TextureManager::getTextureBuilderHandle(TextureBuilderID id) const
 {
 	DebugAssertIndex(this->textureBuilders, id);
+	this->touchTextureBuilder(id);
 	return this->textureBuilders[id];
 }
+
+void TextureManager::touchTextureBuilder(TextureBuilderID id) const
+{
+	DebugAssertIndex(this->textureBuilders, id);
+	TextureBuilder &textureBuilder = this->textureBuilders[id];
+	if (textureBuilder.isCompressed())
+	{
+		this->compressedTextureBuilderByteCount -= textureBuilder.getCompressedByteCount();
+		textureBuilder.expand();
+		this->expandedTextureBuilderByteCount += textureBuilder.getExpandedByteCount();
+	}
+	else if (textureBuilder.isDeferred())
+	{
+		textureBuilder.resolve();
+		this->expandedTextureBuilderByteCount += textureBuilder.getExpandedByteCount();
+	}
+
+	this->textureBuilderAccessFrames[id] = this->frameIndex;
+}
+
+void TextureManager::compressColdTextureBuilders()
+{
+	const bool isOverBudget =
+		this->expandedTextureBuilderByteCount > TextureManager::EXPANDED_TEXTURE_BUILDER_BYTE_BUDGET;
+	const bool isCheckFrame = (this->frameIndex % TextureManager::COLD_TEXTURE_BUILDER_CHECK_FRAMES) == 0;
+	if (!isOverBudget && !isCheckFrame)
+	{
+		this->frameIndex++;
+		return;
+	}
+
+	// Candidates are expanded builders that weren't used last frame, oldest first. Deferred ones have
+	// nothing to compress yet.
+	std::vector<int> candidates;
+	for (int i = 0; i < static_cast<int>(this->textureBuilders.size()); i++)
+	{
+		const TextureBuilder &textureBuilder = this->textureBuilders[i];
+		if (!textureBuilder.isCompressed() && !textureBuilder.isDeferred() &&
+			(this->textureBuilderAccessFrames[i] < this->frameIndex))
+		{
+			candidates.emplace_back(i);
+		}
+	}
+
+	std::sort(candidates.begin(), candidates.end(),
+		[this](int a, int b)
+	{
+		return this->textureBuilderAccessFrames[a] < this->textureBuilderAccessFrames[b];
+	});
+
+	for (const int index : candidates)
+	{
+		const int idleFrames = this->frameIndex - this->textureBuilderAccessFrames[index];
+		const bool isCold = idleFrames >= TextureManager::COLD_TEXTURE_BUILDER_FRAMES;
+		const bool isStillOverBudget =
+			this->expandedTextureBuilderByteCount > TextureManager::EXPANDED_TEXTURE_BUILDER_BYTE_BUDGET;
+		if (!isCold && !isStillOverBudget)
+		{
+			// The rest were used more recently.
+			break;
+		}
+
+		TextureBuilder &textureBuilder = this->textureBuilders[index];
+		const int expandedByteCount = textureBuilder.getExpandedByteCount();
+		textureBuilder.compress();
+
+		this->expandedTextureBuilderByteCount -= expandedByteCount;
+		this->compressedTextureBuilderByteCount += textureBuilder.getCompressedByteCount();
+	}
+
+	this->frameIndex++;
+}
+
+int64_t TextureManager::getExpandedTextureBuilderByteCount() const
+{
+	return this->expandedTextureBuilderByteCount;
+}
+
+int64_t TextureManager::getCompressedTextureBuilderByteCount() const
+{
+	return this->compressedTextureBuilderByteCount;
+}
@@ -31,10 +31,26 @@ private:
 	std::unordered_map<std::string, PaletteIdGroup> paletteIDs;
 	std::unordered_map<std::string, TextureBuilderIdGroup> textureBuilderIDs;
 
+	// Texture builders not accessed for this many frames are compressed in memory.
+	static constexpr int COLD_TEXTURE_BUILDER_FRAMES = 300;
+
+	// How often to look for cold texture builders when under budget.
+	static constexpr int COLD_TEXTURE_BUILDER_CHECK_FRAMES = 60;
+
+	// Expanded texture builder bytes allowed before recently-used ones are compressed too.
+	static constexpr int64_t EXPANDED_TEXTURE_BUILDER_BYTE_BUDGET = 32 * 1024 * 1024;
+
 	// Texture data for each type. Any groups of textures from the same filename are stored contiguously
-	// in the order they appear in the file.
+	// in the order they appear in the file. Texture builders are mutable so cold ones can be expanded
+	// again on access.
 	std::vector<Palette> palettes;
-	std::vector<TextureBuilder> textureBuilders;
+	mutable std::vector<TextureBuilder> textureBuilders;
+
+	// Frame each texture builder was last accessed in, for finding cold ones.
+	mutable std::vector<int> textureBuilderAccessFrames;
+
+	mutable int64_t expandedTextureBuilderByteCount, compressedTextureBuilderByteCount;
+	int frameIndex;
 
 	// Returns whether the given filename has the given extension.
 	static bool matchesExtension(const char *filename, const char *extension);
@@ -42,7 +58,12 @@ private:
 	// Helper functions for loading texture files.
 	static bool tryLoadPalettes(const char *filename, Buffer<Palette> *outPalettes);
 	static bool tryLoadTextureBuilders(const char *filename, Buffer<TextureBuilder> *outTextures);
+
+	// Expands the texture builder if it's compressed and marks it as used this frame.
+	void touchTextureBuilder(TextureBuilderID id) const;
 public:
+	TextureManager();
+
 	// Returns metadata about a texture file if it exists and is valid.
 	std::optional<TextureFileMetadata> tryGetMetadata(const char *filename);
 
@@ -66,6 +87,15 @@ public:
 	// Texture getter functions, fast look-up. These do not protect against dangling pointers.
 	const Palette &getPaletteHandle(PaletteID id) const;
 	const TextureBuilder &getTextureBuilderHandle(TextureBuilderID id) const;
+
+	// Compresses texture builders that haven't been used recently, and the least recently used
+	// ones if over budget. Must be called once per frame while no texture builder references
+	// are held.
+	void compressColdTextureBuilders();
+
+	// Bytes held by expanded texture builder texels and by compressed copies.
+	int64_t getExpandedTextureBuilderByteCount() const;
+	int64_t getCompressedTextureBuilderByteCount() const;
 };
 
 #endif
@@ -39,11 +39,27 @@ Renderer::ProfilerData::ProfilerData()
 	this->potentiallyVisFlatCount = -1;
 	this->visFlatCount = -1;
 	this->visLightCount = -1;
+	this->voxelRayStepCount = -1;
+	this->skippedVoxelRayStepCount = -1;
 	this->frameTime = 0.0;
+	this->bufferWaitTime = 0.0;
+	this->skyTime = 0.0;
+	this->voxelTime = 0.0;
+	this->planeTime = 0.0;
+	this->flatTime = 0.0;
+	this->textureHitCount = -1;
+	this->textureMissCount = -1;
+	this->textureConversionTime = 0.0;
+	this->residentTextureBytes = 0;
+	this->culledFlatCount = -1;
+	this->culledLightCount = -1;
 }
 
 void Renderer::ProfilerData::init(int width, int height, int threadCount, int potentiallyVisFlatCount,
-	int visFlatCount, int visLightCount, double frameTime)
+	int visFlatCount, int visLightCount, int voxelRayStepCount, int skippedVoxelRayStepCount,
+	double frameTime, double bufferWaitTime, double skyTime, double voxelTime, double planeTime,
+	double flatTime, int textureHitCount, int textureMissCount, double textureConversionTime,
+	size_t residentTextureBytes, int culledFlatCount, int culledLightCount)
 {
 	this->width = width;
 	this->height = height;
@@ -51,7 +67,20 @@ void Renderer::ProfilerData::init(int width, int height, int threadCount, int po
 	this->potentiallyVisFlatCount = potentiallyVisFlatCount;
 	this->visFlatCount = visFlatCount;
 	this->visLightCount = visLightCount;
+	this->voxelRayStepCount = voxelRayStepCount;
+	this->skippedVoxelRayStepCount = skippedVoxelRayStepCount;
 	this->frameTime = frameTime;
+	this->bufferWaitTime = bufferWaitTime;
+	this->skyTime = skyTime;
+	this->voxelTime = voxelTime;
+	this->planeTime = planeTime;
+	this->flatTime = flatTime;
+	this->textureHitCount = textureHitCount;
+	this->textureMissCount = textureMissCount;
+	this->textureConversionTime = textureConversionTime;
+	this->residentTextureBytes = residentTextureBytes;
+	this->culledFlatCount = culledFlatCount;
+	this->culledLightCount = culledLightCount;
 }
 
 void Renderer::TextureInstance::init(TextureBuilderID textureBuilderID, PaletteID paletteID, Texture &&texture)
@@ -69,9 +98,13 @@ const uint32_t Renderer::DEFAULT_PIXELFORMAT = SDL_PIXELFORMAT_ARGB8888;
 Renderer::Renderer()
 {
 	DebugAssert(this->nativeTexture.get() == nullptr);
-	DebugAssert(this->gameWorldTexture.get() == nullptr);
+	DebugAssert(this->gameWorldTextures[0].get() == nullptr);
 	this->window = nullptr;
 	this->renderer = nullptr;
+	this->gameWorldTextureIndex = 0;
+	this->gameWorldTextureIsCurrent = false;
+	this->hitBufferActive = false;
+	this->hitBufferIsCurrent = false;
 	this->letterboxMode = 0;
 	this->fullGameWindow = false;
 }
@@ -391,6 +424,40 @@ const Renderer::ProfilerData &Renderer::getProfilerData() const
 	return this->profilerData;
 }
 
+bool Renderer::hasWorldFrame() const
+{
+	return this->gameWorldTextureIsCurrent;
+}
+
+bool Renderer::hasHitBuffer() const
+{
+	return this->gameWorldTextureIsCurrent && this->hitBufferIsCurrent;
+}
+
+bool Renderer::tryGetEntityHit(const Int2 &nativePoint, EntityID *outID, int *outGeneration,
+	double *outDepth) const
+{
+	int x, y;
+	if (!this->tryGetHitBufferPixel(nativePoint, &x, &y))
+	{
+		return false;
+	}
+
+	return this->renderer3D->tryGetEntityHit(x, y, outID, outGeneration, outDepth);
+}
+
+bool Renderer::tryGetVoxelHit(const Int2 &nativePoint, NewInt3 *outVoxel,
+	std::optional<VoxelFacing3D> *outFacing, double *outDepth) const
+{
+	int x, y;
+	if (!this->tryGetHitBufferPixel(nativePoint, &x, &y))
+	{
+		return false;
+	}
+
+	return this->renderer3D->tryGetVoxelHit(x, y, outVoxel, outFacing, outDepth);
+}
+
 bool Renderer::getEntityRayIntersection(const EntityManager::EntityVisibilityData &visData,
 	const Double3 &entityForward, const Double3 &entityRight, const Double3 &entityUp,
 	double entityWidth, double entityHeight, const Double3 &rayPoint, const Double3 &rayDirection,
@@ -656,8 +723,8 @@ bool Renderer::init(int width, int height, WindowMode windowMode, int letterboxM
 		}
 	}();
 
-	// Don't initialize the game world buffer until the 3D renderer is initialized.
-	DebugAssert(this->gameWorldTexture.get() == nullptr);
+	// Don't initialize the game world buffers until the 3D renderer is initialized.
+	DebugAssert(this->gameWorldTextures[0].get() == nullptr);
 	this->fullGameWindow = false;
 
 	return true;
@@ -690,16 +757,50 @@ void Renderer::resize(int width, int height, double resolutionScale, bool fullGa
 		const int renderWidth = Renderer::makeRendererDimension(width, resolutionScale);
 		const int renderHeight = Renderer::makeRendererDimension(viewHeight, resolutionScale);
 
-		// Reinitialize the game world frame buffer.
-		this->gameWorldTexture = this->createTexture(Renderer::DEFAULT_PIXELFORMAT,
-			SDL_TEXTUREACCESS_STREAMING, renderWidth, renderHeight);
-		DebugAssertMsg(this->gameWorldTexture.get() != nullptr,
-			"Couldn't recreate game world texture, " + std::string(SDL_GetError()));
+		// Reinitialize the game world frame buffers.
+		this->initGameWorldTextures(renderWidth, renderHeight);
 
 		this->renderer3D->resize(renderWidth, renderHeight);
 	}
 }
 
+void Renderer::initGameWorldTextures(int width, int height)
+{
+	for (Texture &texture : this->gameWorldTextures)
+	{
+		texture = this->createTexture(Renderer::DEFAULT_PIXELFORMAT,
+			SDL_TEXTUREACCESS_STREAMING, width, height);
+		DebugAssertMsg(texture.get() != nullptr,
+			"Couldn't create game world texture, " + std::string(SDL_GetError()));
+	}
+
+	this->gameWorldTextureIndex = 0;
+	this->gameWorldTextureIsCurrent = false;
+}
+
+bool Renderer::tryGetHitBufferPixel(const Int2 &nativePoint, int *outX, int *outY) const
+{
+	// Only the frame that's on screen can be picked from.
+	if (!this->hasHitBuffer())
+	{
+		return false;
+	}
+
+	const int viewWidth = this->getWindowDimensions().x;
+	const int viewHeight = this->getViewHeight();
+	if ((nativePoint.x < 0) || (nativePoint.x >= viewWidth) ||
+		(nativePoint.y < 0) || (nativePoint.y >= viewHeight))
+	{
+		return false;
+	}
+
+	// The game world might be rendered at a lower resolution than the window.
+	const Texture &gameWorldTexture = this->gameWorldTextures[this->gameWorldTextureIndex];
+	*outX = (nativePoint.x * gameWorldTexture.getWidth()) / viewWidth;
+	*outY = (nativePoint.y * gameWorldTexture.getHeight()) / viewHeight;
+	return true;
+}
+
 void Renderer::setLetterboxMode(int letterboxMode)
 {
 	this->letterboxMode = letterboxMode;
@@ -763,11 +864,8 @@ void Renderer::initializeWorldRendering(double resolutionScale, bool fullGameWin
 	const int renderWidth = Renderer::makeRendererDimension(screenWidth, resolutionScale);
 	const int renderHeight = Renderer::makeRendererDimension(viewHeight, resolutionScale);
 
-	// Initialize a new game world frame buffer, removing any previous game world frame buffer.
-	this->gameWorldTexture = this->createTexture(Renderer::DEFAULT_PIXELFORMAT,
-		SDL_TEXTUREACCESS_STREAMING, renderWidth, renderHeight);
-	DebugAssertMsg(this->gameWorldTexture.get() != nullptr,
-		"Couldn't create game world texture, " + std::string(SDL_GetError()));
+	// Initialize new game world frame buffers, removing any previous ones.
+	this->initGameWorldTextures(renderWidth, renderHeight);
 
 	// Initialize 3D rendering.
 	RenderInitSettings initSettings;
@@ -824,6 +922,17 @@ void Renderer::freeUiTexture(const TextureAssetReference &textureAssetRef)
 void Renderer::setFogDistance(double fogDistance)
 {
 	this->renderer3D->setFogDistance(fogDistance);
+	this->gameWorldTextureIsCurrent = false;
+}
+
+void Renderer::setHitBufferActive(bool active)
+{
+	if (this->hitBufferActive != active)
+	{
+		this->renderer3D->setHitBufferActive(active);
+		this->hitBufferActive = active;
+		this->hitBufferIsCurrent = false;
+	}
 }
 
 EntityRenderID Renderer::makeEntityRenderID()
@@ -851,30 +960,35 @@ void Renderer::setDistantSky(const DistantSky &distantSky, const Palette &palett
 {
 	DebugAssert(this->renderer3D->isInited());
 	this->renderer3D->setDistantSky(distantSky, palette, textureManager);
+	this->gameWorldTextureIsCurrent = false;
 }
 
 void Renderer::setSkyPalette(const uint32_t *colors, int count)
 {
 	DebugAssert(this->renderer3D->isInited());
 	this->renderer3D->setSkyPalette(colors, count);
+	this->gameWorldTextureIsCurrent = false;
 }
 
 void Renderer::setNightLightsActive(bool active, const Palette &palette)
 {
 	DebugAssert(this->renderer3D->isInited());
 	this->renderer3D->setNightLightsActive(active, palette);
+	this->gameWorldTextureIsCurrent = false;
 }
 
 void Renderer::clearTexturesAndEntityRenderIDs()
 {
 	DebugAssert(this->renderer3D->isInited());
 	this->renderer3D->clearTexturesAndEntityRenderIDs();
+	this->gameWorldTextureIsCurrent = false;
 }
 
 void Renderer::clearDistantSky()
 {
 	DebugAssert(this->renderer3D->isInited());
 	this->renderer3D->clearDistantSky();
+	this->gameWorldTextureIsCurrent = false;
 }
 
 void Renderer::clear(const Color &color)
@@ -962,14 +1076,23 @@ void Renderer::renderWorld(const CoordDouble3 &eye, const Double3 &forward, doub
 	// The 3D renderer must be initialized.
 	DebugAssert(this->renderer3D->isInited());
 	
+	// Move to the next game world texture in the ring so the one drawn last frame can still be
+	// read by the GPU while this one is written.
+	this->gameWorldTextureIndex = (this->gameWorldTextureIndex + 1) % GAME_WORLD_TEXTURE_COUNT;
+	Texture &gameWorldTexture = this->gameWorldTextures[this->gameWorldTextureIndex];
+
 	// Lock the game world texture and give the pixel pointer to the software renderer.
 	// - Supposedly this is faster than SDL_UpdateTexture(). In any case, there's one
 	//   less frame buffer to take care of.
 	uint32_t *gameWorldPixels;
 	int gameWorldPitch;
-	int status = SDL_LockTexture(this->gameWorldTexture.get(), nullptr,
+	const auto lockStartTime = std::chrono::high_resolution_clock::now();
+	int status = SDL_LockTexture(gameWorldTexture.get(), nullptr,
 		reinterpret_cast<void**>(&gameWorldPixels), &gameWorldPitch);
+	const auto lockEndTime = std::chrono::high_resolution_clock::now();
 	DebugAssertMsg(status == 0, "Couldn't lock game world texture, " + std::string(SDL_GetError()));
+	const double bufferWaitTime = static_cast<double>((lockEndTime - lockStartTime).count()) /
+		static_cast<double>(std::nano::den);
 
 	// Render the game world to the game world frame buffer.
 	const auto startTime = std::chrono::high_resolution_clock::now();
@@ -983,15 +1106,32 @@ void Renderer::renderWorld(const CoordDouble3 &eye, const Double3 &forward, doub
 	const RendererSystem3D::ProfilerData swProfilerData = this->renderer3D->getProfilerData();
 	this->profilerData.init(swProfilerData.width, swProfilerData.height, swProfilerData.threadCount,
 		swProfilerData.potentiallyVisFlatCount, swProfilerData.visFlatCount, swProfilerData.visLightCount,
-		frameTime);
+		swProfilerData.voxelRayStepCount, swProfilerData.skippedVoxelRayStepCount, frameTime,
+		bufferWaitTime, swProfilerData.skyTime, swProfilerData.voxelTime, swProfilerData.planeTime,
+		swProfilerData.flatTime, swProfilerData.textureHitCount, swProfilerData.textureMissCount,
+		swProfilerData.textureConversionTime, swProfilerData.residentTextureBytes,
+		swProfilerData.culledFlatCount, swProfilerData.culledLightCount);
 
 	// Update the game world texture with the new ARGB8888 pixels.
-	SDL_UnlockTexture(this->gameWorldTexture.get());
+	SDL_UnlockTexture(gameWorldTexture.get());
+	this->gameWorldTextureIsCurrent = true;
+	this->hitBufferIsCurrent = this->hitBufferActive;
 
 	// Now copy to the native frame buffer (stretching if needed).
 	const int screenWidth = this->getWindowDimensions().x;
 	const int viewHeight = this->getViewHeight();
-	this->draw(this->gameWorldTexture, 0, 0, screenWidth, viewHeight);
+	this->draw(gameWorldTexture, 0, 0, screenWidth, viewHeight);
+}
+
+void Renderer::redrawWorld()
+{
+	DebugAssert(this->gameWorldTextureIsCurrent);
+
+	// The texture isn't written to, so there's no need to move along the ring.
+	const Texture &gameWorldTexture = this->gameWorldTextures[this->gameWorldTextureIndex];
+	const int screenWidth = this->getWindowDimensions().x;
+	const int viewHeight = this->getViewHeight();
+	this->draw(gameWorldTexture, 0, 0, screenWidth, viewHeight);
 }
 
 void Renderer::drawCursor(TextureBuilderID textureBuilderID, PaletteID paletteID, CursorAlignment alignment,
@@ -1,6 +1,7 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
+#include <array>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -64,12 +65,32 @@ public:
 		// Visible flats and lights.
 		int potentiallyVisFlatCount, visFlatCount, visLightCount;
 
+		// Voxel columns stepped through by ray casts, and how many were skipped as empty space.
+		int voxelRayStepCount, skippedVoxelRayStepCount;
+
 		double frameTime;
 
+		// Time spent waiting for a game world buffer to become writable.
+		double bufferWaitTime;
+
+		// Time spent in each group of 3D render stages.
+		double skyTime, voxelTime, planeTime, flatTime;
+
+		// Voxel and flat texture reuse and conversion since the last level transition.
+		int textureHitCount, textureMissCount;
+		double textureConversionTime;
+		size_t residentTextureBytes;
+
+		// Flats and lights skipped for being out of sight of the camera's part of the level.
+		int culledFlatCount, culledLightCount;
+
 		ProfilerData();
 
 		void init(int width, int height, int threadCount, int potentiallyVisFlatCount,
-			int visFlatCount, int visLightCount, double frameTime);
+			int visFlatCount, int visLightCount, int voxelRayStepCount, int skippedVoxelRayStepCount,
+			double frameTime, double bufferWaitTime, double skyTime, double voxelTime, double planeTime,
+			double flatTime, int textureHitCount, int textureMissCount, double textureConversionTime,
+			size_t residentTextureBytes, int culledFlatCount, int culledLightCount);
 	};
 private:
 	struct TextureInstance
@@ -84,13 +105,22 @@ private:
 	static const char *DEFAULT_RENDER_SCALE_QUALITY;
 	static const char *DEFAULT_TITLE;
 
+	// Number of game world frame buffers. The 3D renderer writes into one while the
+	// previous ones may still be in use by the GPU.
+	static constexpr int GAME_WORLD_TEXTURE_COUNT = 3;
+
 	std::unique_ptr<RendererSystem2D> renderer2D;
 	std::unique_ptr<RendererSystem3D> renderer3D;
 	std::vector<DisplayMode> displayModes;
 	std::vector<TextureInstance> textureInstances; // @temp placeholder until the renderer returns allocated texture handles.
 	SDL_Window *window;
 	SDL_Renderer *renderer;
-	Texture nativeTexture, gameWorldTexture; // Frame buffers.
+	Texture nativeTexture; // Frame buffer.
+	std::array<Texture, GAME_WORLD_TEXTURE_COUNT> gameWorldTextures; // Ring of 3D frame buffers.
+	int gameWorldTextureIndex; // Most recently written game world texture.
+	bool gameWorldTextureIsCurrent; // Whether the most recent game world texture can be redrawn as-is.
+	bool hitBufferActive; // Whether the 3D renderer writes per-pixel hit IDs.
+	bool hitBufferIsCurrent; // Whether the hit IDs match the most recent game world texture.
 	ProfilerData profilerData;
 	int letterboxMode; // Determines aspect ratio of the original UI (16:10, 4:3, etc.).
 	bool fullGameWindow; // Determines height of 3D frame buffer.
@@ -101,6 +131,13 @@ private:
 	// Generates a renderer dimension while avoiding pitfalls of numeric imprecision.
 	static int makeRendererDimension(int value, double resolutionScale);
 
+	// Recreates the ring of game world frame buffers with the given dimensions.
+	void initGameWorldTextures(int width, int height);
+
+	// Maps a native window point to a pixel of the most recent game world frame for the hit buffer.
+	// Returns false if the hit buffer is unavailable or the point is outside the game world view.
+	bool tryGetHitBufferPixel(const Int2 &nativePoint, int *outX, int *outY) const;
+
 	std::optional<int> tryGetTextureInstanceIndex(TextureBuilderID textureBuilderID, PaletteID paletteID) const;
 	void addTextureInstance(TextureBuilderID textureBuilderID, PaletteID paletteID, const TextureManager &textureManager);
 	const Texture *getOrAddTextureInstance(TextureBuilderID textureBuilderID, PaletteID paletteID,
@@ -143,6 +180,25 @@ public:
 	// Gets profiler data (timings, renderer properties, etc.).
 	const ProfilerData &getProfilerData() const;
 
+	// Whether the most recently rendered game world frame is still valid, i.e., the frame buffers
+	// haven't been resized and no 3D renderer state has changed since.
+	bool hasWorldFrame() const;
+
+	// Whether entities and voxels in the most recent game world frame can be picked by screen position.
+	bool hasHitBuffer() const;
+
+	// Gets the entity drawn at the given native window point in the most recent game world frame,
+	// its generation when drawn, and its distance from the camera in the XZ plane. Returns false if
+	// the hit buffer isn't active, the frame is out of date, or no entity covers the point.
+	bool tryGetEntityHit(const Int2 &nativePoint, EntityID *outID, int *outGeneration, double *outDepth) const;
+
+	// Gets the voxel drawn at the given native window point in the most recent game world frame,
+	// the face that was hit (empty if not axis-aligned), and its distance from the camera in the XZ
+	// plane. Returns false if the hit buffer isn't active, the frame is out of date, or no pickable
+	// voxel covers the point.
+	bool tryGetVoxelHit(const Int2 &nativePoint, NewInt3 *outVoxel, std::optional<VoxelFacing3D> *outFacing,
+		double *outDepth) const;
+
 	// Tests whether an entity is intersected by the given ray. Intended for ray cast selection.
 	// 'pixelPerfect' determines whether the entity's texture is involved in the calculation.
 	// Returns whether the entity was able to be tested and was hit by the ray. This is a renderer
@@ -225,6 +281,7 @@ public:
 
 	// Helper methods for changing data in the 3D renderer.
 	void setFogDistance(double fogDistance);
+	void setHitBufferActive(bool active);
 	EntityRenderID makeEntityRenderID();
 	void setFlatTextures(EntityRenderID entityRenderID, const EntityAnimationDefinition &animDef,
 		const EntityAnimationInstance &animInst, bool isPuddle, TextureManager &textureManager);
@@ -259,6 +316,10 @@ public:
 		int chunkDistance, double ceilingHeight, const LevelData &levelData,
 		const EntityDefinitionLibrary &entityDefLibrary, const Palette &palette);
 
+	// Draws the most recently rendered game world frame onto the native frame buffer again without
+	// running the 3D renderer (i.e., while the world is paused).
+	void redrawWorld();
+
 	// Draws the given cursor texture to the native frame buffer. The exact position 
 	// of the cursor is modified by the cursor alignment.
 	void drawCursor(TextureBuilderID textureBuilderID, PaletteID paletteID, CursorAlignment alignment,
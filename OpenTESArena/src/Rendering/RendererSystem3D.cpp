@@ -1,7 +1,10 @@
 #include "RendererSystem3D.h"
 
 RendererSystem3D::ProfilerData::ProfilerData(int width, int height, int threadCount, int potentiallyVisFlatCount,
-	int visFlatCount, int visLightCount)
+	int visFlatCount, int visLightCount, int voxelRayStepCount, int skippedVoxelRayStepCount,
+	double skyTime, double voxelTime, double planeTime, double flatTime, int textureHitCount,
+	int textureMissCount, double textureConversionTime, size_t residentTextureBytes,
+	int culledFlatCount, int culledLightCount)
 {
 	this->width = width;
 	this->height = height;
@@ -9,6 +12,18 @@ RendererSystem3D::ProfilerData::ProfilerData(int width, int height, int threadCo
 	this->potentiallyVisFlatCount = potentiallyVisFlatCount;
 	this->visFlatCount = visFlatCount;
 	this->visLightCount = visLightCount;
+	this->voxelRayStepCount = voxelRayStepCount;
+	this->skippedVoxelRayStepCount = skippedVoxelRayStepCount;
+	this->skyTime = skyTime;
+	this->voxelTime = voxelTime;
+	this->planeTime = planeTime;
+	this->flatTime = flatTime;
+	this->textureHitCount = textureHitCount;
+	this->textureMissCount = textureMissCount;
+	this->textureConversionTime = textureConversionTime;
+	this->residentTextureBytes = residentTextureBytes;
+	this->culledFlatCount = culledFlatCount;
+	this->culledLightCount = culledLightCount;
 }
 
 RendererSystem3D::~RendererSystem3D()
@@ -12,6 +12,8 @@
 #include "../Media/Palette.h"
 #include "../World/LevelData.h"
 #include "../World/VoxelDefinition.h"
+#include "../World/VoxelFacing3D.h"
+#include "../World/VoxelUtils.h"
 
 // Abstract base class for 3D renderer.
 
@@ -40,9 +42,25 @@ public:
 		int width, height;
 		int threadCount;
 		int potentiallyVisFlatCount, visFlatCount, visLightCount;
+		int voxelRayStepCount, skippedVoxelRayStepCount;
+
+		// Seconds until each render stage finished, relative to the previous stage.
+		double skyTime, voxelTime, planeTime, flatTime;
+
+		// Voxel and flat textures reused or converted since the last level transition, seconds
+		// spent converting them, and bytes of resident voxel and flat textures.
+		int textureHitCount, textureMissCount;
+		double textureConversionTime;
+		size_t residentTextureBytes;
+
+		// Flats and lights skipped for being out of sight of the camera's part of the level.
+		int culledFlatCount, culledLightCount;
 
 		ProfilerData(int width, int height, int threadCount, int potentiallyVisFlatCount,
-			int visFlatCount, int visLightCount);
+			int visFlatCount, int visLightCount, int voxelRayStepCount, int skippedVoxelRayStepCount,
+			double skyTime, double voxelTime, double planeTime, double flatTime, int textureHitCount,
+			int textureMissCount, double textureConversionTime, size_t residentTextureBytes,
+			int culledFlatCount, int culledLightCount);
 	};
 
 	virtual ~RendererSystem3D();
@@ -81,12 +99,23 @@ public:
 	virtual Double3 screenPointToRay(double xPercent, double yPercent, const Double3 &cameraDirection,
 		Degrees fovY, double aspect) const = 0;
 
+	// Tries to get the entity covering the given pixel in the most recent frame, using the hit
+	// buffer if it is active. The generation is the entity's when drawn, and the depth is its XZ
+	// distance from the camera.
+	virtual bool tryGetEntityHit(int x, int y, EntityID *outID, int *outGeneration, double *outDepth) const = 0;
+
+	// Tries to get the voxel covering the given pixel in the most recent frame, using the hit
+	// buffer if it is active. The facing is empty for faces that aren't axis-aligned.
+	virtual bool tryGetVoxelHit(int x, int y, NewInt3 *outVoxel, std::optional<VoxelFacing3D> *outFacing,
+		double *outDepth) const = 0;
+
 	// Gets various profiler information about internal renderer state.
 	virtual ProfilerData getProfilerData() const = 0;
 
 	// Legacy functions (remove these eventually).
 	virtual void setRenderThreadsMode(int mode) = 0;
 	virtual void setFogDistance(double fogDistance) = 0;
+	virtual void setHitBufferActive(bool active) = 0;
 	virtual EntityRenderID makeEntityRenderID() = 0;
 	virtual void setFlatTextures(EntityRenderID entityRenderID, const EntityAnimationDefinition &animDef,
 		const EntityAnimationInstance &animInst, bool isPuddle, TextureManager &textureManager) = 0;
@@ -1,9 +1,11 @@
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <emmintrin.h>
 #include <immintrin.h>
 #include <limits>
 #include <smmintrin.h>
+#include <tuple>
 
 #include "ArenaRenderUtils.h"
 #include "RendererUtils.h"
@@ -22,7 +24,9 @@
 #include "../Utilities/Platform.h"
 #include "../World/ArenaVoxelUtils.h"
 #include "../World/ChunkUtils.h"
+#include "../World/PotentiallyVisibleSet.h"
 #include "../World/VoxelFacing2D.h"
+#include "../World/VoxelFacing3D.h"
 #include "../World/VoxelGrid.h"
 #include "../World/VoxelUtils.h"
 
@@ -35,6 +39,72 @@ namespace
 	constexpr bool LightContributionCap = true;
 
 	constexpr double DEPTH_BUFFER_INFINITY = std::numeric_limits<double>::infinity();
+
+	// Hit buffer values. The low two bits are the hit type. Flats store their visible flat index
+	// above that, and voxels pack their face and coordinate. 0 means nothing pickable was drawn.
+	constexpr uint32_t HitTypeNone = 0;
+	constexpr uint32_t HitTypeVoxel = 1;
+	constexpr uint32_t HitTypeFlat = 2;
+	constexpr uint32_t HitTypeMask = 0x3;
+	constexpr int HitVoxelFacingShift = 2;
+	constexpr int HitVoxelXShift = 5;
+	constexpr int HitVoxelZShift = 17;
+	constexpr int HitVoxelYShift = 29;
+	constexpr uint32_t HitVoxelFacingMask = 0x7;
+	constexpr uint32_t HitVoxelXZMask = 0xFFF;
+	constexpr uint32_t HitVoxelYMask = 0x7;
+
+	// Gets the hit buffer value for a voxel face. Faces that don't line up with an axis (diagonals)
+	// are stored without a facing. Voxels too far out to pack are left to the ray cast.
+	uint32_t MakeVoxelHitID(const NewInt3 &voxel, const Double3 &normal)
+	{
+		const bool inRange = (voxel.x >= 0) && (static_cast<uint32_t>(voxel.x) <= HitVoxelXZMask) &&
+			(voxel.y >= 0) && (static_cast<uint32_t>(voxel.y) <= HitVoxelYMask) &&
+			(voxel.z >= 0) && (static_cast<uint32_t>(voxel.z) <= HitVoxelXZMask);
+		if (!inRange)
+		{
+			return HitTypeNone;
+		}
+
+		// Facing is stored as VoxelFacing3D + 1 so 0 can mean "no facing".
+		constexpr double axisThreshold = 0.99;
+		uint32_t facing = 0;
+		if (normal.x > axisThreshold)
+		{
+			facing = static_cast<uint32_t>(VoxelFacing3D::PositiveX) + 1;
+		}
+		else if (normal.x < -axisThreshold)
+		{
+			facing = static_cast<uint32_t>(VoxelFacing3D::NegativeX) + 1;
+		}
+		else if (normal.y > axisThreshold)
+		{
+			facing = static_cast<uint32_t>(VoxelFacing3D::PositiveY) + 1;
+		}
+		else if (normal.y < -axisThreshold)
+		{
+			facing = static_cast<uint32_t>(VoxelFacing3D::NegativeY) + 1;
+		}
+		else if (normal.z > axisThreshold)
+		{
+			facing = static_cast<uint32_t>(VoxelFacing3D::PositiveZ) + 1;
+		}
+		else if (normal.z < -axisThreshold)
+		{
+			facing = static_cast<uint32_t>(VoxelFacing3D::NegativeZ) + 1;
+		}
+
+		return HitTypeVoxel | (facing << HitVoxelFacingShift) |
+			(static_cast<uint32_t>(voxel.x) << HitVoxelXShift) |
+			(static_cast<uint32_t>(voxel.z) << HitVoxelZShift) |
+			(static_cast<uint32_t>(voxel.y) << HitVoxelYShift);
+	}
+
+	uint32_t MakeFlatHitID(int flatIndex)
+	{
+		constexpr int maxFlatIndex = static_cast<int>(std::numeric_limits<uint32_t>::max() >> 2);
+		return (flatIndex <= maxFlatIndex) ? (HitTypeFlat | (static_cast<uint32_t>(flatIndex) << 2)) : HitTypeNone;
+	}
 }
 
 void SoftwareRenderer::VoxelTexel::init(double r, double g, double b, double emission,
@@ -141,6 +211,11 @@ void SoftwareRenderer::VoxelTexture::setLightTexelsActive(bool active, const Pal
 	}
 }
 
+size_t SoftwareRenderer::VoxelTexture::getByteCount() const
+{
+	return (this->texels.size() * sizeof(VoxelTexel)) + (this->lightTexels.size() * sizeof(Int2));
+}
+
 SoftwareRenderer::FlatTexture::FlatTexture()
 {
 	this->width = 0;
@@ -172,6 +247,40 @@ void SoftwareRenderer::FlatTexture::init(int width, int height, const uint8_t *s
 			dstTexel.init(srcTexel);
 		}
 	}
+
+	// Find each column's opaque runs from top to bottom.
+	this->opaqueSpans.clear();
+	this->opaqueSpanOffsets.resize(width + 1);
+	for (int x = 0; x < width; x++)
+	{
+		this->opaqueSpanOffsets[x] = static_cast<int>(this->opaqueSpans.size());
+
+		int y = 0;
+		while (y < height)
+		{
+			if (this->texels[x + (y * width)].value == 0)
+			{
+				y++;
+				continue;
+			}
+
+			const int spanStart = y;
+			while ((y < height) && (this->texels[x + (y * width)].value != 0))
+			{
+				y++;
+			}
+
+			this->opaqueSpans.push_back(Int2(spanStart, y));
+		}
+	}
+
+	this->opaqueSpanOffsets[width] = static_cast<int>(this->opaqueSpans.size());
+}
+
+size_t SoftwareRenderer::FlatTexture::getByteCount() const
+{
+	return (this->texels.size() * sizeof(FlatTexel)) + (this->opaqueSpans.size() * sizeof(Int2)) +
+		(this->opaqueSpanOffsets.size() * sizeof(int));
 }
 
 SoftwareRenderer::SkyTexture::SkyTexture()
@@ -239,6 +348,8 @@ void SoftwareRenderer::ChasmTexture::init(int width, int height, const uint8_t *
 	DebugAssert(srcTexels != nullptr);
 
 	this->texels.resize(width * height);
+	this->srcTexels = std::vector<uint8_t>(srcTexels, srcTexels + (width * height));
+	this->palette = palette;
 	this->width = width;
 	this->height = height;
 
@@ -261,42 +372,350 @@ void SoftwareRenderer::ChasmTexture::init(int width, int height, const uint8_t *
 	}
 }
 
+bool SoftwareRenderer::ChasmTexture::matches(int width, int height, const uint8_t *srcTexels,
+	const Palette &palette) const
+{
+	return (this->width == width) && (this->height == height) && (this->palette == palette) &&
+		std::equal(this->srcTexels.begin(), this->srcTexels.end(), srcTexels);
+}
+
+SoftwareRenderer::TextureResidency::Slot::Slot()
+{
+	this->byteCount = 0;
+	this->refCount = 0;
+	this->resident = false;
+}
+
+SoftwareRenderer::TextureResidency::TextureResidency(size_t byteBudget)
+{
+	this->byteBudget = byteBudget;
+	this->residentByteCount = 0;
+	this->hitCount = 0;
+	this->missCount = 0;
+}
+
+int SoftwareRenderer::TextureResidency::getSlotCount() const
+{
+	return static_cast<int>(this->slots.size());
+}
+
+size_t SoftwareRenderer::TextureResidency::getResidentByteCount() const
+{
+	return this->residentByteCount;
+}
+
+int SoftwareRenderer::TextureResidency::addSlot(size_t byteCount)
+{
+	int index;
+	if (this->freeSlots.size() > 0)
+	{
+		index = this->freeSlots.back();
+		this->freeSlots.pop_back();
+	}
+	else
+	{
+		this->slots.emplace_back(Slot());
+		index = static_cast<int>(this->slots.size()) - 1;
+	}
+
+	Slot &slot = this->slots[index];
+	slot.byteCount = byteCount;
+	slot.refCount = 1;
+	slot.resident = true;
+
+	this->residentByteCount += byteCount;
+	this->missCount++;
+	return index;
+}
+
+void SoftwareRenderer::TextureResidency::addReference(int slotIndex)
+{
+	DebugAssertIndex(this->slots, slotIndex);
+	Slot &slot = this->slots[slotIndex];
+	DebugAssert(slot.resident);
+
+	if (slot.refCount == 0)
+	{
+		this->unreferencedSlots.erase(slot.unreferencedIter);
+	}
+
+	slot.refCount++;
+	this->hitCount++;
+}
+
+void SoftwareRenderer::TextureResidency::removeReference(int slotIndex)
+{
+	DebugAssertIndex(this->slots, slotIndex);
+	Slot &slot = this->slots[slotIndex];
+	DebugAssert(slot.resident);
+	DebugAssert(slot.refCount > 0);
+
+	slot.refCount--;
+	if (slot.refCount == 0)
+	{
+		slot.unreferencedIter = this->unreferencedSlots.insert(this->unreferencedSlots.end(), slotIndex);
+	}
+}
+
+void SoftwareRenderer::TextureResidency::releaseAll()
+{
+	for (int i = 0; i < static_cast<int>(this->slots.size()); i++)
+	{
+		Slot &slot = this->slots[i];
+		if (slot.resident && (slot.refCount > 0))
+		{
+			slot.refCount = 0;
+			slot.unreferencedIter = this->unreferencedSlots.insert(this->unreferencedSlots.end(), i);
+		}
+	}
+
+	this->hitCount = 0;
+	this->missCount = 0;
+}
+
+bool SoftwareRenderer::TextureResidency::tryEvict(int *outSlot)
+{
+	if ((this->residentByteCount <= this->byteBudget) || this->unreferencedSlots.empty())
+	{
+		// Within budget, or everything left is in use by the active level.
+		return false;
+	}
+
+	const int index = this->unreferencedSlots.front();
+	this->unreferencedSlots.pop_front();
+
+	Slot &slot = this->slots[index];
+	this->residentByteCount -= slot.byteCount;
+	slot = Slot();
+	this->freeSlots.push_back(index);
+
+	*outSlot = index;
+	return true;
+}
+
 SoftwareRenderer::VoxelTextureMapping::VoxelTextureMapping(TextureAssetReference &&textureAssetRef, int textureIndex)
 	: textureAssetRef(std::move(textureAssetRef))
 {
 	this->textureIndex = textureIndex;
 }
 
+SoftwareRenderer::VoxelTextures::VoxelTextures()
+	: residency(VoxelTextures::RESIDENCY_BUDGET_BYTES)
+{
+	this->resolvedVoxelGridGeneration = -1;
+	this->conversionTime = 0.0;
+}
+
+bool SoftwareRenderer::VoxelTextures::tryAddReference(const TextureAssetReference &textureAssetRef)
+{
+	for (const VoxelTextureMapping &mapping : this->mappings)
+	{
+		if (mapping.textureAssetRef == textureAssetRef)
+		{
+			this->residency.addReference(mapping.textureIndex);
+			return true;
+		}
+	}
+
+	return false;
+}
+
 void SoftwareRenderer::VoxelTextures::addTexture(VoxelTexture &&texture, TextureAssetReference &&textureAssetRef)
 {
-	this->textures.emplace_back(std::move(texture));
+	// Reuses the slot of an evicted texture if there is one.
+	const int index = this->residency.addSlot(texture.getByteCount());
+	if (index == static_cast<int>(this->textures.size()))
+	{
+		this->textures.emplace_back(std::move(texture));
+		this->mappings.emplace_back(VoxelTextureMapping(std::move(textureAssetRef), index));
+	}
+	else
+	{
+		this->textures[index] = std::move(texture);
+		this->mappings[index] = VoxelTextureMapping(std::move(textureAssetRef), index);
+	}
+
+	// A new texture might complete voxel definitions resolved earlier.
+	this->voxelTextureIndices.clear();
 
-	const int index = static_cast<int>(this->textures.size()) - 1;
-	this->mappings.emplace_back(VoxelTextureMapping(std::move(textureAssetRef), index));
+	this->evictUnreferenced();
 }
 
-const SoftwareRenderer::VoxelTexture &SoftwareRenderer::VoxelTextures::getTexture(
-	const TextureAssetReference &textureAssetRef) const
+void SoftwareRenderer::VoxelTextures::removeReference(const TextureAssetReference &textureAssetRef)
 {
-	int index = -1;
-	for (int i = 0; i < static_cast<int>(this->mappings.size()); i++)
+	for (const VoxelTextureMapping &mapping : this->mappings)
 	{
-		const VoxelTextureMapping &mapping = this->mappings[i];
 		if (mapping.textureAssetRef == textureAssetRef)
 		{
-			index = mapping.textureIndex;
-			break;
+			this->residency.removeReference(mapping.textureIndex);
+			return;
+		}
+	}
+
+	DebugLogWarning("No voxel texture to free for \"" + textureAssetRef.filename + "\".");
+}
+
+void SoftwareRenderer::VoxelTextures::releaseAll()
+{
+	this->residency.releaseAll();
+	this->conversionTime = 0.0;
+
+	this->voxelTextureIndices.clear();
+	this->resolvedVoxelGridGeneration = -1;
+
+	this->evictUnreferenced();
+}
+
+void SoftwareRenderer::VoxelTextures::evictUnreferenced()
+{
+	int index;
+	while (this->residency.tryEvict(&index))
+	{
+		this->textures[index] = VoxelTexture();
+		this->mappings[index] = VoxelTextureMapping(TextureAssetReference(), index);
+		this->voxelTextureIndices.clear();
+	}
+}
+
+void SoftwareRenderer::VoxelTextures::resolveVoxelTextures(const VoxelGrid &voxelGrid)
+{
+	const int voxelGridGeneration = voxelGrid.getGeneration();
+	if (this->resolvedVoxelGridGeneration != voxelGridGeneration)
+	{
+		this->voxelTextureIndices.clear();
+		this->resolvedVoxelGridGeneration = voxelGridGeneration;
+	}
+
+	auto getTextureIndex = [this](const TextureAssetReference &textureAssetRef)
+	{
+		for (const VoxelTextureMapping &mapping : this->mappings)
+		{
+			if (mapping.textureAssetRef == textureAssetRef)
+			{
+				return mapping.textureIndex;
+			}
 		}
+
+		return -1;
+	};
+
+	// Voxel definitions are only ever appended, so only new ones need resolving.
+	const int voxelDefCount = voxelGrid.getVoxelDefCount();
+	for (int i = static_cast<int>(this->voxelTextureIndices.size()); i < voxelDefCount; i++)
+	{
+		const VoxelDefinition &voxelDef = voxelGrid.getVoxelDef(static_cast<uint16_t>(i));
+		const Buffer<TextureAssetReference> textureAssetRefs = voxelDef.getTextureAssetReferences();
+		DebugAssert(textureAssetRefs.getCount() <= SLOT_COUNT);
+
+		VoxelTextureIndices indices;
+		indices.fill(-1);
+		for (int j = 0; j < textureAssetRefs.getCount(); j++)
+		{
+			indices[j] = getTextureIndex(textureAssetRefs.get(j));
+		}
+
+		this->voxelTextureIndices.emplace_back(std::move(indices));
 	}
+}
+
+const SoftwareRenderer::VoxelTexture &SoftwareRenderer::VoxelTextures::getTexture(
+	uint16_t voxelID, int slot) const
+{
+	DebugAssertIndex(this->voxelTextureIndices, voxelID);
+	const VoxelTextureIndices &indices = this->voxelTextureIndices[voxelID];
+
+	DebugAssertIndex(indices, slot);
+	const int index = indices[slot];
 
 	DebugAssertIndex(this->textures, index);
 	return this->textures[index];
 }
 
-void SoftwareRenderer::VoxelTextures::clear()
+SoftwareRenderer::FlatTextureKey::FlatTextureKey(const TextureAssetReference &textureAssetRef,
+	bool flipped, bool reflective)
+	: textureAssetRef(textureAssetRef)
 {
-	this->textures.clear();
-	this->mappings.clear();
+	this->flipped = flipped;
+	this->reflective = reflective;
+}
+
+bool SoftwareRenderer::FlatTextureKey::operator<(const FlatTextureKey &other) const
+{
+	return std::tie(this->textureAssetRef.filename, this->textureAssetRef.index, this->flipped, this->reflective) <
+		std::tie(other.textureAssetRef.filename, other.textureAssetRef.index, other.flipped, other.reflective);
+}
+
+SoftwareRenderer::FlatTextures::FlatTextures()
+	: residency(FlatTextures::RESIDENCY_BUDGET_BYTES)
+{
+	this->conversionTime = 0.0;
+}
+
+int SoftwareRenderer::FlatTextures::addReference(const FlatTextureKey &key,
+	const TextureBuilder &textureBuilder)
+{
+	const auto iter = this->indices.find(key);
+	if (iter != this->indices.end())
+	{
+		this->residency.addReference(iter->second);
+		return iter->second;
+	}
+
+	// @todo: figure out how the texture type should be handled in the long term. This renderer might
+	// end up being strictly 8-bit.
+	DebugAssert(textureBuilder.getType() == TextureBuilder::Type::Paletted);
+	const TextureBuilder::PalettedTexture &srcTexture = textureBuilder.getPaletted();
+	const Buffer2D<uint8_t> &srcTexels = srcTexture.texels;
+
+	const auto conversionStartTime = std::chrono::high_resolution_clock::now();
+	FlatTexture texture;
+	texture.init(srcTexels.getWidth(), srcTexels.getHeight(), srcTexels.get(), key.flipped, key.reflective);
+
+	const std::chrono::duration<double> conversionTime =
+		std::chrono::high_resolution_clock::now() - conversionStartTime;
+	this->conversionTime += conversionTime.count();
+
+	// Reuses the slot of an evicted texture if there is one.
+	const int index = this->residency.addSlot(texture.getByteCount());
+	if (index == static_cast<int>(this->textures.size()))
+	{
+		this->textures.emplace_back(std::move(texture));
+		this->keys.emplace_back(key);
+	}
+	else
+	{
+		this->textures[index] = std::move(texture);
+		this->keys[index] = key;
+	}
+
+	this->indices.emplace(key, index);
+	this->evictUnreferenced();
+	return index;
+}
+
+void SoftwareRenderer::FlatTextures::releaseAll()
+{
+	this->residency.releaseAll();
+	this->conversionTime = 0.0;
+	this->evictUnreferenced();
+}
+
+void SoftwareRenderer::FlatTextures::evictUnreferenced()
+{
+	int index;
+	while (this->residency.tryEvict(&index))
+	{
+		DebugAssert(this->keys[index].has_value());
+		this->indices.erase(*this->keys[index]);
+		this->keys[index] = std::nullopt;
+		this->textures[index] = FlatTexture();
+	}
+}
+
+const SoftwareRenderer::FlatTexture &SoftwareRenderer::FlatTextures::getTexture(int index) const
+{
+	DebugAssertIndex(this->textures, index);
+	return this->textures[index];
 }
 
 bool SoftwareRenderer::FlatTextureGroup::isValidLookup(int stateID, int angleID, int textureID) const
@@ -328,14 +747,12 @@ bool SoftwareRenderer::FlatTextureGroup::isValidLookup(int stateID, int angleID,
 	return true;
 }
 
-const SoftwareRenderer::FlatTexture &SoftwareRenderer::FlatTextureGroup::getTexture(
-	int stateID, int angleID, int textureID) const
+int SoftwareRenderer::FlatTextureGroup::getTextureIndex(int stateID, int angleID, int textureID) const
 {
 	DebugAssert(this->isValidLookup(stateID, angleID, textureID));
 	const State &state = this->states[stateID];
 	const FlatTextureGroup::TextureList &textureList = state[angleID];
-	const FlatTexture &texture = textureList[textureID];
-	return texture;
+	return textureList[textureID];
 }
 
 void SoftwareRenderer::FlatTextureGroup::init(const EntityAnimationInstance &animInst)
@@ -355,21 +772,15 @@ void SoftwareRenderer::FlatTextureGroup::init(const EntityAnimationInstance &ani
 			const EntityAnimationInstance::KeyframeList &animKeyframeList = animState.getKeyframeList(listIndex);
 			const int keyframeCount = animKeyframeList.getKeyframeCount();
 
+			// No texture yet, to be set by caller next.
 			FlatTextureGroup::TextureList &flatTextureList = flatState[listIndex];
-			flatTextureList.resize(keyframeCount);
-			for (FlatTexture &flatTexture : flatTextureList)
-			{
-				// Set texture to empty, to be initialized by caller next.
-				flatTexture.width = 0;
-				flatTexture.height = 0;
-				flatTexture.texels.resize(0);
-			}
+			flatTextureList = FlatTextureGroup::TextureList(keyframeCount, -1);
 		}
 	}
 }
 
-void SoftwareRenderer::FlatTextureGroup::setTexture(int stateID, int angleID, int textureID,
-	bool flipped, const TextureBuilder &textureBuilder, bool reflective)
+void SoftwareRenderer::FlatTextureGroup::setTextureIndex(int stateID, int angleID, int textureID,
+	int textureIndex)
 {
 	if (!this->isValidLookup(stateID, angleID, textureID))
 	{
@@ -380,15 +791,7 @@ void SoftwareRenderer::FlatTextureGroup::setTexture(int stateID, int angleID, in
 
 	FlatTextureGroup::State &state = this->states[stateID];
 	FlatTextureGroup::TextureList &textureList = state[angleID];
-	FlatTexture &texture = textureList[textureID];
-
-	// @todo: figure out how the texture type should be handled in the long term. This renderer might
-	// end up being strictly 8-bit.
-	DebugAssert(textureBuilder.getType() == TextureBuilder::Type::Paletted);
-	const TextureBuilder::PalettedTexture &srcTexture = textureBuilder.getPaletted();
-	const Buffer2D<uint8_t> &srcTexels = srcTexture.texels;
-
-	texture.init(srcTexels.getWidth(), srcTexels.getHeight(), srcTexels.get(), flipped, reflective);
+	textureList[textureID] = textureIndex;
 }
 
 SoftwareRenderer::Camera::Camera(const CoordDouble3 &eye, const VoxelDouble3 &direction,
@@ -571,6 +974,26 @@ void SoftwareRenderer::OcclusionData::update(int yStart, int yEnd)
 	}
 }
 
+SoftwareRenderer::RayStepCounts::RayStepCounts()
+{
+	this->stepCount = 0;
+	this->skippedStepCount = 0;
+}
+
+SoftwareRenderer::StageTimes::StageTimes()
+{
+	this->sky = 0.0;
+	this->voxels = 0.0;
+	this->planes = 0.0;
+	this->flats = 0.0;
+}
+
+void SoftwareRenderer::RayStepCounts::add(const RayStepCounts &other)
+{
+	this->stepCount += other.stepCount;
+	this->skippedStepCount += other.skippedStepCount;
+}
+
 SoftwareRenderer::ShadingInfo::ShadingInfo(const Palette &palette, const std::vector<Double3> &skyPalette,
 	double daytimePercent, double latitude, double ambient, double fogDistance,
 	double chasmAnimPercent, bool nightLightsAreActive, bool isExterior, bool playerHasLight)
@@ -598,11 +1021,24 @@ const Double3 &SoftwareRenderer::ShadingInfo::getFogColor() const
 	return this->skyColors.front();
 }
 
-SoftwareRenderer::FrameView::FrameView(uint32_t *colorBuffer, double *depthBuffer, 
-	int width, int height)
+SoftwareRenderer::PlaneSpan::PlaneSpan(const VoxelTexture &texture, const VisibleLightList &visLightList,
+	double planeY, int voxelY, const Double3 &normal)
+	: normal(normal)
+{
+	this->texture = &texture;
+	this->visLightList = &visLightList;
+	this->planeY = planeY;
+	this->voxelY = voxelY;
+}
+
+SoftwareRenderer::FrameView::FrameView(uint32_t *colorBuffer, double *depthBuffer,
+	std::vector<PlaneSpan> *planeSpans, uint16_t *planeSpanIDs, uint32_t *hitIDs, int width, int height)
 {
 	this->colorBuffer = colorBuffer;
 	this->depthBuffer = depthBuffer;
+	this->planeSpans = planeSpans;
+	this->planeSpanIDs = planeSpanIDs;
+	this->hitIDs = hitIDs;
 	this->width = width;
 	this->height = height;
 	this->widthReal = static_cast<double>(width);
@@ -648,27 +1084,6 @@ void SoftwareRenderer::DistantObjects::init(const DistantSky &distantSky,
 		return static_cast<int>(skyTextures.size()) - 1;
 	};
 
-	// Creates a render texture with a single texel for small stars.
-	auto addSmallStarTexture = [&skyTextures](uint32_t color)
-	{
-		skyTextures.push_back(SkyTexture());
-		SkyTexture &texture = skyTextures.back();
-		texture.texels = std::vector<SkyTexel>(1);
-		texture.width = 1;
-		texture.height = 1;
-
-		// Small stars are never transparent in the original game; this is just using the
-		// same storage representation as clouds which can have some transparencies.
-		const Double4 srcColor = Double4::fromARGB(color);
-		SkyTexel &dstTexel = texture.texels.front();
-		dstTexel.r = srcColor.x;
-		dstTexel.g = srcColor.y;
-		dstTexel.b = srcColor.z;
-		dstTexel.a = srcColor.w;
-
-		return static_cast<int>(skyTextures.size()) - 1;
-	};
-
 	// Reverse iterate through each distant object type in the distant sky, creating associations
 	// between the distant sky object and its render texture. Order of insertion matters.
 	for (int i = distantSky.getLandObjectCount() - 1; i >= 0; i--)
@@ -756,34 +1171,35 @@ void SoftwareRenderer::DistantObjects::init(const DistantSky &distantSky,
 	for (int i = distantSky.getStarObjectCount() - 1; i >= 0; i--)
 	{
 		const DistantSky::StarObject &starObject = distantSky.getStarObject(i);
-		const int textureIndex = [&distantSky, &textureManager, &addSkyTexture, &addSmallStarTexture, &starObject]()
-		{
-			if (starObject.getType() == DistantSky::StarObject::Type::Small)
-			{
-				const DistantSky::StarObject::SmallStar &smallStar = starObject.getSmallStar();
-				return addSmallStarTexture(smallStar.color);
+		if (starObject.getType() == DistantSky::StarObject::Type::Small)
+		{
+			// Small stars don't need a texture, just their direction and color.
+			const DistantSky::StarObject::SmallStar &smallStar = starObject.getSmallStar();
+			const Double3 &direction = starObject.getDirection();
+			this->smallStarDirXs.push_back(static_cast<float>(direction.x));
+			this->smallStarDirYs.push_back(static_cast<float>(direction.y));
+			this->smallStarDirZs.push_back(static_cast<float>(direction.z));
+			this->smallStarColors.push_back(smallStar.color);
+		}
+		else if (starObject.getType() == DistantSky::StarObject::Type::Large)
+		{
+			const DistantSky::StarObject::LargeStar &largeStar = starObject.getLargeStar();
+			const int entryIndex = largeStar.entryIndex;
+			const TextureAssetReference &textureAssetRef = distantSky.getTextureAssetRef(entryIndex);
+			const std::optional<TextureBuilderID> textureBuilderID =
+				textureManager.tryGetTextureBuilderID(textureAssetRef.filename.c_str());
+			if (!textureBuilderID.has_value())
+			{
+				DebugCrash("Couldn't get texture builder ID for \"" + textureAssetRef.filename + "\".");
 			}
-			else if (starObject.getType() == DistantSky::StarObject::Type::Large)
-			{
-				const DistantSky::StarObject::LargeStar &largeStar = starObject.getLargeStar();
-				const int entryIndex = largeStar.entryIndex;
-				const TextureAssetReference &textureAssetRef = distantSky.getTextureAssetRef(entryIndex);
-				const std::optional<TextureBuilderID> textureBuilderID =
-					textureManager.tryGetTextureBuilderID(textureAssetRef.filename.c_str());
-				if (!textureBuilderID.has_value())
-				{
-					DebugCrash("Couldn't get texture builder ID for \"" + textureAssetRef.filename + "\".");
-				}
 
-				return addSkyTexture(*textureBuilderID);
-			}
-			else
-			{
-				DebugUnhandledReturnMsg(int, std::to_string(static_cast<int>(starObject.getType())));
-			}
-		}();
-
-		this->stars.push_back(DistantObject<DistantSky::StarObject>(starObject, textureIndex));
+			const int textureIndex = addSkyTexture(*textureBuilderID);
+			this->stars.push_back(DistantObject<DistantSky::StarObject>(starObject, textureIndex));
+		}
+		else
+		{
+			DebugNotImplementedMsg(std::to_string(static_cast<int>(starObject.getType())));
+		}
 	}
 
 	if (distantSky.hasSun())
@@ -809,6 +1225,10 @@ void SoftwareRenderer::DistantObjects::clear()
 	this->airs.clear();
 	this->moons.clear();
 	this->stars.clear();
+	this->smallStarDirXs.clear();
+	this->smallStarDirYs.clear();
+	this->smallStarDirZs.clear();
+	this->smallStarColors.clear();
 	this->sunTextureIndex = DistantObjects::NO_SUN;
 }
 
@@ -824,6 +1244,15 @@ SoftwareRenderer::VisDistantObject::VisDistantObject(const SkyTexture &texture,
 	this->emissive = emissive;
 }
 
+SoftwareRenderer::VisSmallStar::VisSmallStar(const Double3 &color, int xStart, int xEnd, int yStart, int yEnd)
+	: color(color)
+{
+	this->xStart = xStart;
+	this->xEnd = xEnd;
+	this->yStart = yStart;
+	this->yEnd = yEnd;
+}
+
 SoftwareRenderer::VisDistantObjects::VisDistantObjects()
 {
 	this->landStart = 0;
@@ -843,6 +1272,7 @@ SoftwareRenderer::VisDistantObjects::VisDistantObjects()
 void SoftwareRenderer::VisDistantObjects::clear()
 {
 	this->objs.clear();
+	this->smallStars.clear();
 	this->landStart = 0;
 	this->landEnd = 0;
 	this->animLandStart = 0;
@@ -948,19 +1378,28 @@ void SoftwareRenderer::RenderThreadData::Voxels::init(int chunkDistance, double
 	this->voxelTextures = &voxelTextures;
 	this->chasmTextureGroups = &chasmTextureGroups;
 	this->occlusion = &occlusion;
+	this->rayStepCounts = RayStepCounts();
 	this->doneLightVisTesting = false;
 }
 
+void SoftwareRenderer::RenderThreadData::Planes::init(const std::vector<VisibleLight> &visLights,
+	const Buffer<double> &depthScales)
+{
+	this->threadsDone = 0;
+	this->visLights = &visLights;
+	this->depthScales = &depthScales;
+	this->doneVoxels = false;
+}
+
 void SoftwareRenderer::RenderThreadData::Flats::init(const Double3 &flatNormal,
 	const std::vector<VisibleFlat> &visibleFlats, const std::vector<VisibleLight> &visLights,
-	const Buffer2D<VisibleLightList> &visLightLists, const FlatTextureGroups &flatTextureGroups)
+	const Buffer2D<VisibleLightList> &visLightLists)
 {
 	this->threadsDone = 0;
 	this->flatNormal = &flatNormal;
 	this->visibleFlats = &visibleFlats;
 	this->visLights = &visLights;
 	this->visLightLists = &visLightLists;
-	this->flatTextureGroups = &flatTextureGroups;
 	this->doneSorting = false;
 }
 
@@ -993,6 +1432,9 @@ SoftwareRenderer::SoftwareRenderer()
 	this->height = 0;
 	this->renderThreadsMode = 0;
 	this->fogDistance = 0.0;
+	this->culledFlatCount = 0;
+	this->culledLightCount = 0;
+	this->hitIDsActive = false;
 }
 
 SoftwareRenderer::~SoftwareRenderer()
@@ -1010,9 +1452,16 @@ SoftwareRenderer::ProfilerData SoftwareRenderer::getProfilerData() const
 {
 	// @todo: make this a member of SoftwareRenderer eventually when it is capturing more
 	// information in render(), etc..
+	const RayStepCounts &rayStepCounts = this->threadData.voxels.rayStepCounts;
 	return ProfilerData(this->width, this->height, this->renderThreads.getCount(),
 		static_cast<int>(this->potentiallyVisibleFlats.size()), static_cast<int>(this->visibleFlats.size()),
-		static_cast<int>(this->visibleLights.size()));
+		static_cast<int>(this->visibleLights.size()), rayStepCounts.stepCount, rayStepCounts.skippedStepCount,
+		this->stageTimes.sky, this->stageTimes.voxels, this->stageTimes.planes, this->stageTimes.flats,
+		this->voxelTextures.residency.hitCount + this->flatTextures.residency.hitCount,
+		this->voxelTextures.residency.missCount + this->flatTextures.residency.missCount,
+		this->voxelTextures.conversionTime + this->flatTextures.conversionTime,
+		this->voxelTextures.residency.getResidentByteCount() + this->flatTextures.residency.getResidentByteCount(),
+		this->culledFlatCount, this->culledLightCount);
 }
 
 bool SoftwareRenderer::isValidEntityRenderID(EntityRenderID id) const
@@ -1030,7 +1479,8 @@ bool SoftwareRenderer::tryGetEntitySelectionData(const Double2 &uv, EntityRender
 		// Get the texture list from the texture group at the given animation state and angle.
 		DebugAssert(this->isValidEntityRenderID(entityRenderID));
 		const FlatTextureGroup &textureGroup = this->flatTextureGroups[entityRenderID];
-		const FlatTexture &texture = textureGroup.getTexture(animStateID, animAngleID, animKeyframeID);
+		const int flatTextureIndex = textureGroup.getTextureIndex(animStateID, animAngleID, animKeyframeID);
+		const FlatTexture &texture = this->flatTextures.getTexture(flatTextureIndex);
 
 		// Convert texture coordinates to a texture index. Don't need to clamp; just return
 		// failure if it's out-of-bounds.
@@ -1087,22 +1537,96 @@ Double3 SoftwareRenderer::screenPointToRay(double xPercent, double yPercent,
 	return (forwardComponent + rightComponent - upComponent).normalized();
 }
 
+bool SoftwareRenderer::tryGetEntityHit(int x, int y, EntityID *outID, int *outGeneration,
+	double *outDepth) const
+{
+	if (!this->hitIDsActive || !this->hitIDs.isValid())
+	{
+		return false;
+	}
+
+	if ((x < 0) || (x >= this->width) || (y < 0) || (y >= this->height))
+	{
+		return false;
+	}
+
+	const uint32_t hitID = this->hitIDs.get(x, y);
+	if ((hitID & HitTypeMask) != HitTypeFlat)
+	{
+		return false;
+	}
+
+	// The visible flats are kept until the next frame, so the ID still points to what was drawn.
+	const int flatIndex = static_cast<int>(hitID >> 2);
+	DebugAssertIndex(this->visibleFlats, flatIndex);
+	const VisibleFlat &flat = this->visibleFlats[flatIndex];
+	*outID = flat.entityID;
+	*outGeneration = flat.entityGeneration;
+	*outDepth = this->depthBuffer.get(x, y);
+	return true;
+}
+
+bool SoftwareRenderer::tryGetVoxelHit(int x, int y, NewInt3 *outVoxel,
+	std::optional<VoxelFacing3D> *outFacing, double *outDepth) const
+{
+	if (!this->hitIDsActive || !this->hitIDs.isValid())
+	{
+		return false;
+	}
+
+	if ((x < 0) || (x >= this->width) || (y < 0) || (y >= this->height))
+	{
+		return false;
+	}
+
+	const uint32_t hitID = this->hitIDs.get(x, y);
+	if ((hitID & HitTypeMask) != HitTypeVoxel)
+	{
+		return false;
+	}
+
+	*outVoxel = NewInt3(
+		static_cast<SNInt>((hitID >> HitVoxelXShift) & HitVoxelXZMask),
+		static_cast<int>((hitID >> HitVoxelYShift) & HitVoxelYMask),
+		static_cast<WEInt>((hitID >> HitVoxelZShift) & HitVoxelXZMask));
+
+	const uint32_t facing = (hitID >> HitVoxelFacingShift) & HitVoxelFacingMask;
+	*outFacing = (facing != 0) ? std::make_optional(static_cast<VoxelFacing3D>(facing - 1)) : std::nullopt;
+	*outDepth = this->depthBuffer.get(x, y);
+	return true;
+}
+
 void SoftwareRenderer::init(const RenderInitSettings &settings)
 {
 	// Initialize frame buffer.
-	this->depthBuffer.init(settings.getWidth(), settings.getHeight());
+	this->depthBuffer.init(settings.getWidth(), settings.getHeight(), BufferAllocation::LargePages);
 	this->depthBuffer.fill(DEPTH_BUFFER_INFINITY);
 
 	// Initialize occlusion columns.
 	this->occlusion.init(settings.getWidth());
 	this->occlusion.fill(OcclusionData(0, settings.getHeight()));
 
+	// Initialize deferred floor and ceiling spans.
+	this->planeSpans.init(settings.getWidth());
+	this->planeSpanIDs.init(settings.getWidth(), settings.getHeight());
+	this->planeSpanIDs.fill(0);
+	this->planeDepthScales.init(settings.getWidth());
+	this->planeDepthScales.fill(0.0);
+
+	// Initialize hit buffer if picking from the frame is enabled.
+	if (this->hitIDsActive)
+	{
+		this->hitIDs.init(settings.getWidth(), settings.getHeight());
+		this->hitIDs.fill(HitTypeNone);
+	}
+
 	// Initialize sky gradient cache.
 	this->skyGradientRowCache.init(settings.getHeight());
 	this->skyGradientRowCache.fill(Double3::Zero);
 
 	// Initialize texture containers.
 	this->voxelTextures = VoxelTextures();
+	this->flatTextures = FlatTextures();
 	this->flatTextureGroups = FlatTextureGroups();
 
 	this->width = settings.getWidth();
@@ -1170,11 +1694,13 @@ void SoftwareRenderer::setFlatTextures(EntityRenderID entityRenderID,
 				const int angleID = keyframeListIndex;
 				const int keyframeID = keyframeIndex;
 
-				// Get the associated texture and write texture data.
+				// Get the associated texture, reusing it if it's resident from this or a previous level.
 				const TextureBuilder &textureBuilder =
 					instKeyframe.getTextureBuilderHandle(defKeyframe, textureManager);
+				const FlatTextureKey textureKey(defKeyframe.getTextureAssetRef(), flipped, isPuddle);
+				const int textureIndex = this->flatTextures.addReference(textureKey, textureBuilder);
 				const int textureID = keyframeID;
-				flatTextureGroup.setTexture(stateID, angleID, textureID, flipped, textureBuilder, isPuddle);
+				flatTextureGroup.setTextureIndex(stateID, angleID, textureID, textureIndex);
 			}
 		}
 	}
@@ -1185,6 +1711,30 @@ void SoftwareRenderer::setFogDistance(double fogDistance)
 	this->fogDistance = fogDistance;
 }
 
+void SoftwareRenderer::setHitBufferActive(bool active)
+{
+	if (this->hitIDsActive == active)
+	{
+		return;
+	}
+
+	this->hitIDsActive = active;
+
+	if (active)
+	{
+		// Nothing is pickable until the next frame is drawn.
+		if (this->isInited())
+		{
+			this->hitIDs.init(this->width, this->height);
+			this->hitIDs.fill(HitTypeNone);
+		}
+	}
+	else
+	{
+		this->hitIDs.clear();
+	}
+}
+
 void SoftwareRenderer::setDistantSky(const DistantSky &distantSky, const Palette &palette,
 	TextureManager &textureManager)
 {
@@ -1218,6 +1768,21 @@ void SoftwareRenderer::addChasmTexture(ArenaTypes::ChasmType chasmType,
 	}
 
 	ChasmTextureGroup &textureGroup = iter->second;
+
+	// Reuse the previous level's texture for this frame if it was made from the same data.
+	const int frameIndex = static_cast<int>(textureGroup.size());
+	const auto prevIter = this->prevChasmTextureGroups.find(chasmID);
+	if (prevIter != this->prevChasmTextureGroups.end())
+	{
+		ChasmTextureGroup &prevTextureGroup = prevIter->second;
+		if ((frameIndex < static_cast<int>(prevTextureGroup.size())) &&
+			prevTextureGroup[frameIndex].matches(width, height, colors, palette))
+		{
+			textureGroup.push_back(std::move(prevTextureGroup[frameIndex]));
+			return;
+		}
+	}
+
 	textureGroup.push_back(ChasmTexture());
 	ChasmTexture &texture = textureGroup.back();
 	texture.init(width, height, colors, palette);
@@ -1235,13 +1800,17 @@ void SoftwareRenderer::setNightLightsActive(bool active, const Palette &palette)
 
 void SoftwareRenderer::clearTexturesAndEntityRenderIDs()
 {
-	this->voxelTextures.clear();
+	// Voxel and flat textures stay resident so the next level can reuse them.
+	this->voxelTextures.releaseAll();
+	this->flatTextures.releaseAll();
 	this->flatTextureGroups.clear();
 
 	// Distant sky textures are cleared because the vector size is managed internally.
 	this->skyTextures.clear();
 	this->distantObjects.sunTextureIndex = SoftwareRenderer::DistantObjects::NO_SUN;
 
+	// Chasm textures are kept until the next level adds its own.
+	this->prevChasmTextureGroups = std::move(this->chasmTextureGroups);
 	this->chasmTextureGroups.clear();
 }
 
@@ -1252,12 +1821,24 @@ void SoftwareRenderer::clearDistantSky()
 
 void SoftwareRenderer::resize(int width, int height)
 {
-	this->depthBuffer.init(width, height);
+	this->depthBuffer.init(width, height, BufferAllocation::LargePages);
 	this->depthBuffer.fill(DEPTH_BUFFER_INFINITY);
 
 	this->occlusion.init(width);
 	this->occlusion.fill(OcclusionData(0, height));
 
+	this->planeSpans.init(width);
+	this->planeSpanIDs.init(width, height);
+	this->planeSpanIDs.fill(0);
+	this->planeDepthScales.init(width);
+	this->planeDepthScales.fill(0.0);
+
+	if (this->hitIDsActive)
+	{
+		this->hitIDs.init(width, height);
+		this->hitIDs.fill(HitTypeNone);
+	}
+
 	this->skyGradientRowCache.init(height);
 	this->skyGradientRowCache.fill(Double3::Zero);
 
@@ -1272,8 +1853,13 @@ void SoftwareRenderer::resize(int width, int height)
 bool SoftwareRenderer::tryCreateVoxelTexture(const TextureAssetReference &textureAssetRef,
 	TextureManager &textureManager)
 {
-	// @todo: protect against duplicate textures.
+	// Reuse the texture if it's still resident from this or a previous level.
+	if (this->voxelTextures.tryAddReference(textureAssetRef))
+	{
+		return true;
+	}
 
+	const auto conversionStartTime = std::chrono::high_resolution_clock::now();
 	const std::optional<TextureBuilderID> textureBuilderID = textureManager.tryGetTextureBuilderID(textureAssetRef);
 	if (!textureBuilderID.has_value())
 	{
@@ -1302,6 +1888,10 @@ bool SoftwareRenderer::tryCreateVoxelTexture(const TextureAssetReference &textur
 			palettedTexture.texels.get(), palette);
 
 		this->voxelTextures.addTexture(std::move(voxelTexture), TextureAssetReference(textureAssetRef));
+
+		const std::chrono::duration<double> conversionTime =
+			std::chrono::high_resolution_clock::now() - conversionStartTime;
+		this->voxelTextures.conversionTime += conversionTime.count();
 		return true;
 	}
 	else if (textureBuilderType == TextureBuilder::Type::TrueColor)
@@ -1373,7 +1963,7 @@ bool SoftwareRenderer::tryCreateSkyTexture(const TextureAssetReference &textureA
 
 void SoftwareRenderer::freeVoxelTexture(const TextureAssetReference &textureAssetRef)
 {
-	DebugNotImplemented();
+	this->voxelTextures.removeReference(textureAssetRef);
 }
 
 void SoftwareRenderer::freeEntityTexture(const TextureAssetReference &textureAssetRef)
@@ -1737,6 +2327,84 @@ void SoftwareRenderer::updateVisibleDistantObjects(const ShadingInfo &shadingInf
 	this->visDistantObjs.starEnd = static_cast<int>(this->visDistantObjs.objs.size());
 }
 
+void SoftwareRenderer::updateVisibleSmallStars(const ShadingInfo &shadingInfo, const Camera &camera,
+	const FrameView &frame)
+{
+	this->visDistantObjs.smallStars.clear();
+
+	const NewDouble3 absoluteEye = VoxelUtils::coordToNewPoint(camera.eye);
+	const NewDouble2 forward(camera.forwardX, camera.forwardZ);
+
+	// All small stars are one texel, so their projected size is the same.
+	const double starWidth = 1.0 / DistantSky::IDENTITY_DIM;
+	const double starHeight = starWidth;
+	const double starProjHalfWidth = ((starWidth * camera.zoom) /
+		(camera.aspect * ArenaRenderUtils::TALL_PIXEL_RATIO)) * 0.50;
+	const double starProjHeight = starHeight * camera.zoom;
+
+	// Combined latitude and time of day rotation, applied to each star direction. This is the
+	// same rotation as other space objects but without the round trip through angles.
+	const Matrix4d spaceRotation = shadingInfo.latitudeRotation * shadingInfo.timeRotation;
+
+	const float *dirXs = this->distantObjects.smallStarDirXs.data();
+	const float *dirYs = this->distantObjects.smallStarDirYs.data();
+	const float *dirZs = this->distantObjects.smallStarDirZs.data();
+	const uint32_t *colors = this->distantObjects.smallStarColors.data();
+	const int smallStarCount = static_cast<int>(this->distantObjects.smallStarColors.size());
+	for (int i = 0; i < smallStarCount; i++)
+	{
+		const Double4 baseDir(
+			static_cast<double>(dirXs[i]),
+			static_cast<double>(dirYs[i]),
+			static_cast<double>(dirZs[i]),
+			0.0);
+		const Double4 dir = spaceRotation * baseDir;
+
+		// Stars directly above or below have no horizontal position.
+		const double xzLength = std::sqrt((dir.x * dir.x) + (dir.z * dir.z));
+		if (xzLength <= Constants::Epsilon)
+		{
+			continue;
+		}
+
+		// Negative for +X south/+Z west.
+		const Double3 objDir(-dir.x / xzLength, 0.0, -dir.z / xzLength);
+		const NewDouble2 objDir2D(objDir.x, objDir.z);
+		if (objDir2D.dot(forward) <= 0.0)
+		{
+			continue;
+		}
+
+		const Double4 objProjPoint = camera.transform * Double4(absoluteEye + objDir, 1.0);
+		const double xProjCenter = 0.50 + ((objProjPoint.x / objProjPoint.w) * 0.50);
+		const double xProjStart = xProjCenter - starProjHalfWidth;
+		const double xProjEnd = xProjCenter + starProjHalfWidth;
+		if ((xProjStart > 1.0) || (xProjEnd < 0.0))
+		{
+			continue;
+		}
+
+		// Project the bottom of the star like other distant objects.
+		const Double3 objDirBottom = Double3(camera.forwardX, dir.y / xzLength, camera.forwardZ).normalized();
+		const double yProjEnd = RendererUtils::getProjectedY(
+			absoluteEye + objDirBottom, camera.transform, camera.yShear);
+		const double yProjStart = yProjEnd - starProjHeight;
+
+		const int xStart = RendererUtils::getLowerBoundedPixel(xProjStart * frame.widthReal, frame.width);
+		const int xEnd = RendererUtils::getUpperBoundedPixel(xProjEnd * frame.widthReal, frame.width);
+		const int yStart = RendererUtils::getLowerBoundedPixel(yProjStart * frame.heightReal, frame.height);
+		const int yEnd = RendererUtils::getUpperBoundedPixel(yProjEnd * frame.heightReal, frame.height);
+		if ((xStart >= xEnd) || (yStart >= yEnd))
+		{
+			continue;
+		}
+
+		const Double4 color = Double4::fromARGB(colors[i]);
+		this->visDistantObjs.smallStars.emplace_back(
+			Double3(color.x, color.y, color.z), xStart, xEnd, yStart, yEnd);
+	}
+}
+
 void SoftwareRenderer::updatePotentiallyVisibleFlats(const Camera &camera,
 	SNInt gridWidth, WEInt gridDepth, int chunkDistance, const EntityManager &entityManager,
 	std::vector<const Entity*> *outPotentiallyVisFlats, int *outEntityCount)
@@ -1822,10 +2490,13 @@ void SoftwareRenderer::updatePotentiallyVisibleFlats(const Camera &camera,
 
 void SoftwareRenderer::updateVisibleFlats(const Camera &camera, const ShadingInfo &shadingInfo,
 	int chunkDistance, double ceilingHeight, const VoxelGrid &voxelGrid,
-	const EntityManager &entityManager, const EntityDefinitionLibrary &entityDefLibrary)
+	const PotentiallyVisibleSet &potentiallyVisibleSet, const EntityManager &entityManager,
+	const EntityDefinitionLibrary &entityDefLibrary)
 {
 	this->visibleFlats.clear();
 	this->visibleLights.clear();
+	this->culledFlatCount = 0;
+	this->culledLightCount = 0;
 
 	// Update potentially visible flats so this method knows what to work with.
 	int potentiallyVisFlatCount;
@@ -1843,6 +2514,7 @@ void SoftwareRenderer::updateVisibleFlats(const Camera &camera, const ShadingInf
 		VoxelDouble2(camera.eye.point.x, camera.eye.point.z));
 	const NewDouble3 absoluteEye = VoxelUtils::coordToNewPoint(camera.eye);
 	const NewDouble2 absoluteEyeXZ(absoluteEye.x, absoluteEye.z);
+	const NewInt2 eyeVoxel = VoxelUtils::pointToVoxel(absoluteEyeXZ);
 	const NewDouble2 cameraDir(camera.forwardX, camera.forwardZ);
 
 	if (shadingInfo.playerHasLight)
@@ -1868,6 +2540,39 @@ void SoftwareRenderer::updateVisibleFlats(const Camera &camera, const ShadingInf
 		const EntityDefinition &entityDef = entityManager.getEntityDef(
 			entity->getDefinitionID(), entityDefLibrary);
 
+		// See if the entity is a light.
+		int lightIntensity;
+		if (!EntityUtils::tryGetLightIntensity(entityDef, &lightIntensity))
+		{
+			constexpr int streetLightIntensity = 4;
+			const bool isActiveStreetLight = ((entityDef.getType() == EntityDefinition::Type::Doodad) &&
+				entityDef.getDoodad().streetlight) && shadingInfo.nightLightsAreActive;
+			lightIntensity = isActiveStreetLight ? streetLightIntensity : 0;
+		}
+
+		// Skip entities that can't be seen from the camera's part of the level. Lights can still
+		// shine on visible surfaces around them, so they are kept if any of their reach is visible.
+		const bool isLight = lightIntensity > 0;
+		const NewInt2 entityVoxel = VoxelUtils::pointToVoxel(VoxelUtils::coordToNewPoint(entity->getPosition()));
+		const bool isFlatPotentiallyVisible = potentiallyVisibleSet.isVisible(eyeVoxel, entityVoxel);
+		const bool isLightPotentiallyVisible = isLight && potentiallyVisibleSet.isAreaVisible(eyeVoxel,
+			entityVoxel - NewInt2(lightIntensity, lightIntensity), entityVoxel + NewInt2(lightIntensity, lightIntensity));
+
+		if (!isFlatPotentiallyVisible)
+		{
+			this->culledFlatCount++;
+		}
+
+		if (isLight && !isLightPotentiallyVisible)
+		{
+			this->culledLightCount++;
+		}
+
+		if (!isFlatPotentiallyVisible && !isLightPotentiallyVisible)
+		{
+			continue;
+		}
+
 		EntityManager::EntityVisibilityData visData;
 		entityManager.getEntityVisibilityData(*entity, eyeXZ, ceilingHeight, voxelGrid,
 			entityDefLibrary, visData);
@@ -1884,19 +2589,8 @@ void SoftwareRenderer::updateVisibleFlats(const Camera &camera, const ShadingInf
 		const double flatHeight = animDefKeyframe.getHeight();
 		const double flatHalfWidth = flatWidth * 0.50;
 
-		// See if the entity is a light.
-		int lightIntensity;
-		if (!EntityUtils::tryGetLightIntensity(entityDef, &lightIntensity))
-		{
-			constexpr int streetLightIntensity = 4;
-			const bool isActiveStreetLight = ((entityDef.getType() == EntityDefinition::Type::Doodad) &&
-				entityDef.getDoodad().streetlight) && shadingInfo.nightLightsAreActive;
-			lightIntensity = isActiveStreetLight ? streetLightIntensity : 0;
-		}
-
 		const NewDouble3 absoluteFlatPosition = VoxelUtils::coordToNewPoint(visData.flatPosition);
-		const bool isLight = lightIntensity > 0;
-		if (isLight)
+		if (isLightPotentiallyVisible)
 		{
 			// See if the light is visible.
 			SoftwareRenderer::LightVisibilityData lightVisData;
@@ -1927,7 +2621,7 @@ void SoftwareRenderer::updateVisibleFlats(const Camera &camera, const ShadingInf
 		const double flatEyeCylinderDist = flatEyeDiffLen - flatRadius;
 		const bool inFogDistance = flatEyeCylinderDist < fogDistance;
 
-		if (inFrontOfCamera && inFogDistance)
+		if (isFlatPotentiallyVisible && inFrontOfCamera && inFogDistance)
 		{
 			// Scaled axes based on flat dimensions.
 			const Double3 flatRightScaled = flatRight * flatHalfWidth;
@@ -1936,10 +2630,16 @@ void SoftwareRenderer::updateVisibleFlats(const Camera &camera, const ShadingInf
 			// Determine if the flat is potentially visible to the camera.
 			VisibleFlat visFlat;
 			visFlat.entityRenderID = entity->getRenderID();
+			visFlat.entityID = entity->getID();
+			visFlat.entityGeneration = entity->getGeneration();
 			visFlat.animStateID = visData.stateIndex;
 			visFlat.animAngleID = visData.angleIndex;
 			visFlat.animTextureID = visData.keyframeIndex;
 
+			const FlatTextureGroup &textureGroup = this->flatTextureGroups[visFlat.entityRenderID];
+			visFlat.texture = &this->flatTextures.getTexture(textureGroup.getTextureIndex(
+				visFlat.animStateID, visFlat.animAngleID, visFlat.animTextureID));
+
 			// Calculate each corner of the flat in world space.
 			visFlat.bottomLeft = absoluteFlatPosition + flatRightScaled;
 			visFlat.bottomRight = absoluteFlatPosition - flatRightScaled;
@@ -3483,7 +4183,7 @@ void SoftwareRenderer::sampleChasmTexture(const ChasmTexture &texture, double sc
 }
 
 template <bool Fading>
-void SoftwareRenderer::drawPixelsShader(int x, const DrawRange &drawRange, double depth,
+void SoftwareRenderer::drawPixelsShader(int x, const NewInt3 &voxel, const DrawRange &drawRange, double depth,
 	double u, double vStart, double vEnd, const Double3 &normal, const VoxelTexture &texture,
 	double fadePercent, double lightContributionPercent, const ShadingInfo &shadingInfo,
 	OcclusionData &occlusion, const FrameView &frame)
@@ -3494,9 +4194,8 @@ void SoftwareRenderer::drawPixelsShader(int x, const DrawRange &drawRange, doubl
 	int yStart = drawRange.yStart;
 	int yEnd = drawRange.yEnd;
 
-	// Horizontal offset in texture.
-	// - Taken care of in texture sampling function (redundant calculation, though).
-	//const int textureX = static_cast<int>(u * static_cast<double>(texture.width));
+	// Value for the hit buffer, if it's in use.
+	const uint32_t hitID = (frame.hitIDs != nullptr) ? MakeVoxelHitID(voxel, normal) : HitTypeNone;
 
 	// Linearly interpolated fog.
 	const Double3 &fogColor = shadingInfo.getFogColor();
@@ -3509,6 +4208,45 @@ void SoftwareRenderer::drawPixelsShader(int x, const DrawRange &drawRange, doubl
 	occlusion.clipRange(&yStart, &yEnd);
 	occlusion.update(yStart, yEnd);
 
+	if (yStart >= yEnd)
+	{
+		return;
+	}
+
+	// The texel column is constant down the span and the texel row is linear in screen Y, so the
+	// row can be stepped in fixed point instead of dividing per pixel. 16.16 drifts enough over
+	// tall spans to pick different rows than the floating-point path, so this uses 32.32.
+	constexpr int texelFractionBits = 32;
+	constexpr double texelFixedScale = static_cast<double>(1LL << texelFractionBits);
+	const double textureHeightReal = static_cast<double>(texture.height);
+	const int textureX = static_cast<int>(u * static_cast<double>(texture.width)); // Horizontal offset in texture.
+	const int textureYMax = texture.height - 1;
+	const double yProjRange = yProjEnd - yProjStart;
+	const double texelYStart = (vStart + ((vEnd - vStart) *
+		(((static_cast<double>(yStart) + 0.50) - yProjStart) / yProjRange))) * textureHeightReal;
+	const double texelYDelta = ((vEnd - vStart) * textureHeightReal) / yProjRange;
+
+	// Texel row from the same floating-point math as sampleVoxelTexture().
+	auto getExactTextureY = [&](int y)
+	{
+		const double yPercent = ((static_cast<double>(y) + 0.50) - yProjStart) / yProjRange;
+		const double v = vStart + ((vEnd - vStart) * yPercent);
+		return std::clamp(static_cast<int>(v * textureHeightReal), 0, textureYMax);
+	};
+
+	// Fixed point is only used when every row in the span fits in it (a tiny or degenerate
+	// projected range gives a huge or NaN step). Rows within the guard distance of a texel
+	// boundary are recomputed exactly, which keeps the output identical to the floating-point
+	// path since the fixed-point error stays far below the guard.
+	constexpr double maxFixedTexelY = static_cast<double>(1 << 30);
+	constexpr int64_t texelFractionMask = (1LL << texelFractionBits) - 1;
+	constexpr int64_t texelBoundaryGuard = 1LL << 16;
+	const double maxSpanTexelY = std::abs(texelYStart) +
+		(std::abs(texelYDelta) * static_cast<double>(yEnd - yStart));
+	const bool canStepFixed = maxSpanTexelY < maxFixedTexelY;
+	int64_t texelYFixed = canStepFixed ? static_cast<int64_t>(texelYStart * texelFixedScale) : 0;
+	const int64_t texelYFixedDelta = canStepFixed ? static_cast<int64_t>(texelYDelta * texelFixedScale) : 0;
+
 	// Draw the column to the output buffer.
 	for (int y = yStart; y < yEnd; y++)
 	{
@@ -3519,18 +4257,40 @@ void SoftwareRenderer::drawPixelsShader(int x, const DrawRange &drawRange, doubl
 		//   this depth check isn't needed.
 		if (depth <= (frame.depthBuffer[index] - Constants::Epsilon))
 		{
-			// Percent stepped from beginning to end on the column.
-			const double yPercent =
-				((static_cast<double>(y) + 0.50) - yProjStart) / (yProjEnd - yProjStart);
-
-			// Vertical texture coordinate.
-			const double v = vStart + ((vEnd - vStart) * yPercent);
-
 			// Texture color. Alpha is ignored in this loop, so transparent texels will appear black.
-			constexpr bool TextureTransparency = false;
 			double colorR, colorG, colorB, colorEmission;
-			SoftwareRenderer::sampleVoxelTexture<TextureFilterMode, TextureTransparency>(
-				texture, u, v, &colorR, &colorG, &colorB, &colorEmission, nullptr);
+			if constexpr (TextureFilterMode == 0)
+			{
+				int textureY;
+				const int64_t texelYFraction = texelYFixed & texelFractionMask;
+				if (canStepFixed && (texelYFraction >= texelBoundaryGuard) &&
+					(texelYFraction <= (texelFractionMask - texelBoundaryGuard)))
+				{
+					textureY = std::clamp(static_cast<int>(texelYFixed >> texelFractionBits), 0, textureYMax);
+				}
+				else
+				{
+					textureY = getExactTextureY(y);
+				}
+
+				const VoxelTexel &texel = texture.texels[textureX + (textureY * texture.width)];
+				colorR = texel.r;
+				colorG = texel.g;
+				colorB = texel.b;
+				colorEmission = texel.emission;
+			}
+			else
+			{
+				// Percent stepped from beginning to end on the column.
+				const double yPercent = ((static_cast<double>(y) + 0.50) - yProjStart) / yProjRange;
+
+				// Vertical texture coordinate.
+				const double v = vStart + ((vEnd - vStart) * yPercent);
+
+				constexpr bool TextureTransparency = false;
+				SoftwareRenderer::sampleVoxelTexture<TextureFilterMode, TextureTransparency>(
+					texture, u, v, &colorR, &colorG, &colorB, &colorEmission, nullptr);
+			}
 
 			// Shading from light.
 			constexpr double shadingMax = 1.0;
@@ -3569,11 +4329,18 @@ void SoftwareRenderer::drawPixelsShader(int x, const DrawRange &drawRange, doubl
 
 			frame.colorBuffer[index] = colorRGB;
 			frame.depthBuffer[index] = depth;
+
+			if (frame.hitIDs != nullptr)
+			{
+				frame.hitIDs[index] = hitID;
+			}
 		}
+
+		texelYFixed += texelYFixedDelta;
 	}
 }
 
-void SoftwareRenderer::drawPixels(int x, const DrawRange &drawRange, double depth, double u,
+void SoftwareRenderer::drawPixels(int x, const NewInt3 &voxel, const DrawRange &drawRange, double depth, double u,
 	double vStart, double vEnd, const Double3 &normal, const VoxelTexture &texture,
 	double fadePercent, double lightContributionPercent, const ShadingInfo &shadingInfo,
 	OcclusionData &occlusion, const FrameView &frame)
@@ -3581,19 +4348,19 @@ void SoftwareRenderer::drawPixels(int x, const DrawRange &drawRange, double dept
 	if (fadePercent == 1.0)
 	{
 		constexpr bool fading = false;
-		SoftwareRenderer::drawPixelsShader<fading>(x, drawRange, depth, u, vStart, vEnd, normal, texture,
+		SoftwareRenderer::drawPixelsShader<fading>(x, voxel, drawRange, depth, u, vStart, vEnd, normal, texture,
 			fadePercent, lightContributionPercent, shadingInfo, occlusion, frame);
 	}
 	else
 	{
 		constexpr bool fading = true;
-		SoftwareRenderer::drawPixelsShader<fading>(x, drawRange, depth, u, vStart, vEnd, normal, texture,
+		SoftwareRenderer::drawPixelsShader<fading>(x, voxel, drawRange, depth, u, vStart, vEnd, normal, texture,
 			fadePercent, lightContributionPercent, shadingInfo, occlusion, frame);
 	}
 }
 
 template <bool Fading>
-void SoftwareRenderer::drawPerspectivePixelsShader(int x, const DrawRange &drawRange,
+void SoftwareRenderer::drawPerspectivePixelsShader(int x, const NewInt3 &voxel, const DrawRange &drawRange,
 	const NewDouble2 &startPoint, const NewDouble2 &endPoint, double depthStart, double depthEnd,
 	const Double3 &normal, const VoxelTexture &texture, double fadePercent,
 	const BufferView<const VisibleLight> &visLights, const VisibleLightList &visLightList,
@@ -3605,6 +4372,9 @@ void SoftwareRenderer::drawPerspectivePixelsShader(int x, const DrawRange &drawR
 	int yStart = drawRange.yStart;
 	int yEnd = drawRange.yEnd;
 
+	// Value for the hit buffer, if it's in use.
+	const uint32_t hitID = (frame.hitIDs != nullptr) ? MakeVoxelHitID(voxel, normal) : HitTypeNone;
+
 	// Fog color to interpolate with.
 	const Double3 &fogColor = shadingInfo.getFogColor();
 
@@ -3699,11 +4469,16 @@ void SoftwareRenderer::drawPerspectivePixelsShader(int x, const DrawRange &drawR
 
 			frame.colorBuffer[index] = colorRGB;
 			frame.depthBuffer[index] = depth;
+
+			if (frame.hitIDs != nullptr)
+			{
+				frame.hitIDs[index] = hitID;
+			}
 		}
 	}
 }
 
-void SoftwareRenderer::drawPerspectivePixels(int x, const DrawRange &drawRange,
+void SoftwareRenderer::drawPerspectivePixels(int x, const NewInt3 &voxel, const DrawRange &drawRange,
 	const NewDouble2 &startPoint, const NewDouble2 &endPoint, double depthStart, double depthEnd,
 	const Double3 &normal, const VoxelTexture &texture, double fadePercent,
 	const BufferView<const VisibleLight> &visLights, const VisibleLightList &visLightList,
@@ -3712,20 +4487,66 @@ void SoftwareRenderer::drawPerspectivePixels(int x, const DrawRange &drawRange,
 	if (fadePercent == 1.0)
 	{
 		constexpr bool fading = false;
-		SoftwareRenderer::drawPerspectivePixelsShader<fading>(x, drawRange, startPoint, endPoint,
+		SoftwareRenderer::drawPerspectivePixelsShader<fading>(x, voxel, drawRange, startPoint, endPoint,
 			depthStart, depthEnd, normal, texture, fadePercent, visLights, visLightList,
 			shadingInfo, occlusion, frame);
 	}
 	else
 	{
 		constexpr bool fading = true;
-		SoftwareRenderer::drawPerspectivePixelsShader<fading>(x, drawRange, startPoint, endPoint,
+		SoftwareRenderer::drawPerspectivePixelsShader<fading>(x, voxel, drawRange, startPoint, endPoint,
 			depthStart, depthEnd, normal, texture, fadePercent, visLights, visLightList,
 			shadingInfo, occlusion, frame);
 	}
 }
 
-void SoftwareRenderer::drawTransparentPixels(int x, const DrawRange &drawRange, double depth,
+void SoftwareRenderer::drawPlanePixels(int x, const NewInt3 &voxel, const DrawRange &drawRange, const NewDouble2 &startPoint,
+	const NewDouble2 &endPoint, double depthStart, double depthEnd, double planeY, const Double3 &normal,
+	const VoxelTexture &texture, double fadePercent, const BufferView<const VisibleLight> &visLights,
+	const VisibleLightList &visLightList, const ShadingInfo &shadingInfo, OcclusionData &occlusion,
+	const FrameView &frame)
+{
+	std::vector<PlaneSpan> &columnSpans = frame.planeSpans[x];
+
+	// Fading voxels need per-pixel fade shading, so they are drawn immediately like before. So is
+	// anything past the span ID limit of the column.
+	constexpr int maxSpanCount = std::numeric_limits<uint16_t>::max();
+	const bool canDefer = (fadePercent == 1.0) && (static_cast<int>(columnSpans.size()) < maxSpanCount);
+	if (!canDefer)
+	{
+		SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRange, startPoint, endPoint, depthStart, depthEnd,
+			normal, texture, fadePercent, visLights, visLightList, shadingInfo, occlusion, frame);
+		return;
+	}
+
+	int yStart = drawRange.yStart;
+	int yEnd = drawRange.yEnd;
+
+	// Clip the Y start and end coordinates as needed, and refresh the occlusion buffer.
+	occlusion.clipRange(&yStart, &yEnd);
+	occlusion.update(yStart, yEnd);
+
+	if (yStart >= yEnd)
+	{
+		return;
+	}
+
+	columnSpans.emplace_back(texture, visLightList, planeY, voxel.y, normal);
+	const uint16_t spanID = static_cast<uint16_t>(columnSpans.size());
+
+	// Claim the pixels for this plane. Planes are recorded near to far, so a pixel already claimed
+	// by an earlier plane in this column keeps it (same as a failed depth test).
+	for (int y = yStart; y < yEnd; y++)
+	{
+		uint16_t &pixelSpanID = frame.planeSpanIDs[x + (y * frame.width)];
+		if (pixelSpanID == 0)
+		{
+			pixelSpanID = spanID;
+		}
+	}
+}
+
+void SoftwareRenderer::drawTransparentPixels(int x, const NewInt3 &voxel, const DrawRange &drawRange, double depth,
 	double u, double vStart, double vEnd, const Double3 &normal, const VoxelTexture &texture,
 	double lightContributionPercent, const ShadingInfo &shadingInfo,
 	const OcclusionData &occlusion, const FrameView &frame)
@@ -3736,6 +4557,9 @@ void SoftwareRenderer::drawTransparentPixels(int x, const DrawRange &drawRange,
 	int yStart = drawRange.yStart;
 	int yEnd = drawRange.yEnd;
 
+	// Value for the hit buffer, if it's in use.
+	const uint32_t hitID = (frame.hitIDs != nullptr) ? MakeVoxelHitID(voxel, normal) : HitTypeNone;
+
 	// Horizontal offset in texture.
 	// - Taken care of in texture sampling function (redundant calculation, though).
 	//const int textureX = static_cast<int>(u * static_cast<double>(texture.width));
@@ -3804,13 +4628,18 @@ void SoftwareRenderer::drawTransparentPixels(int x, const DrawRange &drawRange,
 
 				frame.colorBuffer[index] = colorRGB;
 				frame.depthBuffer[index] = depth;
+
+				if (frame.hitIDs != nullptr)
+				{
+					frame.hitIDs[index] = hitID;
+				}
 			}
 		}
 	}
 }
 
 template <bool AmbientShading, bool TrueDepth>
-void SoftwareRenderer::drawChasmPixelsShader(int x, const DrawRange &drawRange, double depth,
+void SoftwareRenderer::drawChasmPixelsShader(int x, const NewInt3 &voxel, const DrawRange &drawRange, double depth,
 	double u, double vStart, double vEnd, const Double3 &normal, const VoxelTexture &texture,
 	const ChasmTexture &chasmTexture, double lightContributionPercent, const ShadingInfo &shadingInfo,
 	OcclusionData &occlusion, const FrameView &frame)
@@ -3821,6 +4650,9 @@ void SoftwareRenderer::drawChasmPixelsShader(int x, const DrawRange &drawRange,
 	int yStart = drawRange.yStart;
 	int yEnd = drawRange.yEnd;
 
+	// Value for the hit buffer, if it's in use.
+	const uint32_t hitID = (frame.hitIDs != nullptr) ? MakeVoxelHitID(voxel, normal) : HitTypeNone;
+
 	// Horizontal offset in texture.
 	// - Taken care of in texture sampling function (redundant calculation, though).
 	//const int textureX = static_cast<int>(u * static_cast<double>(texture.width));
@@ -3892,6 +4724,11 @@ void SoftwareRenderer::drawChasmPixelsShader(int x, const DrawRange &drawRange,
 
 				frame.colorBuffer[index] = colorRGB;
 				frame.depthBuffer[index] = depth;
+
+				if (frame.hitIDs != nullptr)
+				{
+					frame.hitIDs[index] = hitID;
+				}
 			}
 			else
 			{
@@ -3924,12 +4761,18 @@ void SoftwareRenderer::drawChasmPixelsShader(int x, const DrawRange &drawRange,
 				{
 					frame.depthBuffer[index] = DEPTH_BUFFER_INFINITY;
 				}
+
+				// Chasm walls without a true depth can't be picked from the frame.
+				if (frame.hitIDs != nullptr)
+				{
+					frame.hitIDs[index] = TrueDepth ? hitID : HitTypeNone;
+				}
 			}
 		}
 	}
 }
 
-void SoftwareRenderer::drawChasmPixels(int x, const DrawRange &drawRange, double depth, double u,
+void SoftwareRenderer::drawChasmPixels(int x, const NewInt3 &voxel, const DrawRange &drawRange, double depth, double u,
 	double vStart, double vEnd, const Double3 &normal, bool emissive, const VoxelTexture &texture,
 	const ChasmTexture &chasmTexture, double lightContributionPercent, const ShadingInfo &shadingInfo,
 	OcclusionData &occlusion, const FrameView &frame)
@@ -3943,14 +4786,14 @@ void SoftwareRenderer::drawChasmPixels(int x, const DrawRange &drawRange, double
 		if (useTrueChasmDepth)
 		{
 			constexpr bool trueDepth = true;
-			SoftwareRenderer::drawChasmPixelsShader<ambientShading, trueDepth>(x, drawRange, depth,
+			SoftwareRenderer::drawChasmPixelsShader<ambientShading, trueDepth>(x, voxel, drawRange, depth,
 				u, vStart, vEnd, normal, texture, chasmTexture, lightContributionPercent, shadingInfo,
 				occlusion, frame);
 		}
 		else
 		{
 			constexpr bool trueDepth = false;
-			SoftwareRenderer::drawChasmPixelsShader<ambientShading, trueDepth>(x, drawRange, depth,
+			SoftwareRenderer::drawChasmPixelsShader<ambientShading, trueDepth>(x, voxel, drawRange, depth,
 				u, vStart, vEnd, normal, texture, chasmTexture, lightContributionPercent, shadingInfo,
 				occlusion, frame);
 		}
@@ -3961,14 +4804,14 @@ void SoftwareRenderer::drawChasmPixels(int x, const DrawRange &drawRange, double
 		if (useTrueChasmDepth)
 		{
 			constexpr bool trueDepth = true;
-			SoftwareRenderer::drawChasmPixelsShader<ambientShading, trueDepth>(x, drawRange, depth,
+			SoftwareRenderer::drawChasmPixelsShader<ambientShading, trueDepth>(x, voxel, drawRange, depth,
 				u, vStart, vEnd, normal, texture, chasmTexture, lightContributionPercent, shadingInfo,
 				occlusion, frame);
 		}
 		else
 		{
 			constexpr bool trueDepth = false;
-			SoftwareRenderer::drawChasmPixelsShader<ambientShading, trueDepth>(x, drawRange, depth,
+			SoftwareRenderer::drawChasmPixelsShader<ambientShading, trueDepth>(x, voxel, drawRange, depth,
 				u, vStart, vEnd, normal, texture, chasmTexture, lightContributionPercent, shadingInfo,
 				occlusion, frame);
 		}
@@ -3976,7 +4819,7 @@ void SoftwareRenderer::drawChasmPixels(int x, const DrawRange &drawRange, double
 }
 
 template <bool AmbientShading, bool TrueDepth>
-void SoftwareRenderer::drawPerspectiveChasmPixelsShader(int x, const DrawRange &drawRange,
+void SoftwareRenderer::drawPerspectiveChasmPixelsShader(int x, const NewInt3 &voxel, const DrawRange &drawRange,
 	const NewDouble2 &startPoint, const NewDouble2 &endPoint, double depthStart, double depthEnd,
 	const Double3 &normal, const ChasmTexture &texture, const ShadingInfo &shadingInfo,
 	OcclusionData &occlusion, const FrameView &frame)
@@ -3987,6 +4830,9 @@ void SoftwareRenderer::drawPerspectiveChasmPixelsShader(int x, const DrawRange &
 	int yStart = drawRange.yStart;
 	int yEnd = drawRange.yEnd;
 
+	// Value for the hit buffer, if it's in use.
+	const uint32_t hitID = (frame.hitIDs != nullptr) ? MakeVoxelHitID(voxel, normal) : HitTypeNone;
+
 	// Fog color to interpolate with.
 	const Double3 &fogColor = shadingInfo.getFogColor();
 
@@ -4062,11 +4908,17 @@ void SoftwareRenderer::drawPerspectiveChasmPixelsShader(int x, const DrawRange &
 			{
 				frame.depthBuffer[index] = DEPTH_BUFFER_INFINITY;
 			}
+
+			// Chasm walls without a true depth can't be picked from the frame.
+			if (frame.hitIDs != nullptr)
+			{
+				frame.hitIDs[index] = TrueDepth ? hitID : HitTypeNone;
+			}
 		}
 	}
 }
 
-void SoftwareRenderer::drawPerspectiveChasmPixels(int x, const DrawRange &drawRange,
+void SoftwareRenderer::drawPerspectiveChasmPixels(int x, const NewInt3 &voxel, const DrawRange &drawRange,
 	const NewDouble2 &startPoint, const NewDouble2 &endPoint, double depthStart, double depthEnd,
 	const Double3 &normal, bool emissive, const ChasmTexture &texture,
 	const ShadingInfo &shadingInfo, OcclusionData &occlusion, const FrameView &frame)
@@ -4081,14 +4933,14 @@ void SoftwareRenderer::drawPerspectiveChasmPixels(int x, const DrawRange &drawRa
 		{
 			constexpr bool trueDepth = true;
 			SoftwareRenderer::drawPerspectiveChasmPixelsShader<ambientShading, trueDepth>(
-				x, drawRange, startPoint, endPoint, depthStart, depthEnd, normal, texture,
+				x, voxel, drawRange, startPoint, endPoint, depthStart, depthEnd, normal, texture,
 				shadingInfo, occlusion, frame);
 		}
 		else
 		{
 			constexpr bool trueDepth = false;
 			SoftwareRenderer::drawPerspectiveChasmPixelsShader<ambientShading, trueDepth>(
-				x, drawRange, startPoint, endPoint, depthStart, depthEnd, normal, texture,
+				x, voxel, drawRange, startPoint, endPoint, depthStart, depthEnd, normal, texture,
 				shadingInfo, occlusion, frame);
 		}
 	}
@@ -4099,14 +4951,14 @@ void SoftwareRenderer::drawPerspectiveChasmPixels(int x, const DrawRange &drawRa
 		{
 			constexpr bool trueDepth = true;
 			SoftwareRenderer::drawPerspectiveChasmPixelsShader<ambientShading, trueDepth>(
-				x, drawRange, startPoint, endPoint, depthStart, depthEnd, normal, texture,
+				x, voxel, drawRange, startPoint, endPoint, depthStart, depthEnd, normal, texture,
 				shadingInfo, occlusion, frame);
 		}
 		else
 		{
 			constexpr bool trueDepth = false;
 			SoftwareRenderer::drawPerspectiveChasmPixelsShader<ambientShading, trueDepth>(
-				x, drawRange, startPoint, endPoint, depthStart, depthEnd, normal, texture,
+				x, voxel, drawRange, startPoint, endPoint, depthStart, depthEnd, normal, texture,
 				shadingInfo, occlusion, frame);
 		}
 	}
@@ -4577,6 +5429,52 @@ void SoftwareRenderer::drawMoonPixels(int x, const DrawRange &drawRange, double
 	}
 }
 
+bool SoftwareRenderer::tryGetStarPixelColor(const Double3 &starColor, const Double3 &gradientColor,
+	uint32_t *outColor)
+{
+	// If the gradient color behind the star is dark enough, then draw. Interpolate with a
+	// range of intensities so stars don't immediately blink on/off when the gradient is a
+	// certain color. Stars are generally small so I think it's okay to do more expensive
+	// per-pixel operations here.
+	constexpr double visThreshold = ShadingInfo::STAR_VIS_THRESHOLD; // Stars are becoming visible.
+	constexpr double brightestThreshold = 32.0 / 255.0; // Stars are brightest.
+
+	const double brightestComponent = std::max(
+		std::max(gradientColor.x, gradientColor.y), gradientColor.z);
+	const bool isDarkEnough = brightestComponent <= visThreshold;
+	if (!isDarkEnough)
+	{
+		return false;
+	}
+
+	const double gradientVisPercent = std::clamp(
+		(brightestComponent - brightestThreshold) / (visThreshold - brightestThreshold),
+		0.0, 1.0);
+
+	// Texture color with shading.
+	double colorR = starColor.x;
+	double colorG = starColor.y;
+	double colorB = starColor.z;
+
+	// Lerp with sky gradient for smoother transition between day and night.
+	colorR += (gradientColor.x - colorR) * gradientVisPercent;
+	colorG += (gradientColor.y - colorG) * gradientVisPercent;
+	colorB += (gradientColor.z - colorB) * gradientVisPercent;
+
+	// Clamp maximum (don't worry about negative values).
+	const double high = 1.0;
+	colorR = (colorR > high) ? high : colorR;
+	colorG = (colorG > high) ? high : colorG;
+	colorB = (colorB > high) ? high : colorB;
+
+	// Convert floats to integers.
+	*outColor = static_cast<uint32_t>(
+		((static_cast<uint8_t>(colorR * 255.0)) << 16) |
+		((static_cast<uint8_t>(colorG * 255.0)) << 8) |
+		((static_cast<uint8_t>(colorB * 255.0))));
+	return true;
+}
+
 void SoftwareRenderer::drawStarPixels(int x, const DrawRange &drawRange, double u, double vStart,
 	double vEnd, const SkyTexture &texture, const Buffer<Double3> &skyGradientRowCache,
 	const ShadingInfo &shadingInfo, const FrameView &frame)
@@ -4613,52 +5511,33 @@ void SoftwareRenderer::drawStarPixels(int x, const DrawRange &drawRange, double
 		{
 			// Get gradient color from sky gradient row cache.
 			const Double3 &gradientColor = skyGradientRowCache.get(y);
+			const Double3 texelColor(texel.r, texel.g, texel.b);
 
-			// If the gradient color behind the star is dark enough, then draw. Interpolate with a
-			// range of intensities so stars don't immediately blink on/off when the gradient is a
-			// certain color. Stars are generally small so I think it's okay to do more expensive
-			// per-pixel operations here.
-			constexpr double visThreshold = ShadingInfo::STAR_VIS_THRESHOLD; // Stars are becoming visible.
-			constexpr double brightestThreshold = 32.0 / 255.0; // Stars are brightest.
-
-			const double brightestComponent = std::max(
-				std::max(gradientColor.x, gradientColor.y), gradientColor.z);
-			const bool isDarkEnough = brightestComponent <= visThreshold;
-
-			if (isDarkEnough)
+			uint32_t colorRGB;
+			if (SoftwareRenderer::tryGetStarPixelColor(texelColor, gradientColor, &colorRGB))
 			{
-				const double gradientVisPercent = std::clamp(
-					(brightestComponent - brightestThreshold) / (visThreshold - brightestThreshold),
-					0.0, 1.0);
-
-				// Texture color with shading.
-				double colorR = texel.r;
-				double colorG = texel.g;
-				double colorB = texel.b;
-
-				// Lerp with sky gradient for smoother transition between day and night.
-				colorR += (gradientColor.x - colorR) * gradientVisPercent;
-				colorG += (gradientColor.y - colorG) * gradientVisPercent;
-				colorB += (gradientColor.z - colorB) * gradientVisPercent;
-
-				// Clamp maximum (don't worry about negative values).
-				const double high = 1.0;
-				colorR = (colorR > high) ? high : colorR;
-				colorG = (colorG > high) ? high : colorG;
-				colorB = (colorB > high) ? high : colorB;
-
-				// Convert floats to integers.
-				const uint32_t colorRGB = static_cast<uint32_t>(
-					((static_cast<uint8_t>(colorR * 255.0)) << 16) |
-					((static_cast<uint8_t>(colorG * 255.0)) << 8) |
-					((static_cast<uint8_t>(colorB * 255.0))));
-
 				frame.colorBuffer[index] = colorRGB;
 			}
 		}
 	}
 }
 
+void SoftwareRenderer::drawSmallStarPixels(int x, int yStart, int yEnd, const Double3 &color,
+	const Buffer<Double3> &skyGradientRowCache, const FrameView &frame)
+{
+	for (int y = yStart; y < yEnd; y++)
+	{
+		const Double3 &gradientColor = skyGradientRowCache.get(y);
+
+		uint32_t colorRGB;
+		if (SoftwareRenderer::tryGetStarPixelColor(color, gradientColor, &colorRGB))
+		{
+			const int index = x + (y * frame.width);
+			frame.colorBuffer[index] = colorRGB;
+		}
+	}
+}
+
 void SoftwareRenderer::drawInitialVoxelSameFloor(int x, SNInt voxelX, int voxelY, WEInt voxelZ,
 	const Camera &camera, const Ray &ray, VoxelFacing2D facing, const NewDouble2 &nearPoint,
 	const NewDouble2 &farPoint, double nearZ, double farZ, double wallU, const Double3 &wallNormal,
@@ -4670,6 +5549,7 @@ void SoftwareRenderer::drawInitialVoxelSameFloor(int x, SNInt voxelX, int voxelY
 	const auto &voxelGrid = levelData.getVoxelGrid();
 	const uint16_t voxelID = voxelGrid.getVoxel(voxelX, voxelY, voxelZ);
 	const VoxelDefinition &voxelDef = voxelGrid.getVoxelDef(voxelID);
+	const NewInt3 voxel(voxelX, voxelY, voxelZ);
 	const double voxelHeight = ceilingHeight;
 	const double voxelYReal = static_cast<double>(voxelY) * voxelHeight;
 
@@ -4682,8 +5562,6 @@ void SoftwareRenderer::drawInitialVoxelSameFloor(int x, SNInt voxelX, int voxelY
 	if (voxelDef.type == ArenaTypes::VoxelType::Wall)
 	{
 		// Draw inner ceiling, wall, and floor.
-		const VoxelDefinition::WallData &wallData = voxelDef.wall;
-
 		const NewDouble3 farCeilingPoint(
 			farPoint.x,
 			voxelYReal + voxelHeight,
@@ -4707,20 +5585,20 @@ void SoftwareRenderer::drawInitialVoxelSameFloor(int x, SNInt voxelX, int voxelY
 			voxelX, voxelY, voxelZ, levelData);
 
 		// Ceiling.
-		SoftwareRenderer::drawPerspectivePixels(x, drawRanges.at(0), nearPoint, farPoint,
-			nearZ, farZ, -Double3::UnitY, textures.getTexture(wallData.ceilingTextureAssetRef),
+		SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRanges.at(0), nearPoint, farPoint,
+			nearZ, farZ, -Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_CEILING),
 			fadePercent, visLights, visLightList, shadingInfo, occlusion, frame);
 
 		// Wall.
 		const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 			LightContributionCap>(farPoint, visLights, visLightList);
-		SoftwareRenderer::drawPixels(x, drawRanges.at(1), farZ, wallU, 0.0,
-			Constants::JustBelowOne, wallNormal, textures.getTexture(wallData.sideTextureAssetRef),
+		SoftwareRenderer::drawPixels(x, voxel, drawRanges.at(1), farZ, wallU, 0.0,
+			Constants::JustBelowOne, wallNormal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 			fadePercent, wallLightPercent, shadingInfo, occlusion, frame);
 
 		// Floor.
-		SoftwareRenderer::drawPerspectivePixels(x, drawRanges.at(2), farPoint, nearPoint,
-			farZ, nearZ, Double3::UnitY, textures.getTexture(wallData.floorTextureAssetRef),
+		SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRanges.at(2), farPoint, nearPoint,
+			farZ, nearZ, Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_FLOOR),
 			fadePercent, visLights, visLightList, shadingInfo, occlusion, frame);
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::Floor)
@@ -4732,8 +5610,6 @@ void SoftwareRenderer::drawInitialVoxelSameFloor(int x, SNInt voxelX, int voxelY
 		// Draw bottom of ceiling voxel if the camera is below it.
 		if (absoluteEye.y < voxelYReal)
 		{
-			const VoxelDefinition::CeilingData &ceilingData = voxelDef.ceiling;
-
 			const NewDouble3 nearFloorPoint(
 				nearPoint.x,
 				voxelYReal,
@@ -4748,9 +5624,9 @@ void SoftwareRenderer::drawInitialVoxelSameFloor(int x, SNInt voxelX, int voxelY
 			const double fadePercent = RendererUtils::getFadingVoxelPercent(
 				voxelX, voxelY, voxelZ, levelData);
 
-			SoftwareRenderer::drawPerspectivePixels(x, drawRange, nearPoint, farPoint, nearZ,
-				farZ, -Double3::UnitY, textures.getTexture(ceilingData.textureAssetRef), fadePercent,
-				visLights, visLightList, shadingInfo, occlusion, frame);
+			SoftwareRenderer::drawPlanePixels(x, voxel, drawRange, nearPoint, farPoint, nearZ,
+				farZ, nearFloorPoint.y, -Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
+				fadePercent, visLights, visLightList, shadingInfo, occlusion, frame);
 		}
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::Raised)
@@ -4781,8 +5657,8 @@ void SoftwareRenderer::drawInitialVoxelSameFloor(int x, SNInt voxelX, int voxelY
 				voxelX, voxelY, voxelZ, levelData);
 
 			// Ceiling.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRange, farPoint, nearPoint, farZ,
-				nearZ, Double3::UnitY, textures.getTexture(raisedData.ceilingTextureAssetRef), fadePercent,
+			SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRange, farPoint, nearPoint, farZ,
+				nearZ, Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_CEILING), fadePercent,
 				visLights, visLightList, shadingInfo, occlusion, frame);
 		}
 		else if (absoluteEye.y < nearFloorPoint.y)
@@ -4799,8 +5675,8 @@ void SoftwareRenderer::drawInitialVoxelSameFloor(int x, SNInt voxelX, int voxelY
 				voxelX, voxelY, voxelZ, levelData);
 
 			// Floor.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRange, nearPoint, farPoint, nearZ,
-				farZ, -Double3::UnitY, textures.getTexture(raisedData.floorTextureAssetRef), fadePercent,
+			SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRange, nearPoint, farPoint, nearZ,
+				farZ, -Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_FLOOR), fadePercent,
 				visLights, visLightList, shadingInfo, occlusion, frame);
 		}
 		else
@@ -4822,20 +5698,20 @@ void SoftwareRenderer::drawInitialVoxelSameFloor(int x, SNInt voxelX, int voxelY
 				voxelX, voxelY, voxelZ, levelData);
 
 			// Ceiling.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRanges.at(0), nearPoint, farPoint,
-				nearZ, farZ, -Double3::UnitY, textures.getTexture(raisedData.ceilingTextureAssetRef), fadePercent,
+			SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRanges.at(0), nearPoint, farPoint,
+				nearZ, farZ, -Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_CEILING), fadePercent,
 				visLights, visLightList, shadingInfo, occlusion, frame);
 
 			// Wall.
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(farPoint, visLights, visLightList);
-			SoftwareRenderer::drawTransparentPixels(x, drawRanges.at(1), farZ, wallU,
-				raisedData.vTop, raisedData.vBottom, wallNormal, textures.getTexture(raisedData.sideTextureAssetRef),
+			SoftwareRenderer::drawTransparentPixels(x, voxel, drawRanges.at(1), farZ, wallU,
+				raisedData.vTop, raisedData.vBottom, wallNormal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 				wallLightPercent, shadingInfo, occlusion, frame);
 
 			// Floor.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRanges.at(2), farPoint, nearPoint,
-				farZ, nearZ, Double3::UnitY, textures.getTexture(raisedData.floorTextureAssetRef), fadePercent,
+			SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRanges.at(2), farPoint, nearPoint,
+				farZ, nearZ, Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_FLOOR), fadePercent,
 				visLights, visLightList, shadingInfo, occlusion, frame);
 		}
 	}
@@ -4867,8 +5743,8 @@ void SoftwareRenderer::drawInitialVoxelSameFloor(int x, SNInt voxelX, int voxelY
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(hit.point, visLights, visLightList);
 
-			SoftwareRenderer::drawPixels(x, drawRange, nearZ + hit.innerZ, hit.u, 0.0,
-				Constants::JustBelowOne, hit.normal, textures.getTexture(diagData.textureAssetRef), fadePercent,
+			SoftwareRenderer::drawPixels(x, voxel, drawRange, nearZ + hit.innerZ, hit.u, 0.0,
+				Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), fadePercent,
 				wallLightPercent, shadingInfo, occlusion, frame);
 		}
 	}
@@ -4902,8 +5778,8 @@ void SoftwareRenderer::drawInitialVoxelSameFloor(int x, SNInt voxelX, int voxelY
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(hit.point, visLights, visLightList);
 
-			SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ + hit.innerZ, hit.u,
-				0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(edgeData.textureAssetRef),
+			SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ + hit.innerZ, hit.u,
+				0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 				wallLightPercent, shadingInfo, occlusion, frame);
 		}
 	}
@@ -4947,7 +5823,7 @@ void SoftwareRenderer::drawInitialVoxelSameFloor(int x, SNInt voxelX, int voxelY
 
 		// Chasm floor (drawn before far wall for occlusion buffer).
 		const Double3 floorNormal = Double3::UnitY;
-		SoftwareRenderer::drawPerspectiveChasmPixels(x, drawRanges.at(1), farPoint, nearPoint,
+		SoftwareRenderer::drawPerspectiveChasmPixels(x, voxel, drawRanges.at(1), farPoint, nearPoint,
 			farZ, nearZ, floorNormal, RendererUtils::isChasmEmissive(chasmData.type),
 			*chasmTexture, shadingInfo, occlusion, frame);
 
@@ -4983,9 +5859,9 @@ void SoftwareRenderer::drawInitialVoxelSameFloor(int x, SNInt voxelX, int voxelY
 				LightContributionCap>(farPoint, visLights, visLightList);
 
 			const Double3 farNormal = -VoxelUtils::getNormal(farFacing);
-			SoftwareRenderer::drawChasmPixels(x, drawRanges.at(0), farZ, farU, 0.0,
+			SoftwareRenderer::drawChasmPixels(x, voxel, drawRanges.at(0), farZ, farU, 0.0,
 				Constants::JustBelowOne, farNormal, RendererUtils::isChasmEmissive(chasmData.type),
-				textures.getTexture(chasmData.textureAssetRef), *chasmTexture, wallLightPercent, shadingInfo, occlusion, frame);
+				textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), *chasmTexture, wallLightPercent, shadingInfo, occlusion, frame);
 		}
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::Door)
@@ -5015,8 +5891,8 @@ void SoftwareRenderer::drawInitialVoxelSameFloor(int x, SNInt voxelX, int voxelY
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ + hit.innerZ,
-					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(doorData.textureAssetRef),
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ + hit.innerZ,
+					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 					wallLightPercent, shadingInfo, occlusion, frame);
 			}
 			else if (doorData.type == ArenaTypes::DoorType::Sliding)
@@ -5035,8 +5911,8 @@ void SoftwareRenderer::drawInitialVoxelSameFloor(int x, SNInt voxelX, int voxelY
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ + hit.innerZ,
-					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(doorData.textureAssetRef),
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ + hit.innerZ,
+					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 					wallLightPercent, shadingInfo, occlusion, frame);
 			}
 			else if (doorData.type == ArenaTypes::DoorType::Raising)
@@ -5063,9 +5939,9 @@ void SoftwareRenderer::drawInitialVoxelSameFloor(int x, SNInt voxelX, int voxelY
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ + hit.innerZ,
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ + hit.innerZ,
 					hit.u, vStart, Constants::JustBelowOne, hit.normal,
-					textures.getTexture(doorData.textureAssetRef), wallLightPercent, shadingInfo, occlusion, frame);
+					textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), wallLightPercent, shadingInfo, occlusion, frame);
 			}
 			else if (doorData.type == ArenaTypes::DoorType::Splitting)
 			{
@@ -5083,8 +5959,8 @@ void SoftwareRenderer::drawInitialVoxelSameFloor(int x, SNInt voxelX, int voxelY
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ + hit.innerZ,
-					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(doorData.textureAssetRef),
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ + hit.innerZ,
+					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 					wallLightPercent, shadingInfo, occlusion, frame);
 			}
 		}
@@ -5102,6 +5978,7 @@ void SoftwareRenderer::drawInitialVoxelAbove(int x, SNInt voxelX, int voxelY, WE
 	const auto &voxelGrid = levelData.getVoxelGrid();
 	const uint16_t voxelID = voxelGrid.getVoxel(voxelX, voxelY, voxelZ);
 	const VoxelDefinition &voxelDef = voxelGrid.getVoxelDef(voxelID);
+	const NewInt3 voxel(voxelX, voxelY, voxelZ);
 	const double voxelHeight = ceilingHeight;
 	const double voxelYReal = static_cast<double>(voxelY) * voxelHeight;
 
@@ -5113,8 +5990,6 @@ void SoftwareRenderer::drawInitialVoxelAbove(int x, SNInt voxelX, int voxelY, WE
 
 	if (voxelDef.type == ArenaTypes::VoxelType::Wall)
 	{
-		const VoxelDefinition::WallData &wallData = voxelDef.wall;
-
 		const NewDouble3 nearFloorPoint(
 			nearPoint.x,
 			voxelYReal,
@@ -5130,8 +6005,8 @@ void SoftwareRenderer::drawInitialVoxelAbove(int x, SNInt voxelX, int voxelY, WE
 			voxelX, voxelY, voxelZ, levelData);
 
 		// Floor.
-		SoftwareRenderer::drawPerspectivePixels(x, drawRange, nearPoint, farPoint, nearZ,
-			farZ, -Double3::UnitY, textures.getTexture(wallData.floorTextureAssetRef), fadePercent,
+		SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRange, nearPoint, farPoint, nearZ,
+			farZ, -Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_FLOOR), fadePercent,
 			visLights, visLightList, shadingInfo, occlusion, frame);
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::Floor)
@@ -5141,8 +6016,6 @@ void SoftwareRenderer::drawInitialVoxelAbove(int x, SNInt voxelX, int voxelY, WE
 	else if (voxelDef.type == ArenaTypes::VoxelType::Ceiling)
 	{
 		// Draw bottom of ceiling voxel.
-		const VoxelDefinition::CeilingData &ceilingData = voxelDef.ceiling;
-
 		const NewDouble3 nearFloorPoint(
 			nearPoint.x,
 			voxelYReal,
@@ -5157,9 +6030,9 @@ void SoftwareRenderer::drawInitialVoxelAbove(int x, SNInt voxelX, int voxelY, WE
 		const double fadePercent = RendererUtils::getFadingVoxelPercent(
 			voxelX, voxelY, voxelZ, levelData);
 
-		SoftwareRenderer::drawPerspectivePixels(x, drawRange, nearPoint, farPoint, nearZ,
-			farZ, -Double3::UnitY, textures.getTexture(ceilingData.textureAssetRef), fadePercent,
-			visLights, visLightList, shadingInfo, occlusion, frame);
+		SoftwareRenderer::drawPlanePixels(x, voxel, drawRange, nearPoint, farPoint, nearZ,
+			farZ, nearFloorPoint.y, -Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
+			fadePercent, visLights, visLightList, shadingInfo, occlusion, frame);
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::Raised)
 	{
@@ -5189,8 +6062,8 @@ void SoftwareRenderer::drawInitialVoxelAbove(int x, SNInt voxelX, int voxelY, WE
 				voxelX, voxelY, voxelZ, levelData);
 
 			// Ceiling.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRange, farPoint, nearPoint, farZ,
-				nearZ, Double3::UnitY, textures.getTexture(raisedData.ceilingTextureAssetRef), fadePercent,
+			SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRange, farPoint, nearPoint, farZ,
+				nearZ, Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_CEILING), fadePercent,
 				visLights, visLightList, shadingInfo, occlusion, frame);
 		}
 		else if (absoluteEye.y < nearFloorPoint.y)
@@ -5207,8 +6080,8 @@ void SoftwareRenderer::drawInitialVoxelAbove(int x, SNInt voxelX, int voxelY, WE
 				voxelX, voxelY, voxelZ, levelData);
 
 			// Floor.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRange, nearPoint, farPoint, nearZ,
-				farZ, -Double3::UnitY, textures.getTexture(raisedData.floorTextureAssetRef), fadePercent,
+			SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRange, nearPoint, farPoint, nearZ,
+				farZ, -Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_FLOOR), fadePercent,
 				visLights, visLightList, shadingInfo, occlusion, frame);
 		}
 		else
@@ -5230,20 +6103,20 @@ void SoftwareRenderer::drawInitialVoxelAbove(int x, SNInt voxelX, int voxelY, WE
 				voxelX, voxelY, voxelZ, levelData);
 
 			// Ceiling.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRanges.at(0), nearPoint, farPoint,
-				nearZ, farZ, -Double3::UnitY, textures.getTexture(raisedData.ceilingTextureAssetRef), fadePercent,
+			SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRanges.at(0), nearPoint, farPoint,
+				nearZ, farZ, -Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_CEILING), fadePercent,
 				visLights, visLightList, shadingInfo, occlusion, frame);
 
 			// Wall.
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(farPoint, visLights, visLightList);
-			SoftwareRenderer::drawTransparentPixels(x, drawRanges.at(1), farZ, wallU,
+			SoftwareRenderer::drawTransparentPixels(x, voxel, drawRanges.at(1), farZ, wallU,
 				raisedData.vTop, raisedData.vBottom, wallNormal,
-				textures.getTexture(raisedData.sideTextureAssetRef), wallLightPercent, shadingInfo, occlusion, frame);
+				textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), wallLightPercent, shadingInfo, occlusion, frame);
 
 			// Floor.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRanges.at(2), farPoint, nearPoint,
-				farZ, nearZ, Double3::UnitY, textures.getTexture(raisedData.floorTextureAssetRef), fadePercent,
+			SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRanges.at(2), farPoint, nearPoint,
+				farZ, nearZ, Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_FLOOR), fadePercent,
 				visLights, visLightList, shadingInfo, occlusion, frame);
 		}
 	}
@@ -5275,8 +6148,8 @@ void SoftwareRenderer::drawInitialVoxelAbove(int x, SNInt voxelX, int voxelY, WE
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(hit.point, visLights, visLightList);
 
-			SoftwareRenderer::drawPixels(x, drawRange, nearZ + hit.innerZ, hit.u, 0.0,
-				Constants::JustBelowOne, hit.normal, textures.getTexture(diagData.textureAssetRef), fadePercent,
+			SoftwareRenderer::drawPixels(x, voxel, drawRange, nearZ + hit.innerZ, hit.u, 0.0,
+				Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), fadePercent,
 				wallLightPercent, shadingInfo, occlusion, frame);
 		}
 	}
@@ -5310,8 +6183,8 @@ void SoftwareRenderer::drawInitialVoxelAbove(int x, SNInt voxelX, int voxelY, WE
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(hit.point, visLights, visLightList);
 
-			SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ + hit.innerZ, hit.u,
-				0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(edgeData.textureAssetRef),
+			SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ + hit.innerZ, hit.u,
+				0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 				wallLightPercent, shadingInfo, occlusion, frame);
 		}
 	}
@@ -5346,8 +6219,8 @@ void SoftwareRenderer::drawInitialVoxelAbove(int x, SNInt voxelX, int voxelY, WE
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ + hit.innerZ,
-					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(doorData.textureAssetRef),
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ + hit.innerZ,
+					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 					wallLightPercent, shadingInfo, occlusion, frame);
 			}
 			else if (doorData.type == ArenaTypes::DoorType::Sliding)
@@ -5366,8 +6239,8 @@ void SoftwareRenderer::drawInitialVoxelAbove(int x, SNInt voxelX, int voxelY, WE
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ + hit.innerZ,
-					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(doorData.textureAssetRef),
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ + hit.innerZ,
+					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 					wallLightPercent, shadingInfo, occlusion, frame);
 			}
 			else if (doorData.type == ArenaTypes::DoorType::Raising)
@@ -5394,9 +6267,9 @@ void SoftwareRenderer::drawInitialVoxelAbove(int x, SNInt voxelX, int voxelY, WE
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ + hit.innerZ,
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ + hit.innerZ,
 					hit.u, vStart, Constants::JustBelowOne, hit.normal,
-					textures.getTexture(doorData.textureAssetRef), wallLightPercent, shadingInfo, occlusion, frame);
+					textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), wallLightPercent, shadingInfo, occlusion, frame);
 			}
 			else if (doorData.type == ArenaTypes::DoorType::Splitting)
 			{
@@ -5414,8 +6287,8 @@ void SoftwareRenderer::drawInitialVoxelAbove(int x, SNInt voxelX, int voxelY, WE
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ + hit.innerZ,
-					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(doorData.textureAssetRef),
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ + hit.innerZ,
+					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 					wallLightPercent, shadingInfo, occlusion, frame);
 			}
 		}
@@ -5433,6 +6306,7 @@ void SoftwareRenderer::drawInitialVoxelBelow(int x, SNInt voxelX, int voxelY, WE
 	const auto &voxelGrid = levelData.getVoxelGrid();
 	const uint16_t voxelID = voxelGrid.getVoxel(voxelX, voxelY, voxelZ);
 	const VoxelDefinition &voxelDef = voxelGrid.getVoxelDef(voxelID);
+	const NewInt3 voxel(voxelX, voxelY, voxelZ);
 	const double voxelHeight = ceilingHeight;
 	const double voxelYReal = static_cast<double>(voxelY) * voxelHeight;
 
@@ -5444,8 +6318,6 @@ void SoftwareRenderer::drawInitialVoxelBelow(int x, SNInt voxelX, int voxelY, WE
 
 	if (voxelDef.type == ArenaTypes::VoxelType::Wall)
 	{
-		const VoxelDefinition::WallData &wallData = voxelDef.wall;
-
 		const NewDouble3 farCeilingPoint(
 			farPoint.x,
 			voxelYReal + voxelHeight,
@@ -5461,15 +6333,13 @@ void SoftwareRenderer::drawInitialVoxelBelow(int x, SNInt voxelX, int voxelY, WE
 			voxelX, voxelY, voxelZ, levelData);
 
 		// Ceiling.
-		SoftwareRenderer::drawPerspectivePixels(x, drawRange, farPoint, nearPoint, farZ,
-			nearZ, Double3::UnitY, textures.getTexture(wallData.ceilingTextureAssetRef), fadePercent,
+		SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRange, farPoint, nearPoint, farZ,
+			nearZ, Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_CEILING), fadePercent,
 			visLights, visLightList, shadingInfo, occlusion, frame);
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::Floor)
 	{
 		// Draw top of floor voxel.
-		const VoxelDefinition::FloorData &floorData = voxelDef.floor;
-
 		const NewDouble3 farCeilingPoint(
 			farPoint.x,
 			voxelYReal + voxelHeight,
@@ -5485,9 +6355,9 @@ void SoftwareRenderer::drawInitialVoxelBelow(int x, SNInt voxelX, int voxelY, WE
 			voxelX, voxelY, voxelZ, levelData);
 
 		// Ceiling.
-		SoftwareRenderer::drawPerspectivePixels(x, drawRange, farPoint, nearPoint, farZ,
-			nearZ, Double3::UnitY, textures.getTexture(floorData.textureAssetRef), fadePercent,
-			visLights, visLightList, shadingInfo, occlusion, frame);
+		SoftwareRenderer::drawPlanePixels(x, voxel, drawRange, farPoint, nearPoint, farZ,
+			nearZ, farCeilingPoint.y, Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
+			fadePercent, visLights, visLightList, shadingInfo, occlusion, frame);
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::Ceiling)
 	{
@@ -5521,8 +6391,8 @@ void SoftwareRenderer::drawInitialVoxelBelow(int x, SNInt voxelX, int voxelY, WE
 				voxelX, voxelY, voxelZ, levelData);
 
 			// Ceiling.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRange, farPoint, nearPoint, farZ,
-				nearZ, Double3::UnitY, textures.getTexture(raisedData.ceilingTextureAssetRef), fadePercent,
+			SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRange, farPoint, nearPoint, farZ,
+				nearZ, Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_CEILING), fadePercent,
 				visLights, visLightList, shadingInfo, occlusion, frame);
 		}
 		else if (absoluteEye.y < nearFloorPoint.y)
@@ -5539,8 +6409,8 @@ void SoftwareRenderer::drawInitialVoxelBelow(int x, SNInt voxelX, int voxelY, WE
 				voxelX, voxelY, voxelZ, levelData);
 
 			// Floor.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRange, nearPoint, farPoint, nearZ,
-				farZ, -Double3::UnitY, textures.getTexture(raisedData.floorTextureAssetRef), fadePercent,
+			SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRange, nearPoint, farPoint, nearZ,
+				farZ, -Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_FLOOR), fadePercent,
 				visLights, visLightList, shadingInfo, occlusion, frame);
 		}
 		else
@@ -5562,20 +6432,20 @@ void SoftwareRenderer::drawInitialVoxelBelow(int x, SNInt voxelX, int voxelY, WE
 				voxelX, voxelY, voxelZ, levelData);
 
 			// Ceiling.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRanges.at(0), nearPoint, farPoint,
-				nearZ, farZ, -Double3::UnitY, textures.getTexture(raisedData.ceilingTextureAssetRef), fadePercent,
+			SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRanges.at(0), nearPoint, farPoint,
+				nearZ, farZ, -Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_CEILING), fadePercent,
 				visLights, visLightList, shadingInfo, occlusion, frame);
 
 			// Wall.
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(farPoint, visLights, visLightList);
-			SoftwareRenderer::drawTransparentPixels(x, drawRanges.at(1), farZ, wallU,
+			SoftwareRenderer::drawTransparentPixels(x, voxel, drawRanges.at(1), farZ, wallU,
 				raisedData.vTop, raisedData.vBottom, wallNormal,
-				textures.getTexture(raisedData.sideTextureAssetRef), wallLightPercent, shadingInfo, occlusion, frame);
+				textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), wallLightPercent, shadingInfo, occlusion, frame);
 
 			// Floor.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRanges.at(2), farPoint, nearPoint,
-				farZ, nearZ, Double3::UnitY, textures.getTexture(raisedData.floorTextureAssetRef), fadePercent,
+			SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRanges.at(2), farPoint, nearPoint,
+				farZ, nearZ, Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_FLOOR), fadePercent,
 				visLights, visLightList, shadingInfo, occlusion, frame);
 		}
 	}
@@ -5607,8 +6477,8 @@ void SoftwareRenderer::drawInitialVoxelBelow(int x, SNInt voxelX, int voxelY, WE
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(hit.point, visLights, visLightList);
 
-			SoftwareRenderer::drawPixels(x, drawRange, nearZ + hit.innerZ, hit.u, 0.0,
-				Constants::JustBelowOne, hit.normal, textures.getTexture(diagData.textureAssetRef), fadePercent,
+			SoftwareRenderer::drawPixels(x, voxel, drawRange, nearZ + hit.innerZ, hit.u, 0.0,
+				Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), fadePercent,
 				wallLightPercent, shadingInfo, occlusion, frame);
 		}
 	}
@@ -5642,8 +6512,8 @@ void SoftwareRenderer::drawInitialVoxelBelow(int x, SNInt voxelX, int voxelY, WE
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(hit.point, visLights, visLightList);
 
-			SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ + hit.innerZ, hit.u,
-				0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(edgeData.textureAssetRef),
+			SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ + hit.innerZ, hit.u,
+				0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 				wallLightPercent, shadingInfo, occlusion, frame);
 		}
 	}
@@ -5687,7 +6557,7 @@ void SoftwareRenderer::drawInitialVoxelBelow(int x, SNInt voxelX, int voxelY, WE
 
 		// Chasm floor (drawn before far wall for occlusion buffer).
 		const Double3 floorNormal = Double3::UnitY;
-		SoftwareRenderer::drawPerspectiveChasmPixels(x, drawRanges.at(1), farPoint, nearPoint,
+		SoftwareRenderer::drawPerspectiveChasmPixels(x, voxel, drawRanges.at(1), farPoint, nearPoint,
 			farZ, nearZ, floorNormal, RendererUtils::isChasmEmissive(chasmData.type),
 			*chasmTexture, shadingInfo, occlusion, frame);
 
@@ -5723,9 +6593,9 @@ void SoftwareRenderer::drawInitialVoxelBelow(int x, SNInt voxelX, int voxelY, WE
 				LightContributionCap>(farPoint, visLights, visLightList);
 
 			const Double3 farNormal = -VoxelUtils::getNormal(farFacing);
-			SoftwareRenderer::drawChasmPixels(x, drawRanges.at(0), farZ, farU, 0.0,
+			SoftwareRenderer::drawChasmPixels(x, voxel, drawRanges.at(0), farZ, farU, 0.0,
 				Constants::JustBelowOne, farNormal, RendererUtils::isChasmEmissive(chasmData.type),
-				textures.getTexture(chasmData.textureAssetRef), *chasmTexture, wallLightPercent, shadingInfo, occlusion, frame);
+				textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), *chasmTexture, wallLightPercent, shadingInfo, occlusion, frame);
 		}
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::Door)
@@ -5755,8 +6625,8 @@ void SoftwareRenderer::drawInitialVoxelBelow(int x, SNInt voxelX, int voxelY, WE
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ + hit.innerZ,
-					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(doorData.textureAssetRef),
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ + hit.innerZ,
+					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 					wallLightPercent, shadingInfo, occlusion, frame);
 			}
 			else if (doorData.type == ArenaTypes::DoorType::Sliding)
@@ -5775,8 +6645,8 @@ void SoftwareRenderer::drawInitialVoxelBelow(int x, SNInt voxelX, int voxelY, WE
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ + hit.innerZ,
-					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(doorData.textureAssetRef),
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ + hit.innerZ,
+					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 					wallLightPercent, shadingInfo, occlusion, frame);
 			}
 			else if (doorData.type == ArenaTypes::DoorType::Raising)
@@ -5803,9 +6673,9 @@ void SoftwareRenderer::drawInitialVoxelBelow(int x, SNInt voxelX, int voxelY, WE
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ + hit.innerZ,
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ + hit.innerZ,
 					hit.u, vStart, Constants::JustBelowOne, hit.normal,
-					textures.getTexture(doorData.textureAssetRef), wallLightPercent, shadingInfo, occlusion, frame);
+					textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), wallLightPercent, shadingInfo, occlusion, frame);
 			}
 			else if (doorData.type == ArenaTypes::DoorType::Splitting)
 			{
@@ -5823,8 +6693,8 @@ void SoftwareRenderer::drawInitialVoxelBelow(int x, SNInt voxelX, int voxelY, WE
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ + hit.innerZ,
-					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(doorData.textureAssetRef),
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ + hit.innerZ,
+					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 					wallLightPercent, shadingInfo, occlusion, frame);
 			}
 		}
@@ -5883,18 +6753,43 @@ void SoftwareRenderer::drawInitialVoxelColumn(int x, SNInt voxelX, WEInt voxelZ,
 		nearPoint, farPoint, nearZ, farZ, wallU, wallNormal, shadingInfo, chunkDistance, ceilingHeight,
 		levelData, visLights, visLightLists, textures, chasmTextureGroups, occlusion, frame);
 
+	// Only non-air heights in the column are visited, and drawing stops once the column
+	// is fully occluded.
+	const auto &voxelGrid = levelData.getVoxelGrid();
+	const VoxelGrid::ColumnMask columnMask = voxelGrid.getColumnMask(voxelX, voxelZ);
+
 	// Draw voxels below the player's voxel.
 	for (int voxelY = (adjustedVoxelY - 1); voxelY >= 0; voxelY--)
 	{
+		if (occlusion.yMin == occlusion.yMax)
+		{
+			return;
+		}
+
+		if ((columnMask & (static_cast<VoxelGrid::ColumnMask>(1) << voxelY)) == 0)
+		{
+			continue;
+		}
+
 		SoftwareRenderer::drawInitialVoxelBelow(x, voxelX, voxelY, voxelZ, camera, ray, facing, nearPoint,
 			farPoint, nearZ, farZ, wallU, wallNormal, shadingInfo, chunkDistance, ceilingHeight, levelData,
 			visLights, visLightLists, textures, chasmTextureGroups, occlusion, frame);
 	}
 
 	// Draw voxels above the player's voxel.
-	const auto &voxelGrid = levelData.getVoxelGrid();
 	for (int voxelY = (adjustedVoxelY + 1); voxelY < voxelGrid.getHeight(); voxelY++)
 	{
+		if ((occlusion.yMin == occlusion.yMax) || ((columnMask >> voxelY) == 0))
+		{
+			// Fully occluded or nothing left above.
+			return;
+		}
+
+		if ((columnMask & (static_cast<VoxelGrid::ColumnMask>(1) << voxelY)) == 0)
+		{
+			continue;
+		}
+
 		SoftwareRenderer::drawInitialVoxelAbove(x, voxelX, voxelY, voxelZ, camera, ray, facing, nearPoint,
 			farPoint, nearZ, farZ, wallU, wallNormal, shadingInfo, chunkDistance, ceilingHeight, levelData,
 			visLights, visLightLists, textures, chasmTextureGroups, occlusion, frame);
@@ -5911,6 +6806,7 @@ void SoftwareRenderer::drawVoxelSameFloor(int x, SNInt voxelX, int voxelY, WEInt
 	const auto &voxelGrid = levelData.getVoxelGrid();
 	const uint16_t voxelID = voxelGrid.getVoxel(voxelX, voxelY, voxelZ);
 	const VoxelDefinition &voxelDef = voxelGrid.getVoxelDef(voxelID);
+	const NewInt3 voxel(voxelX, voxelY, voxelZ);
 	const double voxelHeight = ceilingHeight;
 	const double voxelYReal = static_cast<double>(voxelY) * voxelHeight;
 	
@@ -5923,8 +6819,6 @@ void SoftwareRenderer::drawVoxelSameFloor(int x, SNInt voxelX, int voxelY, WEInt
 	if (voxelDef.type == ArenaTypes::VoxelType::Wall)
 	{
 		// Draw side.
-		const VoxelDefinition::WallData &wallData = voxelDef.wall;
-
 		const NewDouble3 nearCeilingPoint(
 			nearPoint.x,
 			voxelYReal + voxelHeight,
@@ -5941,8 +6835,8 @@ void SoftwareRenderer::drawVoxelSameFloor(int x, SNInt voxelX, int voxelY, WEInt
 		const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 			LightContributionCap>(nearPoint, visLights, visLightList);
 
-		SoftwareRenderer::drawPixels(x, drawRange, nearZ, wallU, 0.0,
-			Constants::JustBelowOne, wallNormal, textures.getTexture(wallData.sideTextureAssetRef), fadePercent,
+		SoftwareRenderer::drawPixels(x, voxel, drawRange, nearZ, wallU, 0.0,
+			Constants::JustBelowOne, wallNormal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), fadePercent,
 			wallLightPercent, shadingInfo, occlusion, frame);
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::Floor)
@@ -5954,8 +6848,6 @@ void SoftwareRenderer::drawVoxelSameFloor(int x, SNInt voxelX, int voxelY, WEInt
 		// Draw bottom of ceiling voxel if the camera is below it.
 		if (absoluteEye.y < voxelYReal)
 		{
-			const VoxelDefinition::CeilingData &ceilingData = voxelDef.ceiling;
-
 			const NewDouble3 nearFloorPoint(
 				nearPoint.x,
 				voxelYReal,
@@ -5970,9 +6862,9 @@ void SoftwareRenderer::drawVoxelSameFloor(int x, SNInt voxelX, int voxelY, WEInt
 			const double fadePercent = RendererUtils::getFadingVoxelPercent(
 				voxelX, voxelY, voxelZ, levelData);
 
-			SoftwareRenderer::drawPerspectivePixels(x, drawRange, nearPoint, farPoint, nearZ,
-				farZ, -Double3::UnitY, textures.getTexture(ceilingData.textureAssetRef), fadePercent,
-				visLights, visLightList, shadingInfo, occlusion, frame);
+			SoftwareRenderer::drawPlanePixels(x, voxel, drawRange, nearPoint, farPoint, nearZ,
+				farZ, nearFloorPoint.y, -Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
+				fadePercent, visLights, visLightList, shadingInfo, occlusion, frame);
 		}
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::Raised)
@@ -6003,16 +6895,16 @@ void SoftwareRenderer::drawVoxelSameFloor(int x, SNInt voxelX, int voxelY, WEInt
 				voxelX, voxelY, voxelZ, levelData);
 
 			// Ceiling.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRanges.at(0), farPoint, nearPoint,
-				farZ, nearZ, Double3::UnitY, textures.getTexture(raisedData.ceilingTextureAssetRef), fadePercent,
+			SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRanges.at(0), farPoint, nearPoint,
+				farZ, nearZ, Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_CEILING), fadePercent,
 				visLights, visLightList, shadingInfo, occlusion, frame);
 
 			// Wall.
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(nearPoint, visLights, visLightList);
-			SoftwareRenderer::drawTransparentPixels(x, drawRanges.at(1), nearZ, wallU,
+			SoftwareRenderer::drawTransparentPixels(x, voxel, drawRanges.at(1), nearZ, wallU,
 				raisedData.vTop, raisedData.vBottom, wallNormal,
-				textures.getTexture(raisedData.sideTextureAssetRef), wallLightPercent, shadingInfo, occlusion, frame);
+				textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), wallLightPercent, shadingInfo, occlusion, frame);
 		}
 		else if (absoluteEye.y < nearFloorPoint.y)
 		{
@@ -6030,13 +6922,13 @@ void SoftwareRenderer::drawVoxelSameFloor(int x, SNInt voxelX, int voxelY, WEInt
 			// Wall.
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(nearPoint, visLights, visLightList);
-			SoftwareRenderer::drawTransparentPixels(x, drawRanges.at(0), nearZ, wallU,
+			SoftwareRenderer::drawTransparentPixels(x, voxel, drawRanges.at(0), nearZ, wallU,
 				raisedData.vTop, raisedData.vBottom, wallNormal,
-				textures.getTexture(raisedData.sideTextureAssetRef), wallLightPercent, shadingInfo, occlusion, frame);
+				textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), wallLightPercent, shadingInfo, occlusion, frame);
 
 			// Floor.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRanges.at(1), nearPoint, farPoint,
-				nearZ, farZ, -Double3::UnitY, textures.getTexture(raisedData.floorTextureAssetRef), fadePercent,
+			SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRanges.at(1), nearPoint, farPoint,
+				nearZ, farZ, -Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_FLOOR), fadePercent,
 				visLights, visLightList, shadingInfo, occlusion, frame);
 		}
 		else
@@ -6047,9 +6939,9 @@ void SoftwareRenderer::drawVoxelSameFloor(int x, SNInt voxelX, int voxelY, WEInt
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(nearPoint, visLights, visLightList);
 
-			SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ, wallU,
+			SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ, wallU,
 				raisedData.vTop, raisedData.vBottom, wallNormal,
-				textures.getTexture(raisedData.sideTextureAssetRef), wallLightPercent, shadingInfo, occlusion, frame);
+				textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), wallLightPercent, shadingInfo, occlusion, frame);
 		}
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::Diagonal)
@@ -6080,16 +6972,14 @@ void SoftwareRenderer::drawVoxelSameFloor(int x, SNInt voxelX, int voxelY, WEInt
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(hit.point, visLights, visLightList);
 
-			SoftwareRenderer::drawPixels(x, drawRange, nearZ + hit.innerZ, hit.u, 0.0,
-				Constants::JustBelowOne, hit.normal, textures.getTexture(diagData.textureAssetRef), fadePercent,
+			SoftwareRenderer::drawPixels(x, voxel, drawRange, nearZ + hit.innerZ, hit.u, 0.0,
+				Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), fadePercent,
 				wallLightPercent, shadingInfo, occlusion, frame);
 		}
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::TransparentWall)
 	{
 		// Draw transparent side.
-		const VoxelDefinition::TransparentWallData &transparentWallData = voxelDef.transparentWall;
-
 		const NewDouble3 nearCeilingPoint(
 			nearPoint.x,
 			voxelYReal + voxelHeight,
@@ -6104,8 +6994,8 @@ void SoftwareRenderer::drawVoxelSameFloor(int x, SNInt voxelX, int voxelY, WEInt
 		const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 			LightContributionCap>(nearPoint, visLights, visLightList);
 
-		SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ, wallU, 0.0,
-			Constants::JustBelowOne, wallNormal, textures.getTexture(transparentWallData.textureAssetRef),
+		SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ, wallU, 0.0,
+			Constants::JustBelowOne, wallNormal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 			wallLightPercent, shadingInfo, occlusion, frame);
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::Edge)
@@ -6134,8 +7024,8 @@ void SoftwareRenderer::drawVoxelSameFloor(int x, SNInt voxelX, int voxelY, WEInt
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(hit.point, visLights, visLightList);
 
-			SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ + hit.innerZ, hit.u,
-				0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(edgeData.textureAssetRef),
+			SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ + hit.innerZ, hit.u,
+				0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 				wallLightPercent, shadingInfo, occlusion, frame);
 		}
 	}
@@ -6190,9 +7080,9 @@ void SoftwareRenderer::drawVoxelSameFloor(int x, SNInt voxelX, int voxelY, WEInt
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(nearPoint, visLights, visLightList);
 
-			SoftwareRenderer::drawChasmPixels(x, drawRange, nearZ, nearU, 0.0,
+			SoftwareRenderer::drawChasmPixels(x, voxel, drawRange, nearZ, nearU, 0.0,
 				Constants::JustBelowOne, nearNormal, RendererUtils::isChasmEmissive(chasmData.type),
-				textures.getTexture(chasmData.textureAssetRef), *chasmTexture, wallLightPercent, shadingInfo, occlusion, frame);
+				textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), *chasmTexture, wallLightPercent, shadingInfo, occlusion, frame);
 		}
 
 		const auto drawRanges = SoftwareRenderer::makeDrawRangeTwoPart(
@@ -6200,7 +7090,7 @@ void SoftwareRenderer::drawVoxelSameFloor(int x, SNInt voxelX, int voxelY, WEInt
 
 		// Chasm floor (drawn before far wall for occlusion buffer).
 		const Double3 floorNormal = Double3::UnitY;
-		SoftwareRenderer::drawPerspectiveChasmPixels(x, drawRanges.at(1), farPoint, nearPoint,
+		SoftwareRenderer::drawPerspectiveChasmPixels(x, voxel, drawRanges.at(1), farPoint, nearPoint,
 			farZ, nearZ, floorNormal, RendererUtils::isChasmEmissive(chasmData.type),
 			*chasmTexture, shadingInfo, occlusion, frame);
 
@@ -6236,9 +7126,9 @@ void SoftwareRenderer::drawVoxelSameFloor(int x, SNInt voxelX, int voxelY, WEInt
 				LightContributionCap>(farPoint, visLights, visLightList);
 
 			const Double3 farNormal = -VoxelUtils::getNormal(farFacing);
-			SoftwareRenderer::drawChasmPixels(x, drawRanges.at(0), farZ, farU, 0.0,
+			SoftwareRenderer::drawChasmPixels(x, voxel, drawRanges.at(0), farZ, farU, 0.0,
 				Constants::JustBelowOne, farNormal, RendererUtils::isChasmEmissive(chasmData.type),
-				textures.getTexture(chasmData.textureAssetRef), *chasmTexture, wallLightPercent, shadingInfo, occlusion, frame);
+				textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), *chasmTexture, wallLightPercent, shadingInfo, occlusion, frame);
 		}
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::Door)
@@ -6268,8 +7158,8 @@ void SoftwareRenderer::drawVoxelSameFloor(int x, SNInt voxelX, int voxelY, WEInt
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ + hit.innerZ,
-					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(doorData.textureAssetRef),
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ + hit.innerZ,
+					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 					wallLightPercent, shadingInfo, occlusion, frame);
 			}
 			else if (doorData.type == ArenaTypes::DoorType::Sliding)
@@ -6288,8 +7178,8 @@ void SoftwareRenderer::drawVoxelSameFloor(int x, SNInt voxelX, int voxelY, WEInt
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ, hit.u, 0.0,
-					Constants::JustBelowOne, hit.normal, textures.getTexture(doorData.textureAssetRef),
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ, hit.u, 0.0,
+					Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 					wallLightPercent, shadingInfo, occlusion, frame);
 			}
 			else if (doorData.type == ArenaTypes::DoorType::Raising)
@@ -6316,8 +7206,8 @@ void SoftwareRenderer::drawVoxelSameFloor(int x, SNInt voxelX, int voxelY, WEInt
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ, hit.u, vStart,
-					Constants::JustBelowOne, hit.normal, textures.getTexture(doorData.textureAssetRef), wallLightPercent,
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ, hit.u, vStart,
+					Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), wallLightPercent,
 					shadingInfo, occlusion, frame);
 			}
 			else if (doorData.type == ArenaTypes::DoorType::Splitting)
@@ -6336,8 +7226,8 @@ void SoftwareRenderer::drawVoxelSameFloor(int x, SNInt voxelX, int voxelY, WEInt
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ, hit.u, 0.0,
-					Constants::JustBelowOne, hit.normal, textures.getTexture(doorData.textureAssetRef),
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ, hit.u, 0.0,
+					Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 					wallLightPercent, shadingInfo, occlusion, frame);
 			}
 		}
@@ -6354,6 +7244,7 @@ void SoftwareRenderer::drawVoxelAbove(int x, SNInt voxelX, int voxelY, WEInt vox
 	const auto &voxelGrid = levelData.getVoxelGrid();
 	const uint16_t voxelID = voxelGrid.getVoxel(voxelX, voxelY, voxelZ);
 	const VoxelDefinition &voxelDef = voxelGrid.getVoxelDef(voxelID);
+	const NewInt3 voxel(voxelX, voxelY, voxelZ);
 	const double voxelHeight = ceilingHeight;
 	const double voxelYReal = static_cast<double>(voxelY) * voxelHeight;
 
@@ -6365,8 +7256,6 @@ void SoftwareRenderer::drawVoxelAbove(int x, SNInt voxelX, int voxelY, WEInt vox
 
 	if (voxelDef.type == ArenaTypes::VoxelType::Wall)
 	{
-		const VoxelDefinition::WallData &wallData = voxelDef.wall;
-
 		const NewDouble3 nearCeilingPoint(
 			nearPoint.x,
 			voxelYReal + voxelHeight,
@@ -6388,13 +7277,13 @@ void SoftwareRenderer::drawVoxelAbove(int x, SNInt voxelX, int voxelY, WEInt vox
 			LightContributionCap>(nearPoint, visLights, visLightList);
 
 		// Wall.
-		SoftwareRenderer::drawPixels(x, drawRanges.at(0), nearZ, wallU, 0.0,
-			Constants::JustBelowOne, wallNormal, textures.getTexture(wallData.sideTextureAssetRef), fadePercent,
+		SoftwareRenderer::drawPixels(x, voxel, drawRanges.at(0), nearZ, wallU, 0.0,
+			Constants::JustBelowOne, wallNormal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), fadePercent,
 			wallLightPercent, shadingInfo, occlusion, frame);
 
 		// Floor.
-		SoftwareRenderer::drawPerspectivePixels(x, drawRanges.at(1), nearPoint, farPoint,
-			nearZ, farZ, -Double3::UnitY, textures.getTexture(wallData.floorTextureAssetRef), fadePercent,
+		SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRanges.at(1), nearPoint, farPoint,
+			nearZ, farZ, -Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_FLOOR), fadePercent,
 			visLights, visLightList, shadingInfo, occlusion, frame);
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::Floor)
@@ -6404,8 +7293,6 @@ void SoftwareRenderer::drawVoxelAbove(int x, SNInt voxelX, int voxelY, WEInt vox
 	else if (voxelDef.type == ArenaTypes::VoxelType::Ceiling)
 	{
 		// Draw bottom of ceiling voxel.
-		const VoxelDefinition::CeilingData &ceilingData = voxelDef.ceiling;
-
 		const NewDouble3 nearFloorPoint(
 			nearPoint.x,
 			voxelYReal,
@@ -6420,9 +7307,9 @@ void SoftwareRenderer::drawVoxelAbove(int x, SNInt voxelX, int voxelY, WEInt vox
 		const double fadePercent = RendererUtils::getFadingVoxelPercent(
 			voxelX, voxelY, voxelZ, levelData);
 
-		SoftwareRenderer::drawPerspectivePixels(x, drawRange, nearPoint, farPoint, nearZ,
-			farZ, -Double3::UnitY, textures.getTexture(ceilingData.textureAssetRef), fadePercent,
-			visLights, visLightList, shadingInfo, occlusion, frame);
+		SoftwareRenderer::drawPlanePixels(x, voxel, drawRange, nearPoint, farPoint, nearZ,
+			farZ, nearFloorPoint.y, -Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
+			fadePercent, visLights, visLightList, shadingInfo, occlusion, frame);
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::Raised)
 	{
@@ -6452,16 +7339,16 @@ void SoftwareRenderer::drawVoxelAbove(int x, SNInt voxelX, int voxelY, WEInt vox
 				voxelX, voxelY, voxelZ, levelData);
 
 			// Ceiling.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRanges.at(0), farPoint, nearPoint,
-				farZ, nearZ, Double3::UnitY, textures.getTexture(raisedData.ceilingTextureAssetRef), fadePercent,
+			SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRanges.at(0), farPoint, nearPoint,
+				farZ, nearZ, Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_CEILING), fadePercent,
 				visLights, visLightList, shadingInfo, occlusion, frame);
 
 			// Wall.
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(nearPoint, visLights, visLightList);
-			SoftwareRenderer::drawTransparentPixels(x, drawRanges.at(1), nearZ, wallU,
+			SoftwareRenderer::drawTransparentPixels(x, voxel, drawRanges.at(1), nearZ, wallU,
 				raisedData.vTop, raisedData.vBottom, wallNormal,
-				textures.getTexture(raisedData.sideTextureAssetRef), wallLightPercent, shadingInfo, occlusion, frame);
+				textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), wallLightPercent, shadingInfo, occlusion, frame);
 		}
 		else if (absoluteEye.y < nearFloorPoint.y)
 		{
@@ -6479,13 +7366,13 @@ void SoftwareRenderer::drawVoxelAbove(int x, SNInt voxelX, int voxelY, WEInt vox
 			// Wall.
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(nearPoint, visLights, visLightList);
-			SoftwareRenderer::drawTransparentPixels(x, drawRanges.at(0), nearZ, wallU,
+			SoftwareRenderer::drawTransparentPixels(x, voxel, drawRanges.at(0), nearZ, wallU,
 				raisedData.vTop, raisedData.vBottom, wallNormal,
-				textures.getTexture(raisedData.sideTextureAssetRef), wallLightPercent, shadingInfo, occlusion, frame);
+				textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), wallLightPercent, shadingInfo, occlusion, frame);
 
 			// Floor.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRanges.at(1), nearPoint, farPoint,
-				nearZ, farZ, -Double3::UnitY, textures.getTexture(raisedData.floorTextureAssetRef), fadePercent,
+			SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRanges.at(1), nearPoint, farPoint,
+				nearZ, farZ, -Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_FLOOR), fadePercent,
 				visLights, visLightList, shadingInfo, occlusion, frame);
 		}
 		else
@@ -6496,9 +7383,9 @@ void SoftwareRenderer::drawVoxelAbove(int x, SNInt voxelX, int voxelY, WEInt vox
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(nearPoint, visLights, visLightList);
 
-			SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ, wallU,
+			SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ, wallU,
 				raisedData.vTop, raisedData.vBottom, wallNormal,
-				textures.getTexture(raisedData.sideTextureAssetRef), wallLightPercent, shadingInfo, occlusion, frame);
+				textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), wallLightPercent, shadingInfo, occlusion, frame);
 		}
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::Diagonal)
@@ -6529,16 +7416,14 @@ void SoftwareRenderer::drawVoxelAbove(int x, SNInt voxelX, int voxelY, WEInt vox
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(hit.point, visLights, visLightList);
 
-			SoftwareRenderer::drawPixels(x, drawRange, nearZ + hit.innerZ, hit.u, 0.0,
-				Constants::JustBelowOne, hit.normal, textures.getTexture(diagData.textureAssetRef), fadePercent,
+			SoftwareRenderer::drawPixels(x, voxel, drawRange, nearZ + hit.innerZ, hit.u, 0.0,
+				Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), fadePercent,
 				wallLightPercent, shadingInfo, occlusion, frame);
 		}
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::TransparentWall)
 	{
 		// Draw transparent side.
-		const VoxelDefinition::TransparentWallData &transparentWallData = voxelDef.transparentWall;
-
 		const NewDouble3 nearCeilingPoint(
 			nearPoint.x,
 			voxelYReal + voxelHeight,
@@ -6553,8 +7438,8 @@ void SoftwareRenderer::drawVoxelAbove(int x, SNInt voxelX, int voxelY, WEInt vox
 		const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 			LightContributionCap>(nearPoint, visLights, visLightList);
 
-		SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ, wallU, 0.0,
-			Constants::JustBelowOne, wallNormal, textures.getTexture(transparentWallData.textureAssetRef),
+		SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ, wallU, 0.0,
+			Constants::JustBelowOne, wallNormal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 			wallLightPercent, shadingInfo, occlusion, frame);
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::Edge)
@@ -6583,8 +7468,8 @@ void SoftwareRenderer::drawVoxelAbove(int x, SNInt voxelX, int voxelY, WEInt vox
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(hit.point, visLights, visLightList);
 
-			SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ + hit.innerZ, hit.u,
-				0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(edgeData.textureAssetRef),
+			SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ + hit.innerZ, hit.u,
+				0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 				wallLightPercent, shadingInfo, occlusion, frame);
 		}
 	}
@@ -6619,8 +7504,8 @@ void SoftwareRenderer::drawVoxelAbove(int x, SNInt voxelX, int voxelY, WEInt vox
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ + hit.innerZ,
-					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(doorData.textureAssetRef),
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ + hit.innerZ,
+					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 					wallLightPercent, shadingInfo, occlusion, frame);
 			}
 			else if (doorData.type == ArenaTypes::DoorType::Sliding)
@@ -6639,8 +7524,8 @@ void SoftwareRenderer::drawVoxelAbove(int x, SNInt voxelX, int voxelY, WEInt vox
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ, hit.u, 0.0,
-					Constants::JustBelowOne, hit.normal, textures.getTexture(doorData.textureAssetRef),
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ, hit.u, 0.0,
+					Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 					wallLightPercent, shadingInfo, occlusion, frame);
 			}
 			else if (doorData.type == ArenaTypes::DoorType::Raising)
@@ -6667,8 +7552,8 @@ void SoftwareRenderer::drawVoxelAbove(int x, SNInt voxelX, int voxelY, WEInt vox
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ, hit.u, vStart,
-					Constants::JustBelowOne, hit.normal, textures.getTexture(doorData.textureAssetRef), wallLightPercent,
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ, hit.u, vStart,
+					Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), wallLightPercent,
 					shadingInfo, occlusion, frame);
 			}
 			else if (doorData.type == ArenaTypes::DoorType::Splitting)
@@ -6687,8 +7572,8 @@ void SoftwareRenderer::drawVoxelAbove(int x, SNInt voxelX, int voxelY, WEInt vox
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ, hit.u, 0.0,
-					Constants::JustBelowOne, hit.normal, textures.getTexture(doorData.textureAssetRef),
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ, hit.u, 0.0,
+					Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 					wallLightPercent, shadingInfo, occlusion, frame);
 			}
 		}
@@ -6705,6 +7590,7 @@ void SoftwareRenderer::drawVoxelBelow(int x, SNInt voxelX, int voxelY, WEInt vox
 	const auto &voxelGrid = levelData.getVoxelGrid();
 	const uint16_t voxelID = voxelGrid.getVoxel(voxelX, voxelY, voxelZ);
 	const VoxelDefinition &voxelDef = voxelGrid.getVoxelDef(voxelID);
+	const NewInt3 voxel(voxelX, voxelY, voxelZ);
 	const double voxelHeight = ceilingHeight;
 	const double voxelYReal = static_cast<double>(voxelY) * voxelHeight;
 
@@ -6716,8 +7602,6 @@ void SoftwareRenderer::drawVoxelBelow(int x, SNInt voxelX, int voxelY, WEInt vox
 
 	if (voxelDef.type == ArenaTypes::VoxelType::Wall)
 	{
-		const VoxelDefinition::WallData &wallData = voxelDef.wall;
-
 		const NewDouble3 farCeilingPoint(
 			farPoint.x,
 			voxelYReal + voxelHeight,
@@ -6737,22 +7621,20 @@ void SoftwareRenderer::drawVoxelBelow(int x, SNInt voxelX, int voxelY, WEInt vox
 			voxelX, voxelY, voxelZ, levelData);
 
 		// Ceiling.
-		SoftwareRenderer::drawPerspectivePixels(x, drawRanges.at(0), farPoint, nearPoint, farZ,
-			nearZ, Double3::UnitY, textures.getTexture(wallData.ceilingTextureAssetRef), fadePercent,
+		SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRanges.at(0), farPoint, nearPoint, farZ,
+			nearZ, Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_CEILING), fadePercent,
 			visLights, visLightList, shadingInfo, occlusion, frame);
 
 		// Wall.
 		const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 			LightContributionCap>(nearPoint, visLights, visLightList);
-		SoftwareRenderer::drawPixels(x, drawRanges.at(1), nearZ, wallU, 0.0,
-			Constants::JustBelowOne, wallNormal, textures.getTexture(wallData.sideTextureAssetRef), fadePercent,
+		SoftwareRenderer::drawPixels(x, voxel, drawRanges.at(1), nearZ, wallU, 0.0,
+			Constants::JustBelowOne, wallNormal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), fadePercent,
 			wallLightPercent, shadingInfo, occlusion, frame);
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::Floor)
 	{
 		// Draw top of floor voxel.
-		const VoxelDefinition::FloorData &floorData = voxelDef.floor;
-
 		const NewDouble3 farCeilingPoint(
 			farPoint.x,
 			voxelYReal + voxelHeight,
@@ -6767,9 +7649,9 @@ void SoftwareRenderer::drawVoxelBelow(int x, SNInt voxelX, int voxelY, WEInt vox
 		const double fadePercent = RendererUtils::getFadingVoxelPercent(
 			voxelX, voxelY, voxelZ, levelData);
 
-		SoftwareRenderer::drawPerspectivePixels(x, drawRange, farPoint, nearPoint, farZ,
-			nearZ, Double3::UnitY, textures.getTexture(floorData.textureAssetRef), fadePercent,
-			visLights, visLightList, shadingInfo, occlusion, frame);
+		SoftwareRenderer::drawPlanePixels(x, voxel, drawRange, farPoint, nearPoint, farZ,
+			nearZ, farCeilingPoint.y, Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
+			fadePercent, visLights, visLightList, shadingInfo, occlusion, frame);
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::Ceiling)
 	{
@@ -6803,16 +7685,16 @@ void SoftwareRenderer::drawVoxelBelow(int x, SNInt voxelX, int voxelY, WEInt vox
 				voxelX, voxelY, voxelZ, levelData);
 
 			// Ceiling.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRanges.at(0), farPoint, nearPoint,
-				farZ, nearZ, Double3::UnitY, textures.getTexture(raisedData.ceilingTextureAssetRef), fadePercent,
+			SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRanges.at(0), farPoint, nearPoint,
+				farZ, nearZ, Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_CEILING), fadePercent,
 				visLights, visLightList, shadingInfo, occlusion, frame);
 
 			// Wall.
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(nearPoint, visLights, visLightList);
-			SoftwareRenderer::drawTransparentPixels(x, drawRanges.at(1), nearZ, wallU,
+			SoftwareRenderer::drawTransparentPixels(x, voxel, drawRanges.at(1), nearZ, wallU,
 				raisedData.vTop, raisedData.vBottom, wallNormal,
-				textures.getTexture(raisedData.sideTextureAssetRef), wallLightPercent, shadingInfo, occlusion, frame);
+				textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), wallLightPercent, shadingInfo, occlusion, frame);
 		}
 		else if (absoluteEye.y < nearFloorPoint.y)
 		{
@@ -6830,13 +7712,13 @@ void SoftwareRenderer::drawVoxelBelow(int x, SNInt voxelX, int voxelY, WEInt vox
 			// Wall.
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(nearPoint, visLights, visLightList);
-			SoftwareRenderer::drawTransparentPixels(x, drawRanges.at(0), nearZ, wallU,
+			SoftwareRenderer::drawTransparentPixels(x, voxel, drawRanges.at(0), nearZ, wallU,
 				raisedData.vTop, raisedData.vBottom, wallNormal,
-				textures.getTexture(raisedData.sideTextureAssetRef), wallLightPercent, shadingInfo, occlusion, frame);
+				textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), wallLightPercent, shadingInfo, occlusion, frame);
 
 			// Floor.
-			SoftwareRenderer::drawPerspectivePixels(x, drawRanges.at(1), nearPoint, farPoint,
-				nearZ, farZ, -Double3::UnitY, textures.getTexture(raisedData.floorTextureAssetRef), fadePercent,
+			SoftwareRenderer::drawPerspectivePixels(x, voxel, drawRanges.at(1), nearPoint, farPoint,
+				nearZ, farZ, -Double3::UnitY, textures.getTexture(voxelID, VoxelTextures::SLOT_FLOOR), fadePercent,
 				visLights, visLightList, shadingInfo, occlusion, frame);
 		}
 		else
@@ -6847,9 +7729,9 @@ void SoftwareRenderer::drawVoxelBelow(int x, SNInt voxelX, int voxelY, WEInt vox
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(nearPoint, visLights, visLightList);
 
-			SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ, wallU,
+			SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ, wallU,
 				raisedData.vTop, raisedData.vBottom, wallNormal,
-				textures.getTexture(raisedData.sideTextureAssetRef), wallLightPercent, shadingInfo, occlusion, frame);
+				textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), wallLightPercent, shadingInfo, occlusion, frame);
 		}
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::Diagonal)
@@ -6880,16 +7762,14 @@ void SoftwareRenderer::drawVoxelBelow(int x, SNInt voxelX, int voxelY, WEInt vox
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(hit.point, visLights, visLightList);
 
-			SoftwareRenderer::drawPixels(x, drawRange, nearZ + hit.innerZ, hit.u, 0.0,
-				Constants::JustBelowOne, hit.normal, textures.getTexture(diagData.textureAssetRef), fadePercent,
+			SoftwareRenderer::drawPixels(x, voxel, drawRange, nearZ + hit.innerZ, hit.u, 0.0,
+				Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), fadePercent,
 				wallLightPercent, shadingInfo, occlusion, frame);
 		}
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::TransparentWall)
 	{
 		// Draw transparent side.
-		const VoxelDefinition::TransparentWallData &transparentWallData = voxelDef.transparentWall;
-
 		const NewDouble3 nearCeilingPoint(
 			nearPoint.x,
 			voxelYReal + voxelHeight,
@@ -6904,8 +7784,8 @@ void SoftwareRenderer::drawVoxelBelow(int x, SNInt voxelX, int voxelY, WEInt vox
 		const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 			LightContributionCap>(nearPoint, visLights, visLightList);
 
-		SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ, wallU, 0.0,
-			Constants::JustBelowOne, wallNormal, textures.getTexture(transparentWallData.textureAssetRef),
+		SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ, wallU, 0.0,
+			Constants::JustBelowOne, wallNormal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 			wallLightPercent, shadingInfo, occlusion, frame);
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::Edge)
@@ -6934,8 +7814,8 @@ void SoftwareRenderer::drawVoxelBelow(int x, SNInt voxelX, int voxelY, WEInt vox
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(hit.point, visLights, visLightList);
 
-			SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ + hit.innerZ, hit.u,
-				0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(edgeData.textureAssetRef),
+			SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ + hit.innerZ, hit.u,
+				0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 				wallLightPercent, shadingInfo, occlusion, frame);
 		}
 	}
@@ -6990,9 +7870,9 @@ void SoftwareRenderer::drawVoxelBelow(int x, SNInt voxelX, int voxelY, WEInt vox
 			const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(nearPoint, visLights, visLightList);
 
-			SoftwareRenderer::drawChasmPixels(x, drawRange, nearZ, nearU, 0.0,
+			SoftwareRenderer::drawChasmPixels(x, voxel, drawRange, nearZ, nearU, 0.0,
 				Constants::JustBelowOne, nearNormal, RendererUtils::isChasmEmissive(chasmData.type),
-				textures.getTexture(chasmData.textureAssetRef), *chasmTexture, wallLightPercent, shadingInfo, occlusion, frame);
+				textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), *chasmTexture, wallLightPercent, shadingInfo, occlusion, frame);
 		}
 
 		const auto drawRanges = SoftwareRenderer::makeDrawRangeTwoPart(
@@ -7000,7 +7880,7 @@ void SoftwareRenderer::drawVoxelBelow(int x, SNInt voxelX, int voxelY, WEInt vox
 
 		// Chasm floor (drawn before far wall for occlusion buffer).
 		const Double3 floorNormal = Double3::UnitY;
-		SoftwareRenderer::drawPerspectiveChasmPixels(x, drawRanges.at(1), farPoint, nearPoint,
+		SoftwareRenderer::drawPerspectiveChasmPixels(x, voxel, drawRanges.at(1), farPoint, nearPoint,
 			farZ, nearZ, floorNormal, RendererUtils::isChasmEmissive(chasmData.type),
 			*chasmTexture, shadingInfo, occlusion, frame);
 
@@ -7036,9 +7916,9 @@ void SoftwareRenderer::drawVoxelBelow(int x, SNInt voxelX, int voxelY, WEInt vox
 				LightContributionCap>(farPoint, visLights, visLightList);
 
 			const Double3 farNormal = -VoxelUtils::getNormal(farFacing);
-			SoftwareRenderer::drawChasmPixels(x, drawRanges.at(0), farZ, farU, 0.0,
+			SoftwareRenderer::drawChasmPixels(x, voxel, drawRanges.at(0), farZ, farU, 0.0,
 				Constants::JustBelowOne, farNormal, RendererUtils::isChasmEmissive(chasmData.type),
-				textures.getTexture(chasmData.textureAssetRef), *chasmTexture, wallLightPercent, shadingInfo, occlusion, frame);
+				textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), *chasmTexture, wallLightPercent, shadingInfo, occlusion, frame);
 		}
 	}
 	else if (voxelDef.type == ArenaTypes::VoxelType::Door)
@@ -7068,8 +7948,8 @@ void SoftwareRenderer::drawVoxelBelow(int x, SNInt voxelX, int voxelY, WEInt vox
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ + hit.innerZ,
-					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(doorData.textureAssetRef),
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ + hit.innerZ,
+					hit.u, 0.0, Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 					wallLightPercent, shadingInfo, occlusion, frame);
 			}
 			else if (doorData.type == ArenaTypes::DoorType::Sliding)
@@ -7088,8 +7968,8 @@ void SoftwareRenderer::drawVoxelBelow(int x, SNInt voxelX, int voxelY, WEInt vox
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ, hit.u, 0.0,
-					Constants::JustBelowOne, hit.normal, textures.getTexture(doorData.textureAssetRef),
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ, hit.u, 0.0,
+					Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 					wallLightPercent, shadingInfo, occlusion, frame);
 			}
 			else if (doorData.type == ArenaTypes::DoorType::Raising)
@@ -7116,8 +7996,8 @@ void SoftwareRenderer::drawVoxelBelow(int x, SNInt voxelX, int voxelY, WEInt vox
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ, hit.u, vStart,
-					Constants::JustBelowOne, hit.normal, textures.getTexture(doorData.textureAssetRef), wallLightPercent,
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ, hit.u, vStart,
+					Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN), wallLightPercent,
 					shadingInfo, occlusion, frame);
 			}
 			else if (doorData.type == ArenaTypes::DoorType::Splitting)
@@ -7136,8 +8016,8 @@ void SoftwareRenderer::drawVoxelBelow(int x, SNInt voxelX, int voxelY, WEInt vox
 				const double wallLightPercent = SoftwareRenderer::getLightContributionAtPoint<
 					LightContributionCap>(hit.point, visLights, visLightList);
 
-				SoftwareRenderer::drawTransparentPixels(x, drawRange, nearZ, hit.u, 0.0,
-					Constants::JustBelowOne, hit.normal, textures.getTexture(doorData.textureAssetRef),
+				SoftwareRenderer::drawTransparentPixels(x, voxel, drawRange, nearZ, hit.u, 0.0,
+					Constants::JustBelowOne, hit.normal, textures.getTexture(voxelID, VoxelTextures::SLOT_MAIN),
 					wallLightPercent, shadingInfo, occlusion, frame);
 			}
 		}
@@ -7203,25 +8083,50 @@ void SoftwareRenderer::drawVoxelColumn(int x, SNInt voxelX, WEInt voxelZ, const
 		nearPoint, farPoint, nearZ, farZ, wallU, wallNormal, shadingInfo, chunkDistance, ceilingHeight,
 		levelData, visLights, visLightLists, textures, chasmTextureGroups, occlusion, frame);
 
+	// Only non-air heights in the column are visited, and drawing stops once the column
+	// is fully occluded.
+	const auto &voxelGrid = levelData.getVoxelGrid();
+	const VoxelGrid::ColumnMask columnMask = voxelGrid.getColumnMask(voxelX, voxelZ);
+
 	// Draw voxels below the voxel.
 	for (int voxelY = (adjustedVoxelY - 1); voxelY >= 0; voxelY--)
 	{
+		if (occlusion.yMin == occlusion.yMax)
+		{
+			return;
+		}
+
+		if ((columnMask & (static_cast<VoxelGrid::ColumnMask>(1) << voxelY)) == 0)
+		{
+			continue;
+		}
+
 		SoftwareRenderer::drawVoxelBelow(x, voxelX, voxelY, voxelZ, camera, ray, facing, nearPoint,
 			farPoint, nearZ, farZ, wallU, wallNormal, shadingInfo, chunkDistance, ceilingHeight,
 			levelData, visLights, visLightLists, textures, chasmTextureGroups, occlusion, frame);
 	}
 
 	// Draw voxels above the voxel.
-	const auto &voxelGrid = levelData.getVoxelGrid();
 	for (int voxelY = (adjustedVoxelY + 1); voxelY < voxelGrid.getHeight(); voxelY++)
 	{
+		if ((occlusion.yMin == occlusion.yMax) || ((columnMask >> voxelY) == 0))
+		{
+			// Fully occluded or nothing left above.
+			return;
+		}
+
+		if ((columnMask & (static_cast<VoxelGrid::ColumnMask>(1) << voxelY)) == 0)
+		{
+			continue;
+		}
+
 		SoftwareRenderer::drawVoxelAbove(x, voxelX, voxelY, voxelZ, camera, ray, facing, nearPoint,
 			farPoint, nearZ, farZ, wallU, wallNormal, shadingInfo, chunkDistance, ceilingHeight,
 			levelData, visLights, visLightLists, textures, chasmTextureGroups, occlusion, frame);
 	}
 }
 
-void SoftwareRenderer::drawFlat(int startX, int endX, const VisibleFlat &flat, const Double3 &normal,
+void SoftwareRenderer::drawFlat(int startX, int endX, const VisibleFlat &flat, uint32_t hitID, const Double3 &normal,
 	const NewDouble2 &eye, const NewInt2 &eyeVoxelXZ, double horizonProjY, const ShadingInfo &shadingInfo,
 	const Palette *overridePalette, int chunkDistance, const FlatTexture &texture,
 	const BufferView<const VisibleLight> &visLights, const BufferView2D<const VisibleLightList> &visLightLists,
@@ -7285,6 +8190,44 @@ void SoftwareRenderer::drawFlat(int startX, int endX, const VisibleFlat &flat, c
 	// Use the override palette for citizen variations or the base palette for most entities.
 	const Palette &palette = (overridePalette != nullptr) ? *overridePalette : shadingInfo.palette;
 
+	// Vertical texel position of a screen row.
+	auto getFlatTextureY = [&texture, projectedYStart, projectedYEnd](int y)
+	{
+		const double yPercent = ((static_cast<double>(y) + 0.50) - projectedYStart) /
+			(projectedYEnd - projectedYStart);
+
+		// Vertical texture coordinate.
+		const double startV = 0.0;
+		const double endV = Constants::JustBelowOne;
+		const double v = startV + ((endV - startV) * yPercent);
+
+		return static_cast<int>(v * static_cast<double>(texture.height));
+	};
+
+	// First on-screen row whose texel row is at least the given one. The estimate is nudged onto
+	// the exact row so spans cover the same pixels as a per-pixel alpha test would.
+	auto getFlatScreenY = [&texture, &getFlatTextureY, projectedYStart, projectedYEnd,
+		yStart, yEnd](int textureY)
+	{
+		const double texturePercent = static_cast<double>(textureY) /
+			(static_cast<double>(texture.height) * Constants::JustBelowOne);
+		const double estimateY = projectedYStart + ((projectedYEnd - projectedYStart) * texturePercent) - 0.50;
+		int y = static_cast<int>(std::clamp(std::ceil(estimateY), static_cast<double>(yStart),
+			static_cast<double>(yEnd)));
+
+		while ((y > yStart) && (getFlatTextureY(y - 1) >= textureY))
+		{
+			y--;
+		}
+
+		while ((y < yEnd) && (getFlatTextureY(y) < textureY))
+		{
+			y++;
+		}
+
+		return y;
+	};
+
 	// Draw by-column, similar to wall rendering.
 	for (int x = xStart; x < xEnd; x++)
 	{
@@ -7318,30 +8261,26 @@ void SoftwareRenderer::drawFlat(int startX, int endX, const VisibleFlat &flat, c
 		const Double3 &fogColor = shadingInfo.getFogColor();
 		const double fogPercent = std::min(depth / shadingInfo.fogDistance, 1.0);
 
-		for (int y = yStart; y < yEnd; y++)
+		// Only draw the screen rows covered by this texture column's opaque runs. Transparent
+		// texels are never visited.
+		const int spanBegin = texture.opaqueSpanOffsets[textureX];
+		const int spanEnd = texture.opaqueSpanOffsets[textureX + 1];
+		for (int spanIndex = spanBegin; spanIndex < spanEnd; spanIndex++)
 		{
-			const int index = x + (y * frame.width);
+			const Int2 &span = texture.opaqueSpans[spanIndex];
+			const int spanYStart = getFlatScreenY(span.x);
+			const int spanYEnd = getFlatScreenY(span.y);
 
-			if (depth <= frame.depthBuffer[index])
+			for (int y = spanYStart; y < spanYEnd; y++)
 			{
-				const double yPercent = ((static_cast<double>(y) + 0.50) - projectedYStart) /
-					(projectedYEnd - projectedYStart);
-
-				// Vertical texture coordinate.
-				const double startV = 0.0;
-				const double endV = Constants::JustBelowOne;
-				const double v = startV + ((endV - startV) * yPercent);
-
-				// Vertical texel position.
-				const int textureY = static_cast<int>(v * static_cast<double>(texture.height));
-
-				// Alpha is checked in this loop and transparent texels are not drawn.
-				const int textureIndex = textureX + (textureY * texture.width);
-				const FlatTexel &texel = texture.texels[textureIndex];
-				const bool isTransparentTexel = texel.value == 0;
-
-				if (!isTransparentTexel)
+				const int index = x + (y * frame.width);
+				if (depth <= frame.depthBuffer[index])
 				{
+					const int textureY = getFlatTextureY(y);
+					const int textureIndex = textureX + (textureY * texture.width);
+					const FlatTexel &texel = texture.texels[textureIndex];
+					DebugAssert(texel.value != 0);
+
 					double colorR, colorG, colorB;
 					if (ArenaRenderUtils::IsGhostTexel(texel.value))
 					{
@@ -7415,6 +8354,11 @@ void SoftwareRenderer::drawFlat(int startX, int endX, const VisibleFlat &flat, c
 
 					frame.colorBuffer[index] = colorRGB;
 					frame.depthBuffer[index] = depth;
+
+					if (frame.hitIDs != nullptr)
+					{
+						frame.hitIDs[index] = hitID;
+					}
 				}
 			}
 		}
@@ -7426,7 +8370,7 @@ void SoftwareRenderer::rayCast2DInternal(int x, const Camera &camera, const Ray
 	const ShadingInfo &shadingInfo, int chunkDistance, double ceilingHeight, const LevelData &levelData,
 	const BufferView<const VisibleLight> &visLights, const BufferView2D<const VisibleLightList> &visLightLists,
 	const VoxelTextures &textures, const ChasmTextureGroups &chasmTextureGroups, OcclusionData &occlusion,
-	const FrameView &frame)
+	RayStepCounts &rayStepCounts, const FrameView &frame)
 {
 	// Initially based on Lode Vandevenne's algorithm, this method of 2.5D ray casting is more 
 	// expensive as it does not stop at the first wall intersection, and it also renders voxels 
@@ -7568,6 +8512,60 @@ void SoftwareRenderer::rayCast2DInternal(int x, const Camera &camera, const Ray
 	while (voxelIsValid && (zDistance < shadingInfo.fogDistance) &&
 		(occlusion.yMin != occlusion.yMax))
 	{
+		// See if the cell is in a block of voxel columns that are all air, trying the coarsest
+		// blocks first. There is nothing to draw in them, so the ray can jump to the block's exit.
+		int emptyBlockShift = -1;
+		for (int level = 0; level < VoxelGrid::OCCUPANCY_LEVEL_COUNT; level++)
+		{
+			if (voxelGrid.isOccupancyColumnBlockEmpty(level, cell.x, cell.z))
+			{
+				emptyBlockShift = VoxelGrid::OCCUPANCY_BLOCK_SHIFTS[level];
+				break;
+			}
+		}
+
+		if (emptyBlockShift >= 0)
+		{
+			const int exitStepsX = VoxelUtils::getDDABlockExitStepCount(cell.x, emptyBlockShift, NonNegativeDirX);
+			const int exitStepsZ = VoxelUtils::getDDABlockExitStepCount(cell.z, emptyBlockShift, NonNegativeDirZ);
+			const SNDouble exitDistX = VoxelUtils::getDDABoundaryDistance(deltaDistSumX, deltaDistX, exitStepsX);
+			const WEDouble exitDistZ = VoxelUtils::getDDABoundaryDistance(deltaDistSumZ, deltaDistZ, exitStepsZ);
+
+			// Same tie-breaking as the DDA step: X only wins when strictly closer.
+			int stepsX, stepsZ;
+			if (exitDistX < exitDistZ)
+			{
+				stepsX = exitStepsX;
+				stepsZ = VoxelUtils::getDDACrossingCount(deltaDistSumZ, deltaDistZ, exitDistX, true, exitStepsZ - 1);
+				facing = NonNegativeDirX ? VoxelFacing2D::NegativeX : VoxelFacing2D::PositiveX;
+			}
+			else
+			{
+				stepsX = VoxelUtils::getDDACrossingCount(deltaDistSumX, deltaDistX, exitDistZ, false, exitStepsX - 1);
+				stepsZ = exitStepsZ;
+				facing = NonNegativeDirZ ? VoxelFacing2D::NegativeZ : VoxelFacing2D::PositiveZ;
+			}
+
+			if (stepsX > 0)
+			{
+				deltaDistSumX = VoxelUtils::getDDABoundaryDistance(deltaDistSumX, deltaDistX, stepsX) + deltaDistX;
+				cell.x += stepsX * stepX;
+			}
+
+			if (stepsZ > 0)
+			{
+				deltaDistSumZ = VoxelUtils::getDDABoundaryDistance(deltaDistSumZ, deltaDistZ, stepsZ) + deltaDistZ;
+				cell.z += stepsZ * stepZ;
+			}
+
+			zDistance = (exitDistX < exitDistZ) ?
+				(((static_cast<double>(cell.x) - absoluteEye.x) + halfOneMinusStepXReal) / ray.dirX) :
+				(((static_cast<double>(cell.z) - absoluteEye.z) + halfOneMinusStepZReal) / ray.dirZ);
+			voxelIsValid = (cell.x >= 0) && (cell.x < gridWidth) && (cell.z >= 0) && (cell.z < gridDepth);
+			rayStepCounts.skippedStepCount += stepsX + stepsZ;
+			continue;
+		}
+
 		// Store the cell coordinates, axis, and Z distance for wall rendering. The
 		// loop needs to do another DDA step to calculate the far point.
 		const SNInt savedCellX = cell.x;
@@ -7591,6 +8589,7 @@ void SoftwareRenderer::rayCast2DInternal(int x, const Camera &camera, const Ray
 		SoftwareRenderer::drawVoxelColumn(x, savedCellX, savedCellZ, camera, ray, savedFacing,
 			nearPoint, farPoint, wallDistance, zDistance, shadingInfo, chunkDistance, ceilingHeight,
 			levelData, visLights, visLightLists, textures, chasmTextureGroups, occlusion, frame);
+		rayStepCounts.stepCount++;
 	}
 }
 
@@ -7598,7 +8597,7 @@ void SoftwareRenderer::rayCast2D(int x, const Camera &camera, const Ray &ray, co
 	int chunkDistance, double ceilingHeight, const LevelData &levelData,
 	const BufferView<const VisibleLight> &visLights, const BufferView2D<const VisibleLightList> &visLightLists,
 	const VoxelTextures &textures, const ChasmTextureGroups &chasmTextureGroups, OcclusionData &occlusion,
-	const FrameView &frame)
+	RayStepCounts &rayStepCounts, const FrameView &frame)
 {
 	// Certain values like the step delta are constant relative to the ray direction, allowing
 	// for some compile-time constants and better code generation.
@@ -7610,12 +8609,14 @@ void SoftwareRenderer::rayCast2D(int x, const Camera &camera, const Ray &ray, co
 		if (nonNegativeDirZ)
 		{
 			SoftwareRenderer::rayCast2DInternal<true, true>(x, camera, ray, shadingInfo, chunkDistance,
-				ceilingHeight, levelData, visLights, visLightLists, textures, chasmTextureGroups, occlusion, frame);
+				ceilingHeight, levelData, visLights, visLightLists, textures, chasmTextureGroups, occlusion,
+				rayStepCounts, frame);
 		}
 		else
 		{
 			SoftwareRenderer::rayCast2DInternal<true, false>(x, camera, ray, shadingInfo, chunkDistance,
-				ceilingHeight, levelData, visLights, visLightLists, textures, chasmTextureGroups, occlusion, frame);
+				ceilingHeight, levelData, visLights, visLightLists, textures, chasmTextureGroups, occlusion,
+				rayStepCounts, frame);
 		}
 	}
 	else
@@ -7623,12 +8624,14 @@ void SoftwareRenderer::rayCast2D(int x, const Camera &camera, const Ray &ray, co
 		if (nonNegativeDirZ)
 		{
 			SoftwareRenderer::rayCast2DInternal<false, true>(x, camera, ray, shadingInfo, chunkDistance,
-				ceilingHeight, levelData, visLights, visLightLists, textures, chasmTextureGroups, occlusion, frame);
+				ceilingHeight, levelData, visLights, visLightLists, textures, chasmTextureGroups, occlusion,
+				rayStepCounts, frame);
 		}
 		else
 		{
 			SoftwareRenderer::rayCast2DInternal<false, false>(x, camera, ray, shadingInfo, chunkDistance,
-				ceilingHeight, levelData, visLights, visLightLists, textures, chasmTextureGroups, occlusion, frame);
+				ceilingHeight, levelData, visLights, visLightLists, textures, chasmTextureGroups, occlusion,
+				rayStepCounts, frame);
 		}
 	}
 }
@@ -7757,6 +8760,17 @@ void SoftwareRenderer::drawDistantSky(int startX, int endX, const VisDistantObje
 	// the daytime.
 	if (shouldDrawStars)
 	{
+		for (const VisSmallStar &smallStar : visDistantObjs.smallStars)
+		{
+			const int xDrawStart = std::max(smallStar.xStart, startX);
+			const int xDrawEnd = std::min(smallStar.xEnd, endX);
+			for (int x = xDrawStart; x < xDrawEnd; x++)
+			{
+				SoftwareRenderer::drawSmallStarPixels(x, smallStar.yStart, smallStar.yEnd, smallStar.color,
+					skyGradientRowCache, frame);
+			}
+		}
+
 		drawDistantObjRange(visDistantObjs.starStart, visDistantObjs.starEnd, DistantRenderType::Star);
 	}
 
@@ -7771,7 +8785,7 @@ void SoftwareRenderer::drawVoxels(int startX, int stride, const Camera &camera,
 	double ceilingHeight, const LevelData &levelData, const BufferView<const VisibleLight> &visLights,
 	const BufferView2D<const VisibleLightList> &visLightLists, const VoxelTextures &voxelTextures,
 	const ChasmTextureGroups &chasmTextureGroups, Buffer<OcclusionData> &occlusion,
-	const ShadingInfo &shadingInfo, const FrameView &frame)
+	const ShadingInfo &shadingInfo, RayStepCounts &rayStepCounts, const FrameView &frame)
 {
 	const NewDouble2 forwardZoomed(camera.forwardZoomedX, camera.forwardZoomedZ);
 	const NewDouble2 rightAspected(camera.rightAspectedX, camera.rightAspectedZ);
@@ -7793,35 +8807,199 @@ void SoftwareRenderer::drawVoxels(int startX, int stride, const Camera &camera,
 
 		// Cast the 2D ray and fill in the column's pixels with color.
 		SoftwareRenderer::rayCast2D(x, camera, ray, shadingInfo, chunkDistance, ceilingHeight, levelData,
-			visLights, visLightLists, voxelTextures, chasmTextureGroups, occlusion.get(x), frame);
+			visLights, visLightLists, voxelTextures, chasmTextureGroups, occlusion.get(x), rayStepCounts, frame);
+	}
+}
+
+void SoftwareRenderer::drawPlaneRows(int startY, int endY, const Camera &camera,
+	const BufferView<const VisibleLight> &visLights, const Buffer<double> &depthScales,
+	const ShadingInfo &shadingInfo, const FrameView &frame)
+{
+	const NewDouble3 absoluteEye = VoxelUtils::coordToNewPoint(camera.eye);
+
+	// Fog color to interpolate with.
+	const Double3 &fogColor = shadingInfo.getFogColor();
+	const double fogDistanceRecip = 1.0 / shadingInfo.fogDistance;
+
+	// Base shading on the texture.
+	const Double3 shading(shadingInfo.ambient, shadingInfo.ambient, shadingInfo.ambient);
+
+	// Projected height of a point one unit above the eye at one unit of depth. With Y-shearing, a
+	// plane's perpendicular depth on a screen row only depends on the row and the plane's height.
+	const double horizonProjY = 0.50 + camera.yShear;
+	const NewDouble3 unitPoint(
+		absoluteEye.x + camera.forwardX,
+		absoluteEye.y + 1.0,
+		absoluteEye.z + camera.forwardZ);
+	const double unitProjHeight = horizonProjY -
+		RendererUtils::getProjectedY(unitPoint, camera.transform, camera.yShear);
+
+	// Change in the un-normalized ray direction per screen column.
+	const NewDouble2 rightStep(
+		camera.rightAspectedX * (2.0 / frame.widthReal),
+		camera.rightAspectedZ * (2.0 / frame.widthReal));
+
+	for (int y = startY; y < endY; y++)
+	{
+		const double rowProjDistance = horizonProjY - ((static_cast<double>(y) + 0.50) / frame.heightReal);
+		uint16_t *rowSpanIDs = frame.planeSpanIDs + (y * frame.width);
+
+		int x = 0;
+		while (x < frame.width)
+		{
+			const uint16_t spanID = rowSpanIDs[x];
+			if (spanID == 0)
+			{
+				x++;
+				continue;
+			}
+
+			// Extend the span while neighboring columns have the same plane, texture, and lights.
+			// The span IDs are reset for the next frame along the way.
+			const PlaneSpan &span = frame.planeSpans[x][spanID - 1];
+			const int spanStartX = x;
+			rowSpanIDs[x] = 0;
+			x++;
+
+			while (x < frame.width)
+			{
+				const uint16_t nextSpanID = rowSpanIDs[x];
+				if (nextSpanID == 0)
+				{
+					break;
+				}
+
+				const PlaneSpan &nextSpan = frame.planeSpans[x][nextSpanID - 1];
+				const bool isSamePlane = (nextSpan.texture == span.texture) &&
+					(nextSpan.visLightList == span.visLightList) && (nextSpan.planeY == span.planeY) &&
+					(nextSpan.voxelY == span.voxelY);
+				if (!isSamePlane)
+				{
+					break;
+				}
+
+				rowSpanIDs[x] = 0;
+				x++;
+			}
+
+			const int spanEndX = x;
+
+			// Depth along the camera's forward axis, constant for the whole span.
+			const double perpDepth = (unitProjHeight * (span.planeY - absoluteEye.y)) / rowProjDistance;
+			if (!(perpDepth > 0.0) || !std::isfinite(perpDepth))
+			{
+				continue;
+			}
+
+			// Plane points step linearly across the span.
+			const double pointScale = perpDepth / camera.zoom;
+			const double startXComponent = (2.0 * ((static_cast<double>(spanStartX) + 0.50) / frame.widthReal)) - 1.0;
+			const NewDouble2 startPoint(
+				absoluteEye.x + ((camera.forwardZoomedX + (camera.rightAspectedX * startXComponent)) * pointScale),
+				absoluteEye.z + ((camera.forwardZoomedZ + (camera.rightAspectedZ * startXComponent)) * pointScale));
+			const NewDouble2 pointStep = rightStep * pointScale;
+
+			const VoxelTexture &texture = *span.texture;
+			const VisibleLightList &visLightList = *span.visLightList;
+			const bool hasLights = visLightList.count > 0;
+
+			for (int spanX = spanStartX; spanX < spanEndX; spanX++)
+			{
+				const int index = spanX + (y * frame.width);
+
+				// Distance along the ray, same as the voxel pass uses for depth and fog.
+				const double depth = perpDepth * depthScales.get(spanX);
+
+				if (depth <= frame.depthBuffer[index])
+				{
+					const double stepCount = static_cast<double>(spanX - spanStartX);
+					const SNDouble currentPointX = startPoint.x + (pointStep.x * stepCount);
+					const WEDouble currentPointY = startPoint.y + (pointStep.y * stepCount);
+
+					// Texture coordinates.
+					const double u = std::clamp(currentPointX - std::floor(currentPointX), 0.0, Constants::JustBelowOne);
+					const double v = std::clamp(currentPointY - std::floor(currentPointY), 0.0, Constants::JustBelowOne);
+
+					// Texture color. Alpha is ignored in this loop, so transparent texels will appear black.
+					constexpr bool TextureTransparency = false;
+					double colorR, colorG, colorB, colorEmission;
+					SoftwareRenderer::sampleVoxelTexture<TextureFilterMode, TextureTransparency>(
+						texture, u, v, &colorR, &colorG, &colorB, &colorEmission, nullptr);
+
+					// Light contribution.
+					const double lightContributionPercent = hasLights ?
+						SoftwareRenderer::getLightContributionAtPoint<LightContributionCap>(
+							NewDouble2(currentPointX, currentPointY), visLights, visLightList) : 0.0;
+
+					// Shading from light.
+					constexpr double shadingMax = 1.0;
+					const double combinedEmission = colorEmission + lightContributionPercent;
+					const double lightR = shading.x + combinedEmission;
+					const double lightG = shading.y + combinedEmission;
+					const double lightB = shading.z + combinedEmission;
+					colorR *= (lightR < shadingMax) ? lightR : shadingMax;
+					colorG *= (lightG < shadingMax) ? lightG : shadingMax;
+					colorB *= (lightB < shadingMax) ? lightB : shadingMax;
+
+					// Linearly interpolate with fog.
+					const double fogPercent = std::min(depth * fogDistanceRecip, 1.0);
+					colorR += (fogColor.x - colorR) * fogPercent;
+					colorG += (fogColor.y - colorG) * fogPercent;
+					colorB += (fogColor.z - colorB) * fogPercent;
+
+					// Clamp maximum (don't worry about negative values).
+					constexpr double high = 1.0;
+					colorR = (colorR > high) ? high : colorR;
+					colorG = (colorG > high) ? high : colorG;
+					colorB = (colorB > high) ? high : colorB;
+
+					// Convert floats to integers.
+					const uint32_t colorRGB = static_cast<uint32_t>(
+						((static_cast<uint8_t>(colorR * 255.0)) << 16) |
+						((static_cast<uint8_t>(colorG * 255.0)) << 8) |
+						((static_cast<uint8_t>(colorB * 255.0))));
+
+					frame.colorBuffer[index] = colorRGB;
+					frame.depthBuffer[index] = depth;
+
+					if (frame.hitIDs != nullptr)
+					{
+						const NewInt3 voxel(
+							static_cast<SNInt>(std::floor(currentPointX)),
+							span.voxelY,
+							static_cast<WEInt>(std::floor(currentPointY)));
+						frame.hitIDs[index] = MakeVoxelHitID(voxel, span.normal);
+					}
+				}
+			}
+		}
 	}
 }
 
 void SoftwareRenderer::drawFlats(int startX, int endX, const Camera &camera,
 	const Double3 &flatNormal, const std::vector<VisibleFlat> &visibleFlats,
-	const FlatTextureGroups &flatTextureGroups, const ShadingInfo &shadingInfo, int chunkDistance,
-	const BufferView<const VisibleLight> &visLights,
+	const ShadingInfo &shadingInfo, int chunkDistance, const BufferView<const VisibleLight> &visLights,
 	const BufferView2D<const VisibleLightList> &visLightLists, SNInt gridWidth, WEInt gridDepth,
 	const FrameView &frame)
 {
+	const NewDouble3 absoluteEye = VoxelUtils::coordToNewPoint(camera.eye);
+	const NewInt3 absoluteEyeVoxel = VoxelUtils::coordToNewVoxel(camera.eyeVoxel);
+	const NewDouble2 eye2D(absoluteEye.x, absoluteEye.z);
+	const NewInt2 eyeVoxel2D(absoluteEyeVoxel.x, absoluteEyeVoxel.z);
+
 	// Iterate through all flats, rendering those visible within the given X range of 
 	// the screen.
-	for (const VisibleFlat &flat : visibleFlats)
+	const int flatCount = static_cast<int>(visibleFlats.size());
+	for (int flatIndex = 0; flatIndex < flatCount; flatIndex++)
 	{
-		const NewDouble3 absoluteEye = VoxelUtils::coordToNewPoint(camera.eye);
-		const NewInt3 absoluteEyeVoxel = VoxelUtils::coordToNewVoxel(camera.eyeVoxel);
-		const NewDouble2 eye2D(absoluteEye.x, absoluteEye.z);
-		const NewInt2 eyeVoxel2D(absoluteEyeVoxel.x, absoluteEyeVoxel.z);
-
 		// Texture of the flat. It might be flipped horizontally as well, given by
 		// the "flat.flipped" value.
-		const EntityRenderID entityRenderID = flat.entityRenderID;
-		const FlatTextureGroup &textureGroup = flatTextureGroups[entityRenderID];
-		const FlatTexture &texture = textureGroup.getTexture(
-			flat.animStateID, flat.animAngleID, flat.animTextureID);
+		const VisibleFlat &flat = visibleFlats[flatIndex];
+		DebugAssert(flat.texture != nullptr);
 
-		SoftwareRenderer::drawFlat(startX, endX, flat, flatNormal, eye2D, eyeVoxel2D, camera.horizonProjY,
-			shadingInfo, flat.overridePalette, chunkDistance, texture, visLights, visLightLists, gridWidth,
+		const uint32_t hitID = (frame.hitIDs != nullptr) ? MakeFlatHitID(flatIndex) : HitTypeNone;
+		SoftwareRenderer::drawFlat(startX, endX, flat, hitID, flatNormal, eye2D, eyeVoxel2D, camera.horizonProjY,
+			shadingInfo, flat.overridePalette, chunkDistance, *flat.texture, visLights, visLightLists, gridWidth,
 			gridDepth, frame);
 	}
 }
@@ -7898,14 +9076,34 @@ void SoftwareRenderer::renderThreadLoop(RenderThreadData &threadData, int thread
 			static_cast<int>(voxels.visLights->size()));
 		const BufferView2D<const VisibleLightList> voxelsVisLightListsView(voxels.visLightLists->get(),
 			voxels.visLightLists->getWidth(), voxels.visLightLists->getHeight());
+		RayStepCounts rayStepCounts;
 		SoftwareRenderer::drawVoxels(threadIndex, strideX, *threadData.camera, voxels.chunkDistance,
 			voxels.ceilingHeight, *voxels.levelData, voxelsVisLightsView, voxelsVisLightListsView,
 			*voxels.voxelTextures, *voxels.chasmTextureGroups, *voxels.occlusion, *threadData.shadingInfo,
-			*threadData.frame);
+			rayStepCounts, *threadData.frame);
+
+		lk.lock();
+		voxels.rayStepCounts.add(rayStepCounts);
+		lk.unlock();
 
 		// Wait for other threads to finish voxels.
 		threadBarrier(voxels);
 
+		// Wait for all voxel columns to be done so the deferred floor and ceiling rows are complete.
+		RenderThreadData::Planes &planes = threadData.planes;
+		lk.lock();
+		threadData.condVar.wait(lk, [&planes]() { return planes.doneVoxels; });
+		lk.unlock();
+
+		// Draw this thread's portion of floor and ceiling rows.
+		const BufferView<const VisibleLight> planesVisLightsView(planes.visLights->data(),
+			static_cast<int>(planes.visLights->size()));
+		SoftwareRenderer::drawPlaneRows(startY, endY, *threadData.camera, planesVisLightsView,
+			*planes.depthScales, *threadData.shadingInfo, *threadData.frame);
+
+		// Wait for other threads to finish floor and ceiling rows.
+		threadBarrier(planes);
+
 		// Wait for the visible flat sorting to finish.
 		RenderThreadData::Flats &flats = threadData.flats;
 		lk.lock();
@@ -7919,7 +9117,7 @@ void SoftwareRenderer::renderThreadLoop(RenderThreadData &threadData, int thread
 			flats.visLightLists->getWidth(), flats.visLightLists->getHeight());
 		const VoxelGrid &voxelGrid = voxels.levelData->getVoxelGrid();
 		SoftwareRenderer::drawFlats(startX, endX, *threadData.camera, *flats.flatNormal, *flats.visibleFlats,
-			*flats.flatTextureGroups, *threadData.shadingInfo, voxels.chunkDistance, flatsVisLightsView,
+			*threadData.shadingInfo, voxels.chunkDistance, flatsVisLightsView,
 			flatsVisLightListsView, voxelGrid.getWidth(), voxelGrid.getDepth(), *threadData.frame);
 
 		// Wait for other threads to finish flats.
@@ -7950,7 +9148,9 @@ void SoftwareRenderer::render(const CoordDouble3 &eye, const Double3 &direction,
 	// values together.
 	const ShadingInfo shadingInfo(palette, this->skyPalette, daytimePercent, latitude, ambient,
 		this->fogDistance, chasmAnimPercent, nightLightsAreActive, isExterior, playerHasLight);
-	const FrameView frame(colorBuffer, this->depthBuffer.get(), this->width, this->height);
+	uint32_t *hitIDs = this->hitIDsActive ? this->hitIDs.get() : nullptr;
+	const FrameView frame(colorBuffer, this->depthBuffer.get(), this->planeSpans.get(),
+		this->planeSpanIDs.get(), hitIDs, this->width, this->height);
 
 	// Projected Y range of the sky gradient.
 	double gradientProjYTop, gradientProjYBottom;
@@ -7960,10 +9160,13 @@ void SoftwareRenderer::render(const CoordDouble3 &eye, const Double3 &direction,
 	this->threadData.init(this->renderThreads.getCount(), camera, shadingInfo, frame);
 	this->threadData.skyGradient.init(gradientProjYTop, gradientProjYBottom, this->skyGradientRowCache);
 	this->threadData.distantSky.init(this->visDistantObjs, this->skyTextures);
+	// Make sure every voxel definition's textures are resolved before the render threads start.
+	this->voxelTextures.resolveVoxelTextures(levelData.getVoxelGrid());
+
 	this->threadData.voxels.init(chunkDistance, ceilingHeight, levelData, this->visibleLights,
 		this->visLightLists, this->voxelTextures, this->chasmTextureGroups, this->occlusion);
-	this->threadData.flats.init(flatNormal, this->visibleFlats, this->visibleLights, this->visLightLists,
-		this->flatTextureGroups);
+	this->threadData.planes.init(this->visibleLights, this->planeDepthScales);
+	this->threadData.flats.init(flatNormal, this->visibleFlats, this->visibleLights, this->visLightLists);
 
 	// Give the render threads the go signal. They can work on the sky and voxels while this thread
 	// does things like resetting occlusion and doing visible flat determination.
@@ -7973,10 +9176,40 @@ void SoftwareRenderer::render(const CoordDouble3 &eye, const Double3 &direction,
 	lk.unlock();
 	this->threadData.condVar.notify_all();
 
+	// Stage times are measured from when each stage's threads finish.
+	auto getSecondsSince = [](std::chrono::high_resolution_clock::time_point &startTime)
+	{
+		const auto endTime = std::chrono::high_resolution_clock::now();
+		const std::chrono::duration<double> elapsed = endTime - startTime;
+		startTime = endTime;
+		return elapsed.count();
+	};
+
+	auto stageStartTime = std::chrono::high_resolution_clock::now();
+
 	// Reset occlusion. Don't need to reset sky gradient row cache because it is written to before
 	// it is read.
 	this->occlusion.fill(OcclusionData(0, this->height));
 
+	// Reset hit IDs. Pixels that only get sky stay unpickable.
+	if (hitIDs != nullptr)
+	{
+		this->hitIDs.fill(HitTypeNone);
+	}
+
+	// Reset deferred floor and ceiling spans, and get the ratio of ray distance to perpendicular
+	// depth for each column so the row pass doesn't need it per pixel.
+	for (int x = 0; x < this->width; x++)
+	{
+		this->planeSpans.get(x).clear();
+
+		const double xComponent = (2.0 * ((static_cast<double>(x) + 0.50) / widthReal)) - 1.0;
+		const NewDouble2 rayDirection(
+			camera.forwardZoomedX + (camera.rightAspectedX * xComponent),
+			camera.forwardZoomedZ + (camera.rightAspectedZ * xComponent));
+		this->planeDepthScales.set(x, rayDirection.length() / camera.zoom);
+	}
+
 	// Refresh the visible distant objects.
 	this->updateVisibleDistantObjects(shadingInfo, camera, frame);
 
@@ -7988,8 +9221,17 @@ void SoftwareRenderer::render(const CoordDouble3 &eye, const Double3 &direction,
 
 	// Keep the render threads from getting the go signal again before the next frame.
 	this->threadData.go = false;
+	lk.unlock();
+
+	// Small stars can only be seen once the sky gradient is dark enough, so they are projected
+	// after the gradient is drawn instead of every frame.
+	if (this->threadData.skyGradient.shouldDrawStars)
+	{
+		this->updateVisibleSmallStars(shadingInfo, camera, frame);
+	}
 
 	// Let the render threads know that they can start drawing distant objects.
+	lk.lock();
 	this->threadData.distantSky.doneVisTesting = true;
 	lk.unlock();
 	this->threadData.condVar.notify_all();
@@ -7999,7 +9241,7 @@ void SoftwareRenderer::render(const CoordDouble3 &eye, const Double3 &direction,
 	const VoxelGrid &voxelGrid = levelData.getVoxelGrid();
 	const EntityManager &entityManager = levelData.getEntityManager();
 	this->updateVisibleFlats(camera, shadingInfo, chunkDistance, ceilingHeight,
-		voxelGrid, entityManager, entityDefLibrary);
+		voxelGrid, levelData.getPotentiallyVisibleSet(), entityManager, entityDefLibrary);
 
 	// Refresh visible light lists used for shading voxels and entities efficiently.
 	this->updateVisibleLightLists(camera, chunkDistance, ceilingHeight, voxelGrid);
@@ -8010,6 +9252,8 @@ void SoftwareRenderer::render(const CoordDouble3 &eye, const Double3 &direction,
 		return this->threadData.distantSky.threadsDone == this->threadData.totalThreads;
 	});
 
+	this->stageTimes.sky = getSecondsSince(stageStartTime);
+
 	// Let the render threads know that they can start drawing voxels.
 	this->threadData.voxels.doneLightVisTesting = true;
 	lk.unlock();
@@ -8021,6 +9265,21 @@ void SoftwareRenderer::render(const CoordDouble3 &eye, const Double3 &direction,
 		return this->threadData.voxels.threadsDone == this->threadData.totalThreads;
 	});
 
+	this->stageTimes.voxels = getSecondsSince(stageStartTime);
+
+	// Let the render threads know that they can start drawing floor and ceiling rows.
+	this->threadData.planes.doneVoxels = true;
+	lk.unlock();
+	this->threadData.condVar.notify_all();
+
+	lk.lock();
+	this->threadData.condVar.wait(lk, [this]()
+	{
+		return this->threadData.planes.threadsDone == this->threadData.totalThreads;
+	});
+
+	this->stageTimes.planes = getSecondsSince(stageStartTime);
+
 	// Let the render threads know that they can start drawing flats.
 	this->threadData.flats.doneSorting = true;
 
@@ -8033,6 +9292,9 @@ void SoftwareRenderer::render(const CoordDouble3 &eye, const Double3 &direction,
 	{
 		return this->threadData.flats.threadsDone == this->threadData.totalThreads;
 	});
+
+	lk.unlock();
+	this->stageTimes.flats = getSecondsSince(stageStartTime);
 }
 
 void SoftwareRenderer::submitFrame(const RenderDefinitionGroup &defGroup, const RenderInstanceGroup &instGroup,
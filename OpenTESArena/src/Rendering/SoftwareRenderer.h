@@ -5,7 +5,10 @@
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
+#include <list>
+#include <map>
 #include <mutex>
+#include <optional>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -32,6 +35,7 @@
 // CPU-based 2.5D rendering.
 
 class Entity;
+class PotentiallyVisibleSet;
 class VoxelGrid;
 
 enum class VoxelFacing2D;
@@ -82,17 +86,27 @@ private:
 
 		void init(int width, int height, const uint8_t *srcTexels, const Palette &palette);
 		void setLightTexelsActive(bool active, const Palette &palette);
+
+		size_t getByteCount() const;
 	};
 
 	struct FlatTexture
 	{
 		std::vector<FlatTexel> texels;
+
+		// Runs of non-transparent texels in each column, as start (inclusive) and end (exclusive)
+		// rows, so drawing can skip the transparent space around sprite silhouettes.
+		std::vector<Int2> opaqueSpans;
+		std::vector<int> opaqueSpanOffsets; // Index of each column's first span, plus one past the last.
+
 		int width, height;
 		bool reflective;
 
 		FlatTexture();
 
 		void init(int width, int height, const uint8_t *srcTexels, bool flipped, bool reflective);
+
+		size_t getByteCount() const;
 	};
 
 	struct SkyTexture
@@ -108,11 +122,61 @@ private:
 	struct ChasmTexture
 	{
 		std::vector<ChasmTexel> texels;
+		std::vector<uint8_t> srcTexels; // Kept so the next level can check if it can reuse this texture.
+		Palette palette;
 		int width, height;
 
 		ChasmTexture();
 
 		void init(int width, int height, const uint8_t *srcTexels, const Palette &palette);
+
+		// Returns whether the texture was converted from the given texels and palette.
+		bool matches(int width, int height, const uint8_t *srcTexels, const Palette &palette) const;
+	};
+
+	// Reference counts for a list of texture slots. Unreferenced textures stay resident across
+	// level transitions so revisited levels don't convert them again, and the least recently
+	// released ones are evicted when over the byte budget.
+	class TextureResidency
+	{
+	private:
+		struct Slot
+		{
+			size_t byteCount;
+			int refCount;
+			bool resident;
+			std::list<int>::iterator unreferencedIter; // Valid if resident and unreferenced.
+
+			Slot();
+		};
+
+		std::vector<Slot> slots;
+		std::vector<int> freeSlots; // Slots of evicted textures.
+		std::list<int> unreferencedSlots; // Least recently released first.
+		size_t byteBudget;
+		size_t residentByteCount;
+	public:
+		// Texture creations since the last level transition that reused a resident texture or
+		// had to convert one.
+		int hitCount, missCount;
+
+		TextureResidency(size_t byteBudget);
+
+		int getSlotCount() const;
+		size_t getResidentByteCount() const;
+
+		// Gets a slot for a newly converted texture with one reference. Reuses evicted slots first.
+		int addSlot(size_t byteCount);
+
+		void addReference(int slot);
+		void removeReference(int slot);
+
+		// Drops all references for a level transition. Textures stay resident until evicted.
+		void releaseAll();
+
+		// Frees the least recently released unreferenced slot if over the budget. The caller
+		// clears the texture in that slot.
+		bool tryEvict(int *outSlot);
 	};
 
 	// @temp: this is a temporary solution to voxel texture allocation management -- ideally the renderer
@@ -128,14 +192,88 @@ private:
 
 	struct VoxelTextures
 	{
+		// Texture slots of a voxel definition, in VoxelDefinition::getTextureAssetReferences() order.
+		// Voxel types with one texture only use the main slot.
+		static constexpr int SLOT_MAIN = 0;
+		static constexpr int SLOT_FLOOR = 1;
+		static constexpr int SLOT_CEILING = 2;
+		static constexpr int SLOT_COUNT = 3;
+
+		using VoxelTextureIndices = std::array<int, SLOT_COUNT>;
+
+		// Unreferenced textures are evicted when over this many bytes.
+		static constexpr size_t RESIDENCY_BUDGET_BYTES = 64 * 1024 * 1024;
+
 		std::vector<VoxelTexture> textures;
-		std::vector<VoxelTextureMapping> mappings;
+		std::vector<VoxelTextureMapping> mappings; // One per texture slot. Evicted slots have no filename.
+		TextureResidency residency;
+		double conversionTime; // Seconds spent converting since the last level transition.
+
+		// Texture indices for each voxel definition in the voxel grid, resolved once so the voxel
+		// draw paths don't search the mappings per pixel column.
+		std::vector<VoxelTextureIndices> voxelTextureIndices;
+		int resolvedVoxelGridGeneration; // -1 if none.
+
+		VoxelTextures();
 
+		// Adds a reference to the texture if it's already resident.
+		bool tryAddReference(const TextureAssetReference &textureAssetRef);
+
+		// Adds a newly converted texture with one reference.
 		void addTexture(VoxelTexture &&texture, TextureAssetReference &&textureAssetRef);
 
-		const VoxelTexture &getTexture(const TextureAssetReference &textureAssetRef) const;
+		void removeReference(const TextureAssetReference &textureAssetRef);
 
-		void clear();
+		// Drops all references for a level transition. Textures stay resident until evicted.
+		void releaseAll();
+
+		// Evicts unreferenced textures until within the budget.
+		void evictUnreferenced();
+
+		// Resolves the texture indices of any voxel definitions not resolved yet. Must be called
+		// before rendering whenever textures or voxel definitions may have changed.
+		void resolveVoxelTextures(const VoxelGrid &voxelGrid);
+
+		const VoxelTexture &getTexture(uint16_t voxelID, int slot) const;
+	};
+
+	// Identifies a converted flat texture. The same keyframe texture is converted separately
+	// when flipped or reflective.
+	struct FlatTextureKey
+	{
+		TextureAssetReference textureAssetRef;
+		bool flipped, reflective;
+
+		FlatTextureKey(const TextureAssetReference &textureAssetRef, bool flipped, bool reflective);
+
+		bool operator<(const FlatTextureKey &other) const;
+	};
+
+	// Converted flat textures shared by every entity render ID that uses them. Reference-counted
+	// like voxel textures so they stay resident across level transitions.
+	struct FlatTextures
+	{
+		// Unreferenced textures are evicted when over this many bytes.
+		static constexpr size_t RESIDENCY_BUDGET_BYTES = 64 * 1024 * 1024;
+
+		std::vector<FlatTexture> textures;
+		std::vector<std::optional<FlatTextureKey>> keys; // One per texture slot. Empty if evicted.
+		std::map<FlatTextureKey, int> indices;
+		TextureResidency residency;
+		double conversionTime; // Seconds spent converting since the last level transition.
+
+		FlatTextures();
+
+		// Gets the texture's index with a new reference, converting it if it isn't resident.
+		int addReference(const FlatTextureKey &key, const TextureBuilder &textureBuilder);
+
+		// Drops all references for a level transition. Textures stay resident until evicted.
+		void releaseAll();
+
+		// Evicts unreferenced textures until within the budget.
+		void evictUnreferenced();
+
+		const FlatTexture &getTexture(int index) const;
 	};
 
 	// Camera for 2.5D ray casting (with some pre-calculated values to avoid duplicating work).
@@ -228,6 +366,26 @@ private:
 		void update(int yStart, int yEnd);
 	};
 
+	// Voxel columns stepped through by 2D ray casts, including the ones jumped over in empty
+	// occupancy blocks.
+	struct RayStepCounts
+	{
+		int stepCount, skippedStepCount;
+
+		RayStepCounts();
+
+		void add(const RayStepCounts &other);
+	};
+
+	// How long each group of render stages took in the most recent frame, as seen by the main
+	// thread while it waits on the render threads.
+	struct StageTimes
+	{
+		double sky, voxels, planes, flats;
+
+		StageTimes();
+	};
+
 	// Helper struct for ray search operations (i.e., finding if a ray intersects a 
 	// diagonal line segment).
 	struct RayHit
@@ -290,14 +448,35 @@ private:
 
 	// Helper struct for values related to the frame buffer. The pointers are owned
 	// elsewhere; they are copied here simply for convenience.
+	struct VisibleLightList;
+
+	// A floor or ceiling plane that a pixel column deferred to the row-based plane pass. The
+	// perpendicular depth of a plane is constant along a screen row, so the row pass can step
+	// texture coordinates linearly instead of dividing per pixel.
+	struct PlaneSpan
+	{
+		const VoxelTexture *texture;
+		const VisibleLightList *visLightList;
+		double planeY; // Height of the plane in world space.
+		int voxelY; // Voxel the plane belongs to, for the hit buffer.
+		Double3 normal;
+
+		PlaneSpan(const VoxelTexture &texture, const VisibleLightList &visLightList, double planeY,
+			int voxelY, const Double3 &normal);
+	};
+
 	struct FrameView
 	{
 		uint32_t *colorBuffer;
 		double *depthBuffer;
+		std::vector<PlaneSpan> *planeSpans; // Deferred planes per column.
+		uint16_t *planeSpanIDs; // Per pixel, 0 if empty or a plane span index + 1 for that column.
+		uint32_t *hitIDs; // Per pixel, which voxel face or visible flat was drawn (0 if none). Null if unused.
 		int width, height;
 		double widthReal, heightReal;
 
-		FrameView(uint32_t *colorBuffer, double *depthBuffer, int width, int height);
+		FrameView(uint32_t *colorBuffer, double *depthBuffer, std::vector<PlaneSpan> *planeSpans,
+			uint16_t *planeSpanIDs, uint32_t *hitIDs, int width, int height);
 	};
 
 	// Each renderable entity ID has a set of animation state mappings to groups of texture
@@ -306,8 +485,8 @@ private:
 	{
 	private:
 		// Slimmed-down copies of entity animation definitions for rendering. One texture list
-		// per facing/direction, stored clockwise.
-		using TextureList = std::vector<FlatTexture>;
+		// per facing/direction, stored clockwise. Textures are indices into the flat textures.
+		using TextureList = std::vector<int>;
 		using State = std::vector<TextureList>;
 
 		// Accessible like entity animations. Index of state is determined by anim state name.
@@ -317,17 +496,16 @@ private:
 	public:
 		// State ID points into states list, angle ID points into texture lists, and texture ID
 		// points into texture list.
-		const FlatTexture &getTexture(int stateID, int angleID, int textureID) const;
+		int getTextureIndex(int stateID, int angleID, int textureID) const;
 
 		// Initializes internal buffers to fit each discrete frame of the given entity animation.
 		// Basically "I want to allocate space for this animation, and textures will come next".
 		// Each keyframe's texture should be populated immediately afterwards by the caller.
 		void init(const EntityAnimationInstance &animInst);
 
-		// Sets the given texture's data. It is expected that the caller uses the entity animation
-		// instance to determine which textures to loop over.
-		void setTexture(int stateID, int angleID, int textureID, bool flipped,
-			const TextureBuilder &textureBuilder, bool reflective);
+		// Sets the given texture's index in the flat textures. It is expected that the caller uses
+		// the entity animation instance to determine which textures to loop over.
+		void setTextureIndex(int stateID, int angleID, int textureID, int textureIndex);
 	};
 
 	// Each flat texture group is indexed by the entity render ID.
@@ -359,6 +537,13 @@ private:
 		int animStateID;
 		int animAngleID;
 		int animTextureID;
+
+		// Texture resolved from the look-up values once per frame.
+		const FlatTexture *texture;
+
+		// For picking from the frame. The generation catches the entity ID being reused since.
+		EntityID entityID;
+		int entityGeneration;
 	};
 
 	// Pairs together a distant sky object with its render texture index. If it's an animation,
@@ -382,9 +567,14 @@ private:
 		std::vector<DistantObject<DistantSky::AnimatedLandObject>> animLands;
 		std::vector<DistantObject<DistantSky::AirObject>> airs;
 		std::vector<DistantObject<DistantSky::MoonObject>> moons;
-		std::vector<DistantObject<DistantSky::StarObject>> stars;
+		std::vector<DistantObject<DistantSky::StarObject>> stars; // Large stars only.
 		int sunTextureIndex; // Points into skyTextures if the sun exists, or NO_SUN if it doesn't.
 
+		// Small stars are single texels, so they are kept as packed unit directions and colors
+		// instead of one sky texture each.
+		std::vector<float> smallStarDirXs, smallStarDirYs, smallStarDirZs;
+		std::vector<uint32_t> smallStarColors;
+
 		// @temp hack to assist with animated land texture count determination.
 		const DistantSky *distantSky;
 		TextureManager *textureManager;
@@ -410,9 +600,20 @@ private:
 			double xProjEnd, int xStart, int xEnd, bool emissive);
 	};
 
+	// A small star that has been projected on-screen. It is drawn as a solid block of color, so
+	// no texture coordinates are needed.
+	struct VisSmallStar
+	{
+		Double3 color;
+		int xStart, xEnd, yStart, yEnd; // Pixel coordinates.
+
+		VisSmallStar(const Double3 &color, int xStart, int xEnd, int yStart, int yEnd);
+	};
+
 	struct VisDistantObjects
 	{
 		std::vector<VisDistantObject> objs;
+		std::vector<VisSmallStar> smallStars; // Only filled when the sky is dark enough.
 
 		// Need to store start and end indices for each range so we can call different 
 		// shading methods on some of them. End indices are exclusive.
@@ -495,6 +696,7 @@ private:
 			const VoxelTextures *voxelTextures;
 			const ChasmTextureGroups *chasmTextureGroups;
 			Buffer<OcclusionData> *occlusion;
+			RayStepCounts rayStepCounts; // Totals from all render threads.
 			double ceilingHeight;
 			int chunkDistance;
 			bool doneLightVisTesting; // True when render threads can start rendering voxels.
@@ -505,6 +707,16 @@ private:
 				Buffer<OcclusionData> &occlusion);
 		};
 
+		struct Planes
+		{
+			int threadsDone;
+			const std::vector<VisibleLight> *visLights;
+			const Buffer<double> *depthScales; // Ray distance per unit of perpendicular depth for each column.
+			bool doneVoxels; // True when render threads can start rendering floor and ceiling rows.
+
+			void init(const std::vector<VisibleLight> &visLights, const Buffer<double> &depthScales);
+		};
+
 		struct Flats
 		{
 			int threadsDone;
@@ -512,18 +724,17 @@ private:
 			const std::vector<VisibleFlat> *visibleFlats;
 			const std::vector<VisibleLight> *visLights;
 			const Buffer2D<VisibleLightList> *visLightLists;
-			const FlatTextureGroups *flatTextureGroups;
 			bool doneSorting; // True when render threads can start rendering flats.
 
 			void init(const Double3 &flatNormal, const std::vector<VisibleFlat> &visibleFlats,
 				const std::vector<VisibleLight> &visLights,
-				const Buffer2D<VisibleLightList> &visLightLists,
-				const FlatTextureGroups &flatTextureGroups);
+				const Buffer2D<VisibleLightList> &visLightLists);
 		};
 
 		SkyGradient skyGradient;
 		DistantSky distantSky;
 		Voxels voxels;
+		Planes planes;
 		Flats flats;
 		const Camera *camera;
 		const ShadingInfo *shadingInfo;
@@ -553,20 +764,29 @@ private:
 
 	Buffer2D<double> depthBuffer;
 	Buffer<OcclusionData> occlusion; // 1D buffer, min and max Y for each pixel column.
+	Buffer<std::vector<PlaneSpan>> planeSpans; // Deferred floors and ceilings for each pixel column.
+	Buffer2D<uint16_t> planeSpanIDs; // Which deferred plane covers each pixel, if any.
+	Buffer2D<uint32_t> hitIDs; // Which voxel face or visible flat covers each pixel. Only allocated when active.
+	bool hitIDsActive;
+	Buffer<double> planeDepthScales; // Ray distance per unit of perpendicular depth for each column.
 	std::vector<const Entity*> potentiallyVisibleFlats; // Updated every frame.
 	std::vector<VisibleFlat> visibleFlats; // Flats to be drawn.
+	int culledFlatCount, culledLightCount; // Entities skipped by the level's potentially visible set.
 	DistantObjects distantObjects; // Distant sky objects (mountains, clouds, etc.).
 	VisDistantObjects visDistantObjs; // Visible distant sky objects.
 	Buffer2D<VisibleLightList> visLightLists; // Potentially-visible voxel column references to visible lights.
 	std::vector<VisibleLight> visibleLights; // Lights that contribute to the current frame.
 	VoxelTextures voxelTextures; // Voxel textures and their mappings.
-	FlatTextureGroups flatTextureGroups; // Entity anim textures accessed by entity render ID.
+	FlatTextures flatTextures; // Entity anim textures shared between entity render IDs.
+	FlatTextureGroups flatTextureGroups; // Entity anim texture indices accessed by entity render ID.
 	ChasmTextureGroups chasmTextureGroups; // Mappings from chasm ID to textures.
+	ChasmTextureGroups prevChasmTextureGroups; // Chasm textures of the previous level, for reuse.
 	std::vector<SkyTexture> skyTextures; // Distant object textures. Size is managed internally.
 	std::vector<Double3> skyPalette; // Colors for each time of day.
 	Buffer<Double3> skyGradientRowCache; // Contains row colors of most recent sky gradient.
 	Buffer<std::thread> renderThreads; // Threads used for rendering the world.
 	RenderThreadData threadData; // Managed by main thread, used by render threads.
+	StageTimes stageTimes; // Seconds per stage group in the most recent frame.
 	double fogDistance; // Distance at which fog is maximum.
 	int width, height; // Dimensions of frame buffer.
 	int renderThreadsMode; // Determines number of threads to use for rendering.
@@ -583,6 +803,11 @@ private:
 	void updateVisibleDistantObjects(const ShadingInfo &shadingInfo, const Camera &camera,
 		const FrameView &frame);
 
+	// Refreshes the list of small stars to be drawn. This is separate from other distant objects
+	// so it can be skipped when the sky gradient is too bright for stars.
+	void updateVisibleSmallStars(const ShadingInfo &shadingInfo, const Camera &camera,
+		const FrameView &frame);
+
 	// Refreshes the list of potentially visible flats (to be passed to actually-visible flat
 	// calculation).
 	static void updatePotentiallyVisibleFlats(const Camera &camera, SNInt gridWidth, WEInt gridDepth,
@@ -591,8 +816,8 @@ private:
 
 	// Refreshes the list of flats to be drawn.
 	void updateVisibleFlats(const Camera &camera, const ShadingInfo &shadingInfo, int chunkDistance,
-		double ceilingHeight, const VoxelGrid &voxelGrid, const EntityManager &entityManager,
-		const EntityDefinitionLibrary &entityDefLibrary);
+		double ceilingHeight, const VoxelGrid &voxelGrid, const PotentiallyVisibleSet &potentiallyVisibleSet,
+		const EntityManager &entityManager, const EntityDefinitionLibrary &entityDefLibrary);
 
 	// Refreshes the visible light lists in each voxel column in the view frustum.
 	void updateVisibleLightLists(const Camera &camera, int chunkDistance, double ceilingHeight,
@@ -722,20 +947,20 @@ private:
 	// Low-level shader for wall pixel rendering. Template parameters are used for
 	// compile-time generation of shader permutations.
 	template <bool Fading>
-	static void drawPixelsShader(int x, const DrawRange &drawRange, double depth, double u,
+	static void drawPixelsShader(int x, const NewInt3 &voxel, const DrawRange &drawRange, double depth, double u,
 		double vStart, double vEnd, const Double3 &normal, const VoxelTexture &texture,
 		double fadePercent, double lightContributionPercent, const ShadingInfo &shadingInfo,
 		OcclusionData &occlusion, const FrameView &frame);
 
 	// Draws a column of pixels with no perspective or transparency.
-	static void drawPixels(int x, const DrawRange &drawRange, double depth, double u,
+	static void drawPixels(int x, const NewInt3 &voxel, const DrawRange &drawRange, double depth, double u,
 		double vStart, double vEnd, const Double3 &normal, const VoxelTexture &texture,
 		double fadePercent, double lightContributionPercent, const ShadingInfo &shadingInfo,
 		OcclusionData &occlusion, const FrameView &frame);
 
 	// Low-level shader for perspective pixel rendering.
 	template <bool Fading>
-	static void drawPerspectivePixelsShader(int x, const DrawRange &drawRange,
+	static void drawPerspectivePixelsShader(int x, const NewInt3 &voxel, const DrawRange &drawRange,
 		const NewDouble2 &startPoint, const NewDouble2 &endPoint, double depthStart, double depthEnd,
 		const Double3 &normal, const VoxelTexture &texture, double fadePercent,
 		const BufferView<const VisibleLight> &visLights, const VisibleLightList &visLightList,
@@ -743,14 +968,22 @@ private:
 
 	// Draws a column of pixels with perspective but no transparency. The pixel drawing order is 
 	// top to bottom, so the start and end values should be passed with that in mind.
-	static void drawPerspectivePixels(int x, const DrawRange &drawRange, const NewDouble2 &startPoint,
+	static void drawPerspectivePixels(int x, const NewInt3 &voxel, const DrawRange &drawRange, const NewDouble2 &startPoint,
 		const NewDouble2 &endPoint, double depthStart, double depthEnd, const Double3 &normal,
 		const VoxelTexture &texture, double fadePercent, const BufferView<const VisibleLight> &visLights,
 		const VisibleLightList &visLightList, const ShadingInfo &shadingInfo, OcclusionData &occlusion,
 		const FrameView &frame);
 
+	// Draws the top of a floor or the bottom of a ceiling. Unless it's fading, the column's pixels
+	// are only claimed here and are shaded later by drawPlaneRows().
+	static void drawPlanePixels(int x, const NewInt3 &voxel, const DrawRange &drawRange, const NewDouble2 &startPoint,
+		const NewDouble2 &endPoint, double depthStart, double depthEnd, double planeY,
+		const Double3 &normal, const VoxelTexture &texture, double fadePercent,
+		const BufferView<const VisibleLight> &visLights, const VisibleLightList &visLightList,
+		const ShadingInfo &shadingInfo, OcclusionData &occlusion, const FrameView &frame);
+
 	// Draws a column of pixels with transparency but no perspective.
-	static void drawTransparentPixels(int x, const DrawRange &drawRange, double depth, double u,
+	static void drawTransparentPixels(int x, const NewInt3 &voxel, const DrawRange &drawRange, double depth, double u,
 		double vStart, double vEnd, const Double3 &normal, const VoxelTexture &texture,
 		double lightContributionPercent, const ShadingInfo &shadingInfo,
 		const OcclusionData &occlusion, const FrameView &frame);
@@ -758,13 +991,13 @@ private:
 	// Low-level shader for chasm pixel rendering.
 	// @todo: consider template bool for treating screen-space texels as regular texels.
 	template <bool AmbientShading, bool TrueDepth>
-	static void drawChasmPixelsShader(int x, const DrawRange &drawRange, double depth, double u,
+	static void drawChasmPixelsShader(int x, const NewInt3 &voxel, const DrawRange &drawRange, double depth, double u,
 		double vStart, double vEnd, const Double3 &normal, const VoxelTexture &texture,
 		const ChasmTexture &chasmTexture, double lightContributionPercent,
 		const ShadingInfo &shadingInfo, OcclusionData &occlusion, const FrameView &frame);
 
 	// Draws a column of chasm pixels that can either be a wall texture or screen-space texture.
-	static void drawChasmPixels(int x, const DrawRange &drawRange, double depth, double u,
+	static void drawChasmPixels(int x, const NewInt3 &voxel, const DrawRange &drawRange, double depth, double u,
 		double vStart, double vEnd, const Double3 &normal, bool emissive, const VoxelTexture &texture,
 		const ChasmTexture &chasmTexture, double lightContributionPercent,
 		const ShadingInfo &shadingInfo, OcclusionData &occlusion, const FrameView &frame);
@@ -773,14 +1006,14 @@ private:
 	// the screen-space texture instead of branching on chasm wall texels.
 	// @todo: consider template bool for treating screen-space texels as regular texels.
 	template <bool AmbientShading, bool TrueDepth>
-	static void drawPerspectiveChasmPixelsShader(int x, const DrawRange &drawRange,
+	static void drawPerspectiveChasmPixelsShader(int x, const NewInt3 &voxel, const DrawRange &drawRange,
 		const NewDouble2 &startPoint, const NewDouble2 &endPoint, double depthStart, double depthEnd,
 		const Double3 &normal, const ChasmTexture &texture, const ShadingInfo &shadingInfo,
 		OcclusionData &occlusion, const FrameView &frame);
 
 	// Draws a column of chasm pixels with perspective and no transparency. The pixel drawing order
 	// is top to bottom, so the start and end values should be passed with that in mind.
-	static void drawPerspectiveChasmPixels(int x, const DrawRange &drawRange,
+	static void drawPerspectiveChasmPixels(int x, const NewInt3 &voxel, const DrawRange &drawRange,
 		const NewDouble2 &startPoint, const NewDouble2 &endPoint, double depthStart, double depthEnd,
 		const Double3 &normal, bool emissive, const ChasmTexture &texture,
 		const ShadingInfo &shadingInfo, OcclusionData &occlusion, const FrameView &frame);
@@ -803,12 +1036,21 @@ private:
 		double vEnd, const SkyTexture &texture, const ShadingInfo &shadingInfo,
 		const FrameView &frame);
 
+	// Gets the color of a star pixel blended with the sky gradient behind it, or returns false if
+	// the gradient is too bright for the star to be seen.
+	static bool tryGetStarPixelColor(const Double3 &starColor, const Double3 &gradientColor,
+		uint32_t *outColor);
+
 	// Draws a column of pixels for a star. This is its own pixel-rendering method because of
 	// the unique method of shading required for stars.
 	static void drawStarPixels(int x, const DrawRange &drawRange, double u, double vStart,
 		double vEnd, const SkyTexture &texture, const Buffer<Double3> &skyGradientRowCache,
 		const ShadingInfo &shadingInfo, const FrameView &frame);
 
+	// Draws a column of pixels for a small star, which is a single color.
+	static void drawSmallStarPixels(int x, int yStart, int yEnd, const Double3 &color,
+		const Buffer<Double3> &skyGradientRowCache, const FrameView &frame);
+
 	// Helper functions for drawing the initial voxel column.
 	static void drawInitialVoxelSameFloor(int x, SNInt voxelX, int voxelY, WEInt voxelZ,
 		const Camera &camera, const Ray &ray, VoxelFacing2D facing, const NewDouble2 &nearPoint,
@@ -873,20 +1115,21 @@ private:
 
 	// Draws the portion of a flat contained within the given X range of the screen. The end
 	// X value is exclusive.
-	static void drawFlat(int startX, int endX, const VisibleFlat &flat, const Double3 &normal,
+	static void drawFlat(int startX, int endX, const VisibleFlat &flat, uint32_t hitID, const Double3 &normal,
 		const NewDouble2 &eye, const NewInt2 &eyeVoxelXZ, double horizonProjY, const ShadingInfo &shadingInfo,
 		const Palette *overridePalette, int chunkDistance, const FlatTexture &texture,
 		const BufferView<const VisibleLight> &visLights, const BufferView2D<const VisibleLightList> &visLightLists,
 		SNInt gridWidth, WEInt gridDepth, const FrameView &frame);
 
 	// Casts a 2D ray that steps through the current floor, rendering all voxels
-	// in the XZ column of each voxel.
+	// in the XZ column of each voxel. Blocks of all-air columns are jumped over.
 	template <bool NonNegativeDirX, bool NonNegativeDirZ>
 	static void rayCast2DInternal(int x, const Camera &camera, const Ray &ray,
 		const ShadingInfo &shadingInfo, int chunkDistance, double ceilingHeight,
 		const LevelData &levelData, const BufferView<const VisibleLight> &visLights,
 		const BufferView2D<const VisibleLightList> &visLightLists, const VoxelTextures &textures,
-		const ChasmTextureGroups &chasmTextureGroups, OcclusionData &occlusion, const FrameView &frame);
+		const ChasmTextureGroups &chasmTextureGroups, OcclusionData &occlusion, RayStepCounts &rayStepCounts,
+		const FrameView &frame);
 
 	// Helper method for internal ray casting function that takes template parameters for better
 	// code generation.
@@ -894,7 +1137,8 @@ private:
 		int chunkDistance, double ceilingHeight, const LevelData &levelData,
 		const BufferView<const VisibleLight> &visLights,
 		const BufferView2D<const VisibleLightList> &visLightLists, const VoxelTextures &textures,
-		const ChasmTextureGroups &chasmTextureGroups, OcclusionData &occlusion, const FrameView &frame);
+		const ChasmTextureGroups &chasmTextureGroups, OcclusionData &occlusion, RayStepCounts &rayStepCounts,
+		const FrameView &frame);
 
 	// Draws a portion of the sky gradient. The start and end Y are determined from current
 	// threading settings.
@@ -913,12 +1157,18 @@ private:
 		double ceilingHeight, const LevelData &levelData, const BufferView<const VisibleLight> &visLights,
 		const BufferView2D<const VisibleLightList> &visLightLists, const VoxelTextures &voxelTextures,
 		const ChasmTextureGroups &chasmTextureGroups, Buffer<OcclusionData> &occlusion,
+		const ShadingInfo &shadingInfo, RayStepCounts &rayStepCounts, const FrameView &frame);
+
+	// Draws some rows of the floor and ceiling spans deferred by the voxel pass. Must run after all
+	// voxel columns are done.
+	static void drawPlaneRows(int startY, int endY, const Camera &camera,
+		const BufferView<const VisibleLight> &visLights, const Buffer<double> &depthScales,
 		const ShadingInfo &shadingInfo, const FrameView &frame);
 
 	// Handles drawing all flats for the current frame.
 	static void drawFlats(int startX, int endX, const Camera &camera, const Double3 &flatNormal,
-		const std::vector<VisibleFlat> &visibleFlats, const FlatTextureGroups &flatTextureGroups,
-		const ShadingInfo &shadingInfo, int chunkDistance, const BufferView<const VisibleLight> &visLights,
+		const std::vector<VisibleFlat> &visibleFlats, const ShadingInfo &shadingInfo, int chunkDistance,
+		const BufferView<const VisibleLight> &visLights,
 		const BufferView2D<const VisibleLightList> &visLightLists, SNInt gridWidth, WEInt gridDepth,
 		const FrameView &frame);
 
@@ -950,6 +1200,19 @@ public:
 	Double3 screenPointToRay(double xPercent, double yPercent, const Double3 &cameraDirection,
 		Degrees fovY, double aspect) const override;
 
+	// Gets the entity drawn at the given pixel of the most recent frame and its XZ distance from
+	// the camera. Returns false if the hit buffer isn't active or no entity covers the pixel.
+	bool tryGetEntityHit(int x, int y, EntityID *outID, int *outGeneration, double *outDepth) const override;
+
+	// Gets the voxel drawn at the given pixel of the most recent frame, which face of it (if
+	// axis-aligned), and its XZ distance from the camera. Returns false if the hit buffer isn't
+	// active or no pickable voxel covers the pixel.
+	bool tryGetVoxelHit(int x, int y, NewInt3 *outVoxel, std::optional<VoxelFacing3D> *outFacing,
+		double *outDepth) const override;
+
+	// Sets whether the per-pixel hit buffer is written while rendering.
+	void setHitBufferActive(bool active) override;
+
 	// Sets the render threads mode to use (low, medium, high, etc.).
 	void setRenderThreadsMode(int mode) override;
 
@@ -4,22 +4,82 @@
 
 #include "components/debug/Debug.h"
 
-void Chunk::init(const ChunkInt2 &coord, int height)
+void Chunk::VoxelData::init(int height)
 {
-	// Set all voxels to air and unused.
-	this->voxels.init(Chunk::WIDTH, height, Chunk::DEPTH);
-	this->voxels.fill(Chunk::AIR_VOXEL_ID);
+	// Set all voxels to air and unused. Reuse the voxel allocation from a previous lifetime
+	// if possible.
+	if (!this->voxels.isValid() || (this->voxels.getHeight() != height))
+	{
+		this->voxels.init(Chunk::WIDTH, height, Chunk::DEPTH);
+	}
 
-	this->voxelDefs.fill(VoxelDefinition());
-	this->activeVoxelDefs.fill(false);
+	this->voxels.fill(Chunk::AIR_VOXEL_ID);
+	this->clearDefs();
 
 	// Let the first voxel definition (air) be usable immediately. All default voxel IDs can safely
 	// point to it.
 	this->activeVoxelDefs.front() = true;
+}
+
+void Chunk::VoxelData::copyFrom(const VoxelData &other)
+{
+	DebugAssert(other.voxels.isValid());
+	this->voxels.init(other.voxels.getWidth(), other.voxels.getHeight(), other.voxels.getDepth());
+	std::copy(other.voxels.get(), other.voxels.end(), this->voxels.get());
+	this->voxelDefs = other.voxelDefs;
+	this->activeVoxelDefs = other.activeVoxelDefs;
+}
+
+void Chunk::VoxelData::clearDefs()
+{
+	this->voxelDefs.fill(VoxelDefinition());
+	this->activeVoxelDefs.fill(false);
+}
+
+Chunk::VoxelData &Chunk::getWritableVoxelData()
+{
+	DebugAssert(this->voxelData != nullptr);
+
+	// Copy-on-write.
+	if (this->isVoxelDataShared())
+	{
+		auto privateVoxelData = std::make_shared<VoxelData>();
+		privateVoxelData->copyFrom(*this->voxelData);
+		this->voxelData = std::move(privateVoxelData);
+	}
+
+	return *this->voxelData;
+}
+
+void Chunk::init(const ChunkInt2 &coord, int height)
+{
+	// Can't reuse voxel data that other chunks are looking at.
+	if ((this->voxelData == nullptr) || this->isVoxelDataShared())
+	{
+		this->voxelData = std::make_shared<VoxelData>();
+	}
 
+	this->voxelData->init(height);
 	this->coord = coord;
 }
 
+void Chunk::initShared(const ChunkInt2 &coord, const std::shared_ptr<VoxelData> &sharedVoxelData)
+{
+	DebugAssert(sharedVoxelData != nullptr);
+	this->voxelData = sharedVoxelData;
+	this->coord = coord;
+}
+
+const std::shared_ptr<Chunk::VoxelData> &Chunk::getSharedVoxelData() const
+{
+	return this->voxelData;
+}
+
+bool Chunk::isVoxelDataShared() const
+{
+	return this->voxelData.use_count() > 1;
+}
+
 const ChunkInt2 &Chunk::getCoord() const
 {
 	return this->coord;
@@ -27,25 +87,28 @@ const ChunkInt2 &Chunk::getCoord() const
 
 int Chunk::getHeight() const
 {
-	return this->voxels.getHeight();
+	return (this->voxelData != nullptr) ? this->voxelData->voxels.getHeight() : 0;
 }
 
 Chunk::VoxelID Chunk::getVoxel(SNInt x, int y, WEInt z) const
 {
-	return this->voxels.get(x, y, z);
+	DebugAssert(this->voxelData != nullptr);
+	return this->voxelData->voxels.get(x, y, z);
 }
 
 int Chunk::getVoxelDefCount() const
 {
-	return static_cast<int>(std::count(this->activeVoxelDefs.begin(),
-		this->activeVoxelDefs.end(), true));
+	DebugAssert(this->voxelData != nullptr);
+	const auto &activeVoxelDefs = this->voxelData->activeVoxelDefs;
+	return static_cast<int>(std::count(activeVoxelDefs.begin(), activeVoxelDefs.end(), true));
 }
 
 const VoxelDefinition &Chunk::getVoxelDef(VoxelID id) const
 {
-	DebugAssert(id < this->voxelDefs.size());
-	DebugAssert(this->activeVoxelDefs[id]);
-	return this->voxelDefs[id];
+	DebugAssert(this->voxelData != nullptr);
+	DebugAssert(id < this->voxelData->voxelDefs.size());
+	DebugAssert(this->voxelData->activeVoxelDefs[id]);
+	return this->voxelData->voxelDefs[id];
 }
 
 int Chunk::getVoxelInstCount() const
@@ -67,39 +130,73 @@ const VoxelInstance &Chunk::getVoxelInst(int index) const
 
 void Chunk::setVoxel(SNInt x, int y, WEInt z, VoxelID value)
 {
-	this->voxels.set(x, y, z, value);
+	// Avoid copying shared voxel data if nothing would change.
+	if (this->getVoxel(x, y, z) == value)
+	{
+		return;
+	}
+
+	VoxelData &writableVoxelData = this->getWritableVoxelData();
+	writableVoxelData.voxels.set(x, y, z, value);
+}
+
+void Chunk::setVoxels(SNInt x, int y, WEInt z, const LevelDefinition::VoxelDefID *srcIDs, int count)
+{
+	DebugAssert(srcIDs != nullptr);
+	DebugAssert(count >= 0);
+
+	VoxelData &writableVoxelData = this->getWritableVoxelData();
+	VoxelID *dstIDs = &writableVoxelData.voxels.get(x, y, z);
+	DebugAssert((dstIDs + count) <= writableVoxelData.voxels.end());
+
+	// Simple enough loop for the compiler to vectorize.
+	for (int i = 0; i < count; i++)
+	{
+		dstIDs[i] = static_cast<VoxelID>(srcIDs[i]);
+	}
 }
 
 bool Chunk::tryAddVoxelDef(VoxelDefinition &&voxelDef, Chunk::VoxelID *outID)
 {
 	// Find a place to add the voxel data.
-	const auto iter = std::find(this->activeVoxelDefs.begin(), this->activeVoxelDefs.end(), false);
+	const auto &activeVoxelDefs = this->voxelData->activeVoxelDefs;
+	const auto iter = std::find(activeVoxelDefs.begin(), activeVoxelDefs.end(), false);
 
 	// If this is ever true, we need more bits per voxel.
-	if (iter == this->activeVoxelDefs.end())
+	if (iter == activeVoxelDefs.end())
 	{
 		return false;
 	}
 
-	const VoxelID id = static_cast<VoxelID>(std::distance(this->activeVoxelDefs.begin(), iter));
-	this->voxelDefs[id] = std::move(voxelDef);
-	this->activeVoxelDefs[id] = true;
+	const VoxelID id = static_cast<VoxelID>(std::distance(activeVoxelDefs.begin(), iter));
+	VoxelData &writableVoxelData = this->getWritableVoxelData();
+	writableVoxelData.voxelDefs[id] = std::move(voxelDef);
+	writableVoxelData.activeVoxelDefs[id] = true;
 	*outID = id;
 	return true;
 }
 
 void Chunk::removeVoxelDef(VoxelID id)
 {
-	DebugAssert(id < this->voxelDefs.size());
-	this->voxelDefs[id] = VoxelDefinition();
-	this->activeVoxelDefs[id] = false;
+	VoxelData &writableVoxelData = this->getWritableVoxelData();
+	DebugAssert(id < writableVoxelData.voxelDefs.size());
+	writableVoxelData.voxelDefs[id] = VoxelDefinition();
+	writableVoxelData.activeVoxelDefs[id] = false;
 }
 
 void Chunk::clear()
 {
-	this->voxels.clear();
-	this->voxelDefs.fill(VoxelDefinition());
-	this->activeVoxelDefs.fill(false);
+	// Private voxels are left allocated so a recycled chunk doesn't need to allocate again in
+	// init(). Shared voxels are released so their other owners can free them.
+	if (this->isVoxelDataShared())
+	{
+		this->voxelData = nullptr;
+	}
+	else if (this->voxelData != nullptr)
+	{
+		this->voxelData->clearDefs();
+	}
+
 	this->voxelInsts.clear();
 	this->coord = ChunkInt2();
 }
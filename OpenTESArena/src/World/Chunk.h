@@ -5,9 +5,11 @@
 #include <climits>
 #include <cstdint>
 #include <limits>
+#include <memory>
 #include <vector>
 
 #include "ChunkUtils.h"
+#include "LevelDefinition.h"
 #include "VoxelDefinition.h"
 #include "VoxelInstance.h"
 #include "VoxelUtils.h"
@@ -29,27 +31,53 @@ private:
 
 	static constexpr int MAX_VOXEL_DEFS = 1 << BITS_PER_VOXEL;
 	static constexpr VoxelID AIR_VOXEL_ID = 0;
-
-	// Indices into voxel definitions.
-	Buffer3D<VoxelID> voxels;
-
-	// Voxel definitions, pointed to by voxel IDs. If the associated bool is true,
-	// the voxel data is in use by the voxel grid.
-	std::array<VoxelDefinition, MAX_VOXEL_DEFS> voxelDefs;
-	std::array<bool, MAX_VOXEL_DEFS> activeVoxelDefs;
+public:
+	// Voxels and their definitions. Chunks that are identical (i.e., wilderness chunks made from
+	// the same level definition) can point to the same voxel data, and a chunk makes its own copy
+	// before the first modification.
+	struct VoxelData
+	{
+		// Indices into voxel definitions.
+		Buffer3D<VoxelID> voxels;
+
+		// Voxel definitions, pointed to by voxel IDs. If the associated bool is true,
+		// the voxel data is in use by the voxel grid.
+		std::array<VoxelDefinition, MAX_VOXEL_DEFS> voxelDefs;
+		std::array<bool, MAX_VOXEL_DEFS> activeVoxelDefs;
+
+		void init(int height);
+		void copyFrom(const VoxelData &other);
+		void clearDefs();
+	};
+private:
+	std::shared_ptr<VoxelData> voxelData;
 
 	// Instance data for voxels that are uniquely different in some way.
 	std::vector<VoxelInstance> voxelInsts;
 
 	// Chunk coordinates in the world.
 	ChunkInt2 coord;
+
+	// Gets voxel data that is safe to modify, copying it first if it's shared with other chunks.
+	VoxelData &getWritableVoxelData();
 public:
 	static constexpr SNInt WIDTH = ChunkUtils::CHUNK_DIM;
 	static constexpr WEInt DEPTH = WIDTH;
 	static_assert(MathUtils::isPowerOf2(WIDTH));
 
+	// Initializes the chunk with its own empty voxel data.
 	void init(const ChunkInt2 &coord, int height);
 
+	// Initializes the chunk with voxel data shared with other chunks. The voxel data is copied
+	// when the chunk is first modified.
+	void initShared(const ChunkInt2 &coord, const std::shared_ptr<VoxelData> &sharedVoxelData);
+
+	// Gets the chunk's voxel data so other chunks can share it.
+	const std::shared_ptr<VoxelData> &getSharedVoxelData() const;
+
+	// Returns whether the chunk's voxel data is also used by other chunks (or a chunk template).
+	bool isVoxelDataShared() const;
+
 	int getHeight() const;
 
 	// Gets the chunk's XY coordinate in the world.
@@ -74,13 +102,17 @@ public:
 	// Sets the voxel at the given coordinate.
 	void setVoxel(SNInt x, int y, WEInt z, VoxelID id);
 
+	// Sets a run of voxels in memory order (X, then Y, then Z) starting at the given coordinate,
+	// narrowing each source ID. The caller is expected to have range-checked the IDs.
+	void setVoxels(SNInt x, int y, WEInt z, const LevelDefinition::VoxelDefID *srcIDs, int count);
+
 	// Attempts to add a voxel definition and returns its assigned ID.
 	bool tryAddVoxelDef(VoxelDefinition &&voxelDef, VoxelID *outID);
 
 	// Removes a voxel definition so its corresponding voxel ID can be reused.
 	void removeVoxelDef(VoxelID id);
 
-	// Clears all chunk state.
+	// Clears all chunk state. Voxel storage stays allocated for reuse if it isn't shared.
 	void clear();
 
 	// Animates the chunk's voxels by delta time.
@@ -10,6 +10,20 @@
 #include "components/debug/Debug.h"
 #include "components/utilities/Buffer.h"
 
+ChunkManager::ChunkManager()
+{
+	this->chunkTemplateMapGeneration = -1;
+	this->poolHitCount = 0;
+	this->allocationCount = 0;
+}
+
+int ChunkManager::getMaxPooledChunkCount(int chunkDistance)
+{
+	DebugAssert(chunkDistance >= 1);
+	const int sideLength = (chunkDistance * 2) + 1;
+	return (sideLength * 2) - 1;
+}
+
 int ChunkManager::getChunkCount() const
 {
 	return static_cast<int>(this->activeChunks.size());
@@ -35,15 +49,10 @@ const Chunk &ChunkManager::getChunk(int index) const
 
 std::optional<int> ChunkManager::tryGetChunkIndex(const ChunkInt2 &coord) const
 {
-	const auto iter = std::find_if(this->activeChunks.begin(), this->activeChunks.end(),
-		[&coord](const ChunkPtr &chunkPtr)
-	{
-		return chunkPtr->getCoord() == coord;
-	});
-
-	if (iter != this->activeChunks.end())
+	const auto iter = this->activeChunkIndices.find(coord);
+	if (iter != this->activeChunkIndices.end())
 	{
-		return static_cast<int>(std::distance(this->activeChunks.begin(), iter));
+		return iter->second;
 	}
 	else
 	{
@@ -58,20 +67,46 @@ int ChunkManager::getCenterChunkIndex() const
 	return *index;
 }
 
-int ChunkManager::spawnChunk()
+int ChunkManager::getPooledChunkCount() const
+{
+	return static_cast<int>(this->chunkPool.size());
+}
+
+int ChunkManager::getPoolHitCount() const
+{
+	return this->poolHitCount;
+}
+
+int ChunkManager::getAllocationCount() const
 {
+	return this->allocationCount;
+}
+
+int ChunkManager::getChunkTemplateCount() const
+{
+	return static_cast<int>(this->chunkTemplates.size());
+}
+
+int ChunkManager::spawnChunk(const ChunkInt2 &coord)
+{
+	DebugAssert(this->activeChunkIndices.find(coord) == this->activeChunkIndices.end());
+
 	if (!this->chunkPool.empty())
 	{
 		this->activeChunks.emplace_back(std::move(this->chunkPool.back()));
 		this->chunkPool.pop_back();
+		this->poolHitCount++;
 	}
 	else
 	{
 		// Always allow expanding in the event that chunk distance is increased.
 		this->activeChunks.emplace_back(std::make_unique<Chunk>());
+		this->allocationCount++;
 	}
 
-	return static_cast<int>(this->activeChunks.size()) - 1;
+	const int index = static_cast<int>(this->activeChunks.size()) - 1;
+	this->activeChunkIndices.emplace(coord, index);
+	return index;
 }
 
 void ChunkManager::recycleChunk(int index, EntityManager &entityManager)
@@ -86,7 +121,18 @@ void ChunkManager::recycleChunk(int index, EntityManager &entityManager)
 	// time when references get invalidated.
 	chunkPtr->clear();
 	this->chunkPool.emplace_back(std::move(chunkPtr));
-	this->activeChunks.erase(this->activeChunks.begin() + index);
+	this->activeChunkIndices.erase(coord);
+
+	// Fill the hole with the last active chunk so no other indices shift.
+	const int lastIndex = static_cast<int>(this->activeChunks.size()) - 1;
+	if (index != lastIndex)
+	{
+		ChunkPtr &lastChunkPtr = this->activeChunks[lastIndex];
+		this->activeChunkIndices[lastChunkPtr->getCoord()] = index;
+		this->activeChunks[index] = std::move(lastChunkPtr);
+	}
+
+	this->activeChunks.pop_back();
 
 	// Notify entity manager that the chunk is being cleared.
 	entityManager.clearChunk(coord);
@@ -107,6 +153,12 @@ void ChunkManager::populateChunkFromLevel(Chunk &chunk, const LevelDefinition &l
 		}
 	}
 
+	ChunkManager::populateChunkVoxels(chunk, levelDefinition, levelOffset);
+}
+
+void ChunkManager::populateChunkVoxels(Chunk &chunk, const LevelDefinition &levelDefinition,
+	const LevelInt2 &levelOffset)
+{
 	// Iterate only the portion of the level that the chunk overlaps.
 	const SNInt startX = levelOffset.x;
 	const SNInt endX = std::min(startX + Chunk::WIDTH, levelDefinition.getWidth());
@@ -115,30 +167,90 @@ void ChunkManager::populateChunkFromLevel(Chunk &chunk, const LevelDefinition &l
 	const WEInt startZ = levelOffset.y;
 	const WEInt endZ = std::min(startZ + Chunk::DEPTH, levelDefinition.getDepth());
 
-	// Set voxels.
-	for (WEInt z = startZ; z < endZ; z++)
+	// Set voxels. If every voxel definition ID in the level fits in a chunk voxel ID then copy
+	// whole runs of voxels at once, otherwise check each one.
+	const LevelDefinition::VoxelDefID maxVoxelDefID = levelDefinition.getMaxVoxelDefID();
+	const Chunk::VoxelID maxVoxelID = static_cast<Chunk::VoxelID>(maxVoxelDefID);
+	const bool canBulkCopy = static_cast<LevelDefinition::VoxelDefID>(maxVoxelID) == maxVoxelDefID;
+
+	if (canBulkCopy)
 	{
-		for (int y = startY; y < endY; y++)
+		const int rowWidth = endX - startX;
+		const bool isFullWidth = (startX == 0) && (levelDefinition.getWidth() == Chunk::WIDTH);
+		if (isFullWidth)
 		{
-			for (SNInt x = startX; x < endX; x++)
+			// Level and chunk have the same XY plane layout, so each plane is contiguous in both.
+			const int planeSize = Chunk::WIDTH * (endY - startY);
+			for (WEInt z = startZ; z < endZ; z++)
 			{
-				const VoxelInt3 chunkVoxel(x - startX, y - startY, z - startZ);
-
-				// Convert the voxel definition ID to a chunk voxel ID. If they don't match then the
-				// chunk doesn't support that high of a voxel definition ID.
-				const LevelDefinition::VoxelDefID voxelDefID = levelDefinition.getVoxel(x, y, z);
-				const Chunk::VoxelID voxelID = static_cast<Chunk::VoxelID>(voxelDefID);
-				if (static_cast<LevelDefinition::VoxelDefID>(voxelID) != voxelDefID)
+				const LevelDefinition::VoxelDefID *srcIDs = levelDefinition.getVoxelPtr(startX, startY, z);
+				chunk.setVoxels(0, 0, z - startZ, srcIDs, planeSize);
+			}
+		}
+		else
+		{
+			for (WEInt z = startZ; z < endZ; z++)
+			{
+				for (int y = startY; y < endY; y++)
 				{
-					continue;
+					const LevelDefinition::VoxelDefID *srcIDs = levelDefinition.getVoxelPtr(startX, y, z);
+					chunk.setVoxels(0, y - startY, z - startZ, srcIDs, rowWidth);
+				}
+			}
+		}
+	}
+	else
+	{
+		for (WEInt z = startZ; z < endZ; z++)
+		{
+			for (int y = startY; y < endY; y++)
+			{
+				for (SNInt x = startX; x < endX; x++)
+				{
+					const VoxelInt3 chunkVoxel(x - startX, y - startY, z - startZ);
+
+					// Convert the voxel definition ID to a chunk voxel ID. If they don't match then the
+					// chunk doesn't support that high of a voxel definition ID.
+					const LevelDefinition::VoxelDefID voxelDefID = levelDefinition.getVoxel(x, y, z);
+					const Chunk::VoxelID voxelID = static_cast<Chunk::VoxelID>(voxelDefID);
+					if (static_cast<LevelDefinition::VoxelDefID>(voxelID) != voxelDefID)
+					{
+						continue;
+					}
+
+					chunk.setVoxel(chunkVoxel.x, chunkVoxel.y, chunkVoxel.z, voxelID);
 				}
-
-				chunk.setVoxel(chunkVoxel.x, chunkVoxel.y, chunkVoxel.z, voxelID);
 			}
 		}
 	}
 }
 
+void ChunkManager::updateChunkTemplates(const MapDefinition &mapDefinition)
+{
+	// Templates are keyed on the map's generation, so the map must be initialized.
+	DebugAssert(mapDefinition.getGeneration() >= 0);
+
+	if (this->chunkTemplateMapGeneration != mapDefinition.getGeneration())
+	{
+		this->chunkTemplates.clear();
+		this->chunkTemplateMapGeneration = mapDefinition.getGeneration();
+		return;
+	}
+
+	for (auto iter = this->chunkTemplates.begin(); iter != this->chunkTemplates.end(); )
+	{
+		const std::shared_ptr<Chunk::VoxelData> &voxelData = iter->second;
+		if (voxelData.use_count() == 1)
+		{
+			iter = this->chunkTemplates.erase(iter);
+		}
+		else
+		{
+			++iter;
+		}
+	}
+}
+
 bool ChunkManager::populateChunk(int index, const ChunkInt2 &coord, int activeLevelIndex,
 	const MapDefinition &mapDefinition)
 {
@@ -185,12 +297,24 @@ bool ChunkManager::populateChunk(int index, const ChunkInt2 &coord, int activeLe
 		const int levelDefIndex = mapDefWild.getLevelDefIndex(coord);
 		const LevelDefinition &levelDefinition = mapDefinition.getLevel(levelDefIndex);
 		const LevelInfoDefinition &levelInfoDefinition = mapDefinition.getLevelInfoForLevel(levelDefIndex);
-		chunk.init(coord, levelDefinition.getHeight());
 
-		// Copy level definition directly into chunk.
-		DebugAssert(levelDefinition.getWidth() == Chunk::WIDTH);
-		DebugAssert(levelDefinition.getDepth() == Chunk::DEPTH);
-		this->populateChunkFromLevel(chunk, levelDefinition, levelInfoDefinition, LevelInt2(0, 0));
+		// Share voxels with other chunks made from the same level definition if possible.
+		const auto templateIter = this->chunkTemplates.find(levelDefIndex);
+		if (templateIter != this->chunkTemplates.end())
+		{
+			chunk.initShared(coord, templateIter->second);
+		}
+		else
+		{
+			chunk.init(coord, levelDefinition.getHeight());
+
+			// Copy level definition directly into chunk.
+			DebugAssert(levelDefinition.getWidth() == Chunk::WIDTH);
+			DebugAssert(levelDefinition.getDepth() == Chunk::DEPTH);
+			this->populateChunkFromLevel(chunk, levelDefinition, levelInfoDefinition, LevelInt2(0, 0));
+
+			this->chunkTemplates.emplace(levelDefIndex, chunk.getSharedVoxelData());
+		}
 	}
 	else
 	{
@@ -206,6 +330,12 @@ void ChunkManager::update(double dt, const ChunkInt2 &centerChunk, int activeLev
 {
 	this->centerChunk = centerChunk;
 
+	DebugAssert(mapDefinition.getGeneration() >= 0);
+	if (this->chunkTemplateMapGeneration != mapDefinition.getGeneration())
+	{
+		this->updateChunkTemplates(mapDefinition);
+	}
+
 	// Free any out-of-range chunks.
 	for (int i = static_cast<int>(this->activeChunks.size()) - 1; i >= 0; i--)
 	{
@@ -229,7 +359,7 @@ void ChunkManager::update(double dt, const ChunkInt2 &centerChunk, int activeLev
 			const std::optional<int> index = this->tryGetChunkIndex(coord);
 			if (!index.has_value())
 			{
-				const int spawnIndex = this->spawnChunk();
+				const int spawnIndex = this->spawnChunk(coord);
 				if (!this->populateChunk(spawnIndex, coord, activeLevelIndex, mapDefinition))
 				{
 					DebugLogError("Couldn't populate chunk \"" + std::to_string(spawnIndex) +
@@ -240,8 +370,16 @@ void ChunkManager::update(double dt, const ChunkInt2 &centerChunk, int activeLev
 	}
 
 	// Free any unneeded chunks for memory savings in case the chunk distance was once large
-	// and is now small. This is significant even for chunk distance 2->1, or 25->9 chunks.
-	this->chunkPool.clear();
+	// and is now small. This is significant even for chunk distance 2->1, or 25->9 chunks. The
+	// rest are kept around for the next time the center chunk changes.
+	const int maxPooledChunkCount = ChunkManager::getMaxPooledChunkCount(chunkDistance);
+	if (static_cast<int>(this->chunkPool.size()) > maxPooledChunkCount)
+	{
+		this->chunkPool.resize(maxPooledChunkCount);
+	}
+
+	// Free any chunk templates no longer in use.
+	this->updateChunkTemplates(mapDefinition);
 
 	// Update each chunk so they can animate/destroy faded voxel instances, etc..
 	for (int i = 0; i < static_cast<int>(this->activeChunks.size()) - 1; i++)
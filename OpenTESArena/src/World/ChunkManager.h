@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <optional>
+#include <unordered_map>
 #include <vector>
 
 #include "Chunk.h"
@@ -28,12 +29,29 @@ private:
 
 	std::vector<ChunkPtr> chunkPool;
 	std::vector<ChunkPtr> activeChunks;
+	std::unordered_map<ChunkInt2, int> activeChunkIndices; // Chunk coordinate to active chunk index.
 	ChunkInt2 centerChunk;
 
-	// Takes a chunk from the chunk pool, moves it to the active chunks, and returns its index.
-	int spawnChunk();
+	// Read-only voxel data shared by wilderness chunks made from the same level definition, so
+	// memory scales with the number of distinct blocks instead of visible chunks.
+	std::unordered_map<int, std::shared_ptr<Chunk::VoxelData>> chunkTemplates; // Level def index to voxels.
+	int chunkTemplateMapGeneration; // Generation of the map the templates were made from, or -1 if none.
 
-	// Clears the chunk, including entities, and removes it from the active chunks.
+	// Number of spawned chunks that came from the pool vs. needed a new allocation.
+	int poolHitCount;
+	int allocationCount;
+
+	// Gets the max number of chunks the pool may hold onto between updates. This is the most
+	// that can leave the active range in one step (i.e., moving diagonally), so chunk allocations
+	// only happen when the chunk distance increases.
+	static int getMaxPooledChunkCount(int chunkDistance);
+
+	// Takes a chunk from the chunk pool (or allocates one if the pool is empty), moves it to the
+	// active chunks, and returns its index.
+	int spawnChunk(const ChunkInt2 &coord);
+
+	// Clears the chunk, including entities, and moves it to the chunk pool. The last active chunk
+	// is moved into its slot.
 	void recycleChunk(int index, EntityManager &entityManager);
 
 	// Helper function for setting the chunk's voxels and definitions from the given level. This might
@@ -41,10 +59,16 @@ private:
 	void populateChunkFromLevel(Chunk &chunk, const LevelDefinition &levelDefinition,
 		const LevelInfoDefinition &levelInfoDefinition, const LevelInt2 &levelOffset);
 
+	// Frees chunk templates that aren't used by any active chunk, or all of them if they are from
+	// a different map.
+	void updateChunkTemplates(const MapDefinition &mapDefinition);
+
 	// Fills the chunk with the data required based on its position and the world type.
 	bool populateChunk(int index, const ChunkInt2 &coord, int activeLevelIndex,
 		const MapDefinition &mapDefinition);
 public:
+	ChunkManager();
+
 	int getChunkCount() const;
 	Chunk &getChunk(int index);
 	const Chunk &getChunk(int index) const;
@@ -53,6 +77,17 @@ public:
 	// Index of the chunk all other active chunks surround.
 	int getCenterChunkIndex() const;
 
+	// Profiling counters for chunk recycling.
+	int getPooledChunkCount() const;
+	int getPoolHitCount() const;
+	int getAllocationCount() const;
+	int getChunkTemplateCount() const;
+
+	// Copies the portion of the level's voxels that the chunk overlaps into the chunk. Voxel
+	// definitions are not touched.
+	static void populateChunkVoxels(Chunk &chunk, const LevelDefinition &levelDefinition,
+		const LevelInt2 &levelOffset);
+
 	// Updates the chunk manager with the given chunk as the current center of the game world.
 	// This invalidates all active chunk references and they must be looked up again.
 	void update(double dt, const ChunkInt2 &centerChunk, int activeLevelIndex,
@@ -651,6 +651,11 @@ const VoxelGrid &LevelData::getVoxelGrid() const
 	return this->voxelGrid;
 }
 
+const PotentiallyVisibleSet &LevelData::getPotentiallyVisibleSet() const
+{
+	return this->potentiallyVisibleSet;
+}
+
 const LevelData::Lock *LevelData::getLock(const NewInt2 &voxel) const
 {
 	const auto lockIter = this->locks.find(voxel);
@@ -2307,6 +2312,7 @@ uint16_t LevelData::getChasmIdFromFadedFloorVoxel(const NewInt3 &voxel)
 void LevelData::updateFadingVoxels(const ChunkInt2 &minChunk, const ChunkInt2 &maxChunk, double dt)
 {
 	std::vector<NewInt3> completedVoxels;
+	std::vector<NewInt2> clearedWallColumns;
 
 	for (SNInt chunkX = minChunk.x; chunkX <= maxChunk.x; chunkX++)
 	{
@@ -2348,6 +2354,13 @@ void LevelData::updateFadingVoxels(const ChunkInt2 &minChunk, const ChunkInt2 &m
 									}
 								}();
 
+								const uint16_t oldVoxelID = voxelGrid.getVoxel(voxel.x, voxel.y, voxel.z);
+								const VoxelDefinition &oldVoxelDef = voxelGrid.getVoxelDef(oldVoxelID);
+								if (oldVoxelDef.type == ArenaTypes::VoxelType::Wall)
+								{
+									clearedWallColumns.push_back(NewInt2(voxel.x, voxel.z));
+								}
+
 								// Change the voxel to its empty representation (either air or chasm) and erase
 								// the fading voxel from the list.
 								voxelGrid.setVoxel(voxel.x, voxel.y, voxel.z, newVoxelID);
@@ -2360,6 +2373,12 @@ void LevelData::updateFadingVoxels(const ChunkInt2 &minChunk, const ChunkInt2 &m
 		}
 	}
 
+	// Cleared walls might open up new lines of sight.
+	if (clearedWallColumns.size() > 0)
+	{
+		this->potentiallyVisibleSet.updateClearedColumns(this->voxelGrid, clearedWallColumns);
+	}
+
 	// Update adjacent chasm faces (not sure why this has to be done after, but it works).
 	for (const NewInt3 &voxel : completedVoxels)
 	{
@@ -2711,6 +2730,17 @@ void LevelData::setActive(bool nightLightsAreActive, const WorldData &worldData,
 	loadChasmTextures();
 	loadEntities();
 
+	// Interiors with a ceiling are bounded by their walls, so what can be seen from each part of
+	// the level is worked out up front.
+	if (this->isInterior && !this->interior.outdoorDungeon)
+	{
+		this->potentiallyVisibleSet.init(this->voxelGrid);
+	}
+	else
+	{
+		this->potentiallyVisibleSet.clear();
+	}
+
 	// Level-type-specific loading.
 	if (this->isInterior)
 	{
@@ -2730,10 +2760,15 @@ void LevelData::tick(Game &game, double dt)
 	
 	ChunkInt2 minChunk, maxChunk;
 	ChunkUtils::getSurroundingChunks(playerChunk, chunkDistance, &minChunk, &maxChunk);
+	FrameTimings &frameTimings = game.getFrameTimings();
+	const FrameTimings::TimePoint fadeStartTime = FrameTimings::now();
 	this->updateFadingVoxels(minChunk, maxChunk, dt);
+	frameTimings.addStageTime(FrameTimings::Stage::VoxelUpdate, fadeStartTime);
 
 	// Update entities.
-	this->entityManager.tick(game, dt);
+	const FrameTimings::TimePoint entityStartTime = FrameTimings::now();
+	this->entityManager.tick(game, dt, this->potentiallyVisibleSet);
+	frameTimings.addStageTime(FrameTimings::Stage::EntityTick, entityStartTime);
 
 	// Level-type-specific updating.
 	if (!this->isInterior)
@@ -11,6 +11,7 @@
 
 #include "ArenaLevelUtils.h"
 #include "DistantSky.h"
+#include "PotentiallyVisibleSet.h"
 #include "VoxelGrid.h"
 #include "VoxelInstance.h"
 #include "VoxelUtils.h"
@@ -162,6 +163,7 @@ private:
 	std::vector<std::pair<uint16_t, int>> wallDataMappings, floorDataMappings, map2DataMappings;
 
 	VoxelGrid voxelGrid;
+	PotentiallyVisibleSet potentiallyVisibleSet; // Only computed for interiors with a ceiling.
 	EntityManager entityManager;
 	INFFile inf;
 	std::vector<FlatDef> flatsLists;
@@ -262,6 +264,7 @@ public:
 	const EntityManager &getEntityManager() const;
 	VoxelGrid &getVoxelGrid();
 	const VoxelGrid &getVoxelGrid() const;
+	const PotentiallyVisibleSet &getPotentiallyVisibleSet() const;
 
 	// Returns a pointer to some lock if the given voxel has a lock, or null if it doesn't.
 	const Lock *getLock(const NewInt2 &voxel) const;
@@ -2,6 +2,8 @@
 
 #include "LevelDefinition.h"
 
+#include "components/debug/Debug.h"
+
 LevelDefinition::EntityPlacementDef::EntityPlacementDef(EntityDefID id, std::vector<LevelDouble3> &&positions)
 	: positions(std::move(positions))
 {
@@ -34,10 +36,16 @@ LevelDefinition::BuildingNamePlacementDef::BuildingNamePlacementDef(BuildingName
 	this->id = id;
 }
 
+LevelDefinition::LevelDefinition()
+{
+	this->maxVoxelDefID = 0;
+}
+
 void LevelDefinition::init(SNInt width, int height, WEInt depth)
 {
 	this->voxels.init(width, height, depth);
 	this->voxels.fill(0);
+	this->maxVoxelDefID = 0;
 }
 
 SNInt LevelDefinition::getWidth() const
@@ -62,7 +70,19 @@ LevelDefinition::VoxelDefID LevelDefinition::getVoxel(SNInt x, int y, WEInt z) c
 
 void LevelDefinition::setVoxel(SNInt x, int y, WEInt z, VoxelDefID voxel)
 {
+	DebugAssert(voxel >= 0);
 	this->voxels.set(x, y, z, voxel);
+	this->maxVoxelDefID = std::max(this->maxVoxelDefID, voxel);
+}
+
+const LevelDefinition::VoxelDefID *LevelDefinition::getVoxelPtr(SNInt x, int y, WEInt z) const
+{
+	return &this->voxels.get(x, y, z);
+}
+
+LevelDefinition::VoxelDefID LevelDefinition::getMaxVoxelDefID() const
+{
+	return this->maxVoxelDefID;
 }
 
 int LevelDefinition::getEntityPlacementDefCount() const
@@ -120,6 +140,19 @@ const LevelDefinition::BuildingNamePlacementDef &LevelDefinition::getBuildingNam
 	return this->buildingNamePlacementDefs[index];
 }
 
+std::optional<LevelDefinition::TransitionDefID> LevelDefinition::tryGetTransitionAt(const LevelInt3 &voxel) const
+{
+	const auto iter = this->transitionPlacementIndices.find(voxel);
+	if (iter == this->transitionPlacementIndices.end())
+	{
+		return std::nullopt;
+	}
+
+	const int placementDefIndex = iter->second;
+	DebugAssertIndex(this->transitionPlacementDefs, placementDefIndex);
+	return this->transitionPlacementDefs[placementDefIndex].id;
+}
+
 void LevelDefinition::addEntity(EntityDefID id, const LevelDouble3 &position)
 {
 	const auto iter = std::find_if(this->entityPlacementDefs.begin(), this->entityPlacementDefs.end(),
@@ -185,15 +218,21 @@ void LevelDefinition::addTransition(TransitionDefID id, const LevelInt3 &positio
 		return def.id == id;
 	});
 
+	int placementDefIndex;
 	if (iter != this->transitionPlacementDefs.end())
 	{
 		std::vector<LevelInt3> &positions = iter->positions;
 		positions.push_back(position);
+		placementDefIndex = static_cast<int>(std::distance(this->transitionPlacementDefs.begin(), iter));
 	}
 	else
 	{
 		this->transitionPlacementDefs.emplace_back(id, std::vector<LevelInt3> { position });
+		placementDefIndex = static_cast<int>(this->transitionPlacementDefs.size()) - 1;
 	}
+
+	// Keep the first placement if a voxel somehow has more than one.
+	this->transitionPlacementIndices.emplace(position, placementDefIndex);
 }
 
 void LevelDefinition::addBuildingName(BuildingNameID id, const LevelInt3 &position)
@@ -2,6 +2,8 @@
 #define LEVEL_DEFINITION_H
 
 #include <cstdint>
+#include <optional>
+#include <unordered_map>
 #include <vector>
 
 #include "VoxelUtils.h"
@@ -65,12 +67,19 @@ public:
 	};
 private:
 	Buffer3D<VoxelDefID> voxels;
+	VoxelDefID maxVoxelDefID; // Upper bound of all voxel IDs set so far, for range checking.
 	std::vector<EntityPlacementDef> entityPlacementDefs;
 	std::vector<LockPlacementDef> lockPlacementDefs;
 	std::vector<TriggerPlacementDef> triggerPlacementDefs;
 	std::vector<TransitionPlacementDef> transitionPlacementDefs;
 	std::vector<BuildingNamePlacementDef> buildingNamePlacementDefs;
+
+	// Transition placement def index of each transition voxel, updated as transitions are added so
+	// map generation can look them up while the level is still being built.
+	std::unordered_map<LevelInt3, int> transitionPlacementIndices;
 public:
+	LevelDefinition();
+
 	void init(SNInt width, int height, WEInt depth);
 
 	SNInt getWidth() const;
@@ -80,6 +89,13 @@ public:
 	VoxelDefID getVoxel(SNInt x, int y, WEInt z) const;
 	void setVoxel(SNInt x, int y, WEInt z, VoxelDefID voxel);
 
+	// Gets a pointer to the voxel at the given coordinate. Voxels along X are contiguous.
+	const VoxelDefID *getVoxelPtr(SNInt x, int y, WEInt z) const;
+
+	// Gets a conservative upper bound of the voxel IDs in the level. It's never less than the
+	// largest voxel ID, so a caller can range-check the whole level once.
+	VoxelDefID getMaxVoxelDefID() const;
+
 	int getEntityPlacementDefCount() const;
 	const EntityPlacementDef &getEntityPlacementDef(int index) const;
 	int getLockPlacementDefCount() const;
@@ -91,6 +107,9 @@ public:
 	int getBuildingNamePlacementDefCount() const;
 	const BuildingNamePlacementDef &getBuildingNamePlacementDef(int index) const;
 
+	// Gets the transition placed at the given voxel (if any).
+	std::optional<TransitionDefID> tryGetTransitionAt(const LevelInt3 &voxel) const;
+
 	void addEntity(EntityDefID id, const LevelDouble3 &position);
 	void addLock(LockDefID id, const LevelInt3 &position);
 	void addTrigger(TriggerDefID id, const LevelInt3 &position);
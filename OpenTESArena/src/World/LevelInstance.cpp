@@ -1,6 +1,7 @@
 #include "LevelInstance.h"
 #include "MapDefinition.h"
 #include "MapType.h"
+#include "../Interface/FrameTimings.h"
 
 #include "components/debug/Debug.h"
 
@@ -39,8 +40,10 @@ const EntityManager &LevelInstance::getEntityManager() const
 }
 
 void LevelInstance::update(double dt, const ChunkInt2 &centerChunk,
-	int activeLevelIndex, const MapDefinition &mapDefinition, int chunkDistance)
+	int activeLevelIndex, const MapDefinition &mapDefinition, int chunkDistance, FrameTimings &frameTimings)
 {
+	const FrameTimings::TimePoint chunkStartTime = FrameTimings::now();
 	this->chunkManager.update(dt, centerChunk, activeLevelIndex, mapDefinition, chunkDistance,
 		this->entityManager);
+	frameTimings.addStageTime(FrameTimings::Stage::ChunkUpdate, chunkStartTime);
 }
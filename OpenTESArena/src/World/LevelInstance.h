@@ -9,6 +9,7 @@
 // Instance of a level with voxels and entities. Its data is in a baked, context-sensitive format
 // and depends on one or more level definitions for its population.
 
+class FrameTimings;
 class MapDefinition;
 
 enum class MapType;
@@ -30,7 +31,7 @@ public:
 	const EntityManager &getEntityManager() const;
 
 	void update(double dt, const ChunkInt2 &centerChunk, int activeLevelIndex,
-		const MapDefinition &mapDefinition, int chunkDistance);
+		const MapDefinition &mapDefinition, int chunkDistance, FrameTimings &frameTimings);
 
 	// @todo: some "setActive()" like LevelData so the renderer can be initialized with this level's data.
 	// Probably also store the table of asset filenames/ImageIDs/etc. -> voxel/entity/etc. texture IDs in
@@ -20,6 +20,11 @@
 #include "components/utilities/BufferView.h"
 #include "components/utilities/String.h"
 
+namespace
+{
+	int NextMapGeneration = 0;
+}
+
 void MapDefinition::Interior::init(ArenaTypes::InteriorType interiorType)
 {
 	this->interiorType = interiorType;
@@ -67,9 +72,16 @@ const MapGeneration::WildChunkBuildingNameInfo *MapDefinition::Wild::getBuilding
 	return (iter != this->buildingNameInfos.end()) ? &(*iter) : nullptr;
 }
 
+MapDefinition::MapDefinition()
+{
+	this->generation = -1;
+}
+
 void MapDefinition::init(MapType mapType)
 {
 	this->mapType = mapType;
+	this->generation = NextMapGeneration;
+	NextMapGeneration++;
 }
 
 bool MapDefinition::initInteriorLevels(const MIFFile &mif, ArenaTypes::InteriorType interiorType,
@@ -572,6 +584,11 @@ MapType MapDefinition::getMapType() const
 	return this->mapType;
 }
 
+int MapDefinition::getGeneration() const
+{
+	return this->generation;
+}
+
 const MapDefinition::Interior &MapDefinition::getInterior() const
 {
 	DebugAssert(this->mapType == MapType::Interior);
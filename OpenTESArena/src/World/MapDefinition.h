@@ -81,6 +81,8 @@ private:
 	Interior interior;
 	Wild wild;
 
+	int generation; // Unique per initialized map, so caches can tell maps apart.
+
 	void init(MapType mapType);
 	bool initInteriorLevels(const MIFFile &mif, ArenaTypes::InteriorType interiorType,
 		const std::optional<uint32_t> &rulerSeed, const std::optional<bool> &rulerIsMale,
@@ -107,6 +109,8 @@ private:
 		TextureManager &textureManager);
 	void initStartPoints(const MIFFile &mif);
 public:
+	MapDefinition();
+
 	bool initInterior(const MapGeneration::InteriorGenInfo &generationInfo,
 		const CharacterClassLibrary &charClassLibrary, const EntityDefinitionLibrary &entityDefLibrary,
 		const BinaryAssetLibrary &binaryAssetLibrary, TextureManager &textureManager);
@@ -144,6 +148,9 @@ public:
 	MapType getMapType() const;
 	const Interior &getInterior() const;
 	const Wild &getWild() const;
+
+	// Gets the value that identifies this map's contents. Re-initializing gives a new value.
+	int getGeneration() const;
 };
 
 #endif
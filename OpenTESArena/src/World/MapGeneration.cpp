@@ -1468,23 +1468,7 @@ namespace MapGeneration
 				{
 					// Find the associated transition for this voxel (if any).
 					const std::optional<LevelDefinition::TransitionDefID> transitionDefID =
-						[outLevelDef, x, z]() -> std::optional<LevelDefinition::TransitionDefID>
-					{
-						const LevelInt3 voxel(x, 1, z);
-						for (int i = 0; i < outLevelDef->getTransitionPlacementDefCount(); i++)
-						{
-							const auto &placementDef = outLevelDef->getTransitionPlacementDef(i);
-							for (const LevelInt3 &position : placementDef.positions)
-							{
-								if (position == voxel)
-								{
-									return placementDef.id;
-								}
-							}
-						}
-
-						return std::nullopt;
-					}();
+						outLevelDef->tryGetTransitionAt(LevelInt3(x, 1, z));
 
 					if (!transitionDefID.has_value())
 					{
@@ -1656,23 +1640,7 @@ namespace MapGeneration
 				{
 					// Find the associated transition for this voxel (if any).
 					const std::optional<LevelDefinition::TransitionDefID> transitionDefID =
-						[&levelDef, x, z]() -> std::optional<LevelDefinition::TransitionDefID>
-					{
-						const LevelInt3 voxel(x, 1, z);
-						for (int i = 0; i < levelDef.getTransitionPlacementDefCount(); i++)
-						{
-							const auto &placementDef = levelDef.getTransitionPlacementDef(i);
-							for (const LevelInt3 &position : placementDef.positions)
-							{
-								if (position == voxel)
-								{
-									return placementDef.id;
-								}
-							}
-						}
-
-						return std::nullopt;
-					}();
+						levelDef.tryGetTransitionAt(LevelInt3(x, 1, z));
 
 					if (!transitionDefID.has_value())
 					{
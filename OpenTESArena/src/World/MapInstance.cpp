@@ -168,10 +168,11 @@ void MapInstance::setActiveLevelIndex(int levelIndex)
 }
 
 void MapInstance::update(double dt, const ChunkInt2 &centerChunk,
-	const MapDefinition &mapDefinition, double latitude, double daytimePercent, int chunkDistance)
+	const MapDefinition &mapDefinition, double latitude, double daytimePercent, int chunkDistance,
+	FrameTimings &frameTimings)
 {
 	LevelInstance &levelInst = this->getActiveLevel();
-	levelInst.update(dt, centerChunk, this->activeLevelIndex, mapDefinition, chunkDistance);
+	levelInst.update(dt, centerChunk, this->activeLevelIndex, mapDefinition, chunkDistance, frameTimings);
 
 	SkyInstance &skyInst = this->getActiveSky();
 	skyInst.update(dt, latitude, daytimePercent);
@@ -9,6 +9,7 @@
 // Contains instance data for the associated map definition. This is the current state of voxels,
 // entities, and sky for every level instance in the map.
 
+class FrameTimings;
 class MapDefinition;
 class TextureManager;
 
@@ -43,7 +44,7 @@ public:
 	void setActiveLevelIndex(int levelIndex);
 
 	void update(double dt, const ChunkInt2 &centerChunk, const MapDefinition &mapDefinition,
-		double latitude, double daytimePercent, int chunkDistance);
+		double latitude, double daytimePercent, int chunkDistance, FrameTimings &frameTimings);
 };
 
 #endif
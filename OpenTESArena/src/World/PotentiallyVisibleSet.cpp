@@ -0,0 +1,498 @@
+#include <algorithm>
+#include <cstdint>
+
+#include "PotentiallyVisibleSet.h"
+#include "VoxelGrid.h"
+
+#include "components/debug/Debug.h"
+
+namespace
+{
+	// Y level of interior walls, between the floor and the ceiling.
+	constexpr int MAIN_FLOOR_Y = 1;
+
+	// Line sets are clipped with a little slack so round-off only ever keeps extra lines.
+	constexpr double CLIP_EPSILON = 1e-9;
+
+	// A line v = (m * u) + c in an octant's local coordinates, where u is the major axis that lines
+	// move forward along and 0 <= m <= 1.
+	struct LinePoint
+	{
+		double m, c;
+	};
+
+	// Convex polygon of line parameters. Empty if no lines.
+	using LineSet = std::vector<LinePoint>;
+
+	// Line sets of the previous and current local column being swept, plus scratch space.
+	struct SweepBuffers
+	{
+		std::vector<LineSet> prevColumn, curColumn;
+		LineSet clipped, clippedTemp, merged, hull;
+	};
+
+	// Keeps the lines where (a * m) + (b * c) + d >= 0.
+	void ClipLineSet(const LineSet &src, double a, double b, double d, LineSet &dst)
+	{
+		dst.clear();
+
+		const int count = static_cast<int>(src.size());
+		for (int i = 0; i < count; i++)
+		{
+			const LinePoint &point = src[i];
+			const LinePoint &nextPoint = src[(i + 1) % count];
+			const double dist = (a * point.m) + (b * point.c) + d;
+			const double nextDist = (a * nextPoint.m) + (b * nextPoint.c) + d;
+			const bool isInside = dist >= -CLIP_EPSILON;
+			const bool isNextInside = nextDist >= -CLIP_EPSILON;
+			if (isInside)
+			{
+				dst.push_back(point);
+			}
+
+			if (isInside != isNextInside)
+			{
+				const double t = dist / (dist - nextDist);
+				dst.push_back(LinePoint { point.m + ((nextPoint.m - point.m) * t), point.c + ((nextPoint.c - point.c) * t) });
+			}
+		}
+	}
+
+	// Adds the lines that cross the segment from v = v0 to v = v1 at u = edgeU.
+	void AddLinesThroughUEdge(const LineSet &src, double edgeU, double v0, double v1, SweepBuffers &buffers)
+	{
+		ClipLineSet(src, edgeU, 1.0, -v0, buffers.clippedTemp);
+		ClipLineSet(buffers.clippedTemp, -edgeU, -1.0, v1, buffers.clipped);
+		buffers.merged.insert(buffers.merged.end(), buffers.clipped.begin(), buffers.clipped.end());
+	}
+
+	// Adds the lines that cross the segment from u = u0 to u = u1 at v = edgeV.
+	void AddLinesThroughVEdge(const LineSet &src, double edgeV, double u0, double u1, SweepBuffers &buffers)
+	{
+		ClipLineSet(src, u1, 1.0, -edgeV, buffers.clippedTemp);
+		ClipLineSet(buffers.clippedTemp, -u0, -1.0, edgeV, buffers.clipped);
+		buffers.merged.insert(buffers.merged.end(), buffers.clipped.begin(), buffers.clipped.end());
+	}
+
+	double GetCross(const LinePoint &origin, const LinePoint &a, const LinePoint &b)
+	{
+		return ((a.m - origin.m) * (b.c - origin.c)) - ((a.c - origin.c) * (b.m - origin.m));
+	}
+
+	// Replaces the merged line sets with their convex hull. This can only add lines, so visibility
+	// stays conservative.
+	void MakeConvexHull(SweepBuffers &buffers)
+	{
+		LineSet &points = buffers.merged;
+		if (points.size() < 3)
+		{
+			return;
+		}
+
+		std::sort(points.begin(), points.end(), [](const LinePoint &a, const LinePoint &b)
+		{
+			return (a.m < b.m) || ((a.m == b.m) && (a.c < b.c));
+		});
+
+		// Andrew's monotone chain.
+		LineSet &hull = buffers.hull;
+		hull.resize(points.size() * 2);
+		int hullCount = 0;
+		for (int i = 0; i < static_cast<int>(points.size()); i++)
+		{
+			while ((hullCount >= 2) && (GetCross(hull[hullCount - 2], hull[hullCount - 1], points[i]) <= 0.0))
+			{
+				hullCount--;
+			}
+
+			hull[hullCount] = points[i];
+			hullCount++;
+		}
+
+		const int lowerHullCount = hullCount + 1;
+		for (int i = static_cast<int>(points.size()) - 2; i >= 0; i--)
+		{
+			while ((hullCount >= lowerHullCount) && (GetCross(hull[hullCount - 2], hull[hullCount - 1], points[i]) <= 0.0))
+			{
+				hullCount--;
+			}
+
+			hull[hullCount] = points[i];
+			hullCount++;
+		}
+
+		hull.resize(std::max(hullCount - 1, 1));
+		std::swap(points, hull);
+	}
+
+	// Sweeps the lines leaving the given area in one octant of directions, marking the regions of
+	// every voxel column they reach (including opaque ones). Octant bit 0 flips X, bit 1 flips Z,
+	// and bit 2 makes Z the major axis.
+	void SweepOctant(int octant, SNInt startX, SNInt endX, WEInt startZ, WEInt endZ,
+		const std::vector<uint8_t> &opaqueColumns, SNInt width, WEInt depth, int regionCountX,
+		SweepBuffers &buffers, std::vector<uint8_t> &reachedRegions)
+	{
+		const bool flipX = (octant & 1) != 0;
+		const bool flipZ = (octant & 2) != 0;
+		const bool isZMajor = (octant & 4) != 0;
+
+		// Area in local coordinates.
+		const SNInt localStartX = flipX ? (width - endX) : startX;
+		const SNInt localEndX = flipX ? (width - startX) : endX;
+		const WEInt localStartZ = flipZ ? (depth - endZ) : startZ;
+		const WEInt localEndZ = flipZ ? (depth - startZ) : endZ;
+		const int startU = isZMajor ? localStartZ : localStartX;
+		const int endU = isZMajor ? localEndZ : localEndX;
+		const int startV = isZMajor ? localStartX : localStartZ;
+		const int endV = isZMajor ? localEndX : localEndZ;
+		const int countU = isZMajor ? depth : width;
+		const int countV = isZMajor ? width : depth;
+
+		auto getColumnIndex = [flipX, flipZ, isZMajor, width, depth](int u, int v)
+		{
+			const SNInt localX = isZMajor ? v : u;
+			const WEInt localZ = isZMajor ? u : v;
+			const SNInt x = flipX ? (width - 1 - localX) : localX;
+			const WEInt z = flipZ ? (depth - 1 - localZ) : localZ;
+			return x + (z * width);
+		};
+
+		// Lines never have an intercept outside of this.
+		const double maxC = static_cast<double>((countU + countV) * 2);
+
+		std::vector<LineSet> &prevColumn = buffers.prevColumn;
+		std::vector<LineSet> &curColumn = buffers.curColumn;
+		prevColumn.resize(countV);
+		curColumn.resize(countV);
+		for (int v = startV; v < countV; v++)
+		{
+			prevColumn[v].clear();
+		}
+
+		// Lines only move forward in U and V, so each column is reached from the one before it or the
+		// one below it.
+		int prevMaxV = -1;
+		for (int u = startU; u < countU; u++)
+		{
+			const bool isAreaU = u < endU;
+			int curMaxV = -1;
+			for (int v = startV; v < countV; v++)
+			{
+				const bool isArea = isAreaU && (v < endV);
+				const bool hasLinesBelow = (v > startV) && !curColumn[v - 1].empty();
+				if ((v > prevMaxV) && !isArea && !hasLinesBelow)
+				{
+					// Nothing else in this column can be reached.
+					for (int i = v; i < countV; i++)
+					{
+						curColumn[i].clear();
+					}
+
+					break;
+				}
+
+				buffers.merged.clear();
+				if ((u > startU) && !prevColumn[v].empty())
+				{
+					AddLinesThroughUEdge(prevColumn[v], u, v, v + 1.0, buffers);
+				}
+
+				if (hasLinesBelow)
+				{
+					AddLinesThroughVEdge(curColumn[v - 1], v, u, u + 1.0, buffers);
+				}
+
+				const int columnIndex = getColumnIndex(u, v);
+				const bool isOpaque = opaqueColumns[columnIndex] != 0;
+				if (isArea && !isOpaque)
+				{
+					// Lines can start anywhere in the area's open columns.
+					const LineSet allLines = { { 0.0, -maxC }, { 1.0, -maxC }, { 1.0, maxC }, { 0.0, maxC } };
+					ClipLineSet(allLines, -u, -1.0, v + 1.0, buffers.clippedTemp);
+					ClipLineSet(buffers.clippedTemp, u + 1.0, 1.0, -v, buffers.clipped);
+					buffers.merged.insert(buffers.merged.end(), buffers.clipped.begin(), buffers.clipped.end());
+				}
+
+				MakeConvexHull(buffers);
+
+				LineSet &lineSet = curColumn[v];
+				lineSet.clear();
+				if (!buffers.merged.empty())
+				{
+					const SNInt x = columnIndex % width;
+					const WEInt z = columnIndex / width;
+					const int regionIndex = (x >> PotentiallyVisibleSet::REGION_SHIFT) +
+						((z >> PotentiallyVisibleSet::REGION_SHIFT) * regionCountX);
+					reachedRegions[regionIndex] = 1;
+
+					if (!isOpaque)
+					{
+						std::swap(lineSet, buffers.merged);
+						curMaxV = v;
+					}
+				}
+			}
+
+			std::swap(prevColumn, curColumn);
+			prevMaxV = curMaxV;
+
+			if ((prevMaxV < 0) && !isAreaU)
+			{
+				break;
+			}
+		}
+	}
+}
+
+PotentiallyVisibleSet::PotentiallyVisibleSet()
+{
+	this->width = 0;
+	this->depth = 0;
+	this->regionCountX = 0;
+	this->regionCountZ = 0;
+	this->wordsPerRegion = 0;
+}
+
+int PotentiallyVisibleSet::getRegionIndex(SNInt x, WEInt z) const
+{
+	const int regionX = x >> PotentiallyVisibleSet::REGION_SHIFT;
+	const int regionZ = z >> PotentiallyVisibleSet::REGION_SHIFT;
+	const bool isValid = (x >= 0) && (z >= 0) && (regionX < this->regionCountX) && (regionZ < this->regionCountZ);
+	return isValid ? (regionX + (regionZ * this->regionCountX)) : -1;
+}
+
+bool PotentiallyVisibleSet::isRegionVisible(int fromRegionIndex, int toRegionIndex) const
+{
+	const uint64_t word = this->visibleRegionBits[(fromRegionIndex * this->wordsPerRegion) + (toRegionIndex >> 6)];
+	return ((word >> (toRegionIndex & 63)) & 1) != 0;
+}
+
+void PotentiallyVisibleSet::setRegionVisible(int fromRegionIndex, int toRegionIndex)
+{
+	uint64_t &word = this->visibleRegionBits[(fromRegionIndex * this->wordsPerRegion) + (toRegionIndex >> 6)];
+	word |= static_cast<uint64_t>(1) << (toRegionIndex & 63);
+}
+
+void PotentiallyVisibleSet::updateRegions(const std::vector<int> &regionIndices)
+{
+	const int regionWidth = 1 << PotentiallyVisibleSet::REGION_SHIFT;
+	const int regionCount = this->getRegionCount();
+
+	SweepBuffers buffers;
+	std::vector<uint8_t> reachedRegions(regionCount);
+	for (const int regionIndex : regionIndices)
+	{
+		const int regionX = regionIndex % this->regionCountX;
+		const int regionZ = regionIndex / this->regionCountX;
+		const SNInt startX = regionX << PotentiallyVisibleSet::REGION_SHIFT;
+		const WEInt startZ = regionZ << PotentiallyVisibleSet::REGION_SHIFT;
+		const SNInt endX = std::min(startX + regionWidth, this->width);
+		const WEInt endZ = std::min(startZ + regionWidth, this->depth);
+
+		std::fill(reachedRegions.begin(), reachedRegions.end(), 0);
+		reachedRegions[regionIndex] = 1;
+
+		for (int octant = 0; octant < 8; octant++)
+		{
+			SweepOctant(octant, startX, endX, startZ, endZ, this->opaqueColumns, this->width, this->depth,
+				this->regionCountX, buffers, reachedRegions);
+		}
+
+		auto rowBegin = this->visibleRegionBits.begin() + (regionIndex * this->wordsPerRegion);
+		std::fill(rowBegin, rowBegin + this->wordsPerRegion, 0);
+		for (int i = 0; i < regionCount; i++)
+		{
+			if (reachedRegions[i] != 0)
+			{
+				this->setRegionVisible(regionIndex, i);
+			}
+		}
+	}
+}
+
+bool PotentiallyVisibleSet::isInited() const
+{
+	return this->visibleRegionBits.size() > 0;
+}
+
+int PotentiallyVisibleSet::getRegionCount() const
+{
+	return this->regionCountX * this->regionCountZ;
+}
+
+int PotentiallyVisibleSet::getVisibleRegionCount(int regionIndex) const
+{
+	DebugAssertIndex(this->visibleRegionBits, regionIndex * this->wordsPerRegion);
+
+	int count = 0;
+	for (int i = 0; i < this->wordsPerRegion; i++)
+	{
+		uint64_t word = this->visibleRegionBits[(regionIndex * this->wordsPerRegion) + i];
+		while (word != 0)
+		{
+			word &= word - 1;
+			count++;
+		}
+	}
+
+	return count;
+}
+
+void PotentiallyVisibleSet::init(const VoxelGrid &voxelGrid)
+{
+	if (voxelGrid.getHeight() <= MAIN_FLOOR_Y)
+	{
+		DebugLogWarning("Voxel grid has no main floor for visibility.");
+		this->clear();
+		return;
+	}
+
+	this->width = voxelGrid.getWidth();
+	this->depth = voxelGrid.getDepth();
+
+	const int regionWidth = 1 << PotentiallyVisibleSet::REGION_SHIFT;
+	this->regionCountX = (this->width + regionWidth - 1) >> PotentiallyVisibleSet::REGION_SHIFT;
+	this->regionCountZ = (this->depth + regionWidth - 1) >> PotentiallyVisibleSet::REGION_SHIFT;
+	const int regionCount = this->getRegionCount();
+	this->wordsPerRegion = (regionCount + 63) / 64;
+	this->visibleRegionBits = std::vector<uint64_t>(regionCount * this->wordsPerRegion, 0);
+
+	// Only full walls block sight. Doors, diagonals, transparent walls, etc. might not.
+	this->opaqueColumns = std::vector<uint8_t>(this->width * this->depth);
+	for (WEInt z = 0; z < this->depth; z++)
+	{
+		for (SNInt x = 0; x < this->width; x++)
+		{
+			const uint16_t voxelID = voxelGrid.getVoxel(x, MAIN_FLOOR_Y, z);
+			const VoxelDefinition &voxelDef = voxelGrid.getVoxelDef(voxelID);
+			this->opaqueColumns[x + (z * this->width)] = (voxelDef.type == ArenaTypes::VoxelType::Wall) ? 1 : 0;
+		}
+	}
+
+	std::vector<int> regionIndices(regionCount);
+	for (int i = 0; i < regionCount; i++)
+	{
+		regionIndices[i] = i;
+	}
+
+	this->updateRegions(regionIndices);
+}
+
+void PotentiallyVisibleSet::updateClearedColumns(const VoxelGrid &voxelGrid, const std::vector<NewInt2> &columns)
+{
+	if (!this->isInited())
+	{
+		return;
+	}
+
+	DebugAssert(voxelGrid.getWidth() == this->width);
+	DebugAssert(voxelGrid.getDepth() == this->depth);
+
+	std::vector<int> clearedRegionIndices;
+	for (const NewInt2 &column : columns)
+	{
+		const int regionIndex = this->getRegionIndex(column.x, column.y);
+		if (regionIndex < 0)
+		{
+			continue;
+		}
+
+		// Walls cleared above or below the main floor don't change anything.
+		const uint16_t voxelID = voxelGrid.getVoxel(column.x, MAIN_FLOOR_Y, column.y);
+		const VoxelDefinition &voxelDef = voxelGrid.getVoxelDef(voxelID);
+		uint8_t &opaqueColumn = this->opaqueColumns[column.x + (column.y * this->width)];
+		if ((opaqueColumn == 0) || (voxelDef.type == ArenaTypes::VoxelType::Wall))
+		{
+			continue;
+		}
+
+		opaqueColumn = 0;
+		clearedRegionIndices.push_back(regionIndex);
+	}
+
+	if (clearedRegionIndices.size() == 0)
+	{
+		return;
+	}
+
+	// Any new line of sight passes through a cleared column, so it starts in a region that could
+	// already see that column.
+	std::vector<int> regionIndices;
+	const int regionCount = this->getRegionCount();
+	for (int i = 0; i < regionCount; i++)
+	{
+		const bool canSeeClearedRegion = std::any_of(clearedRegionIndices.begin(), clearedRegionIndices.end(),
+			[this, i](int clearedRegionIndex)
+		{
+			return this->isRegionVisible(i, clearedRegionIndex);
+		});
+
+		if (canSeeClearedRegion)
+		{
+			regionIndices.push_back(i);
+		}
+	}
+
+	this->updateRegions(regionIndices);
+}
+
+void PotentiallyVisibleSet::clear()
+{
+	this->visibleRegionBits.clear();
+	this->opaqueColumns.clear();
+	this->width = 0;
+	this->depth = 0;
+	this->regionCountX = 0;
+	this->regionCountZ = 0;
+	this->wordsPerRegion = 0;
+}
+
+bool PotentiallyVisibleSet::isVisible(const NewInt2 &fromVoxel, const NewInt2 &toVoxel) const
+{
+	if (!this->isInited())
+	{
+		return true;
+	}
+
+	const int fromRegionIndex = this->getRegionIndex(fromVoxel.x, fromVoxel.y);
+	const int toRegionIndex = this->getRegionIndex(toVoxel.x, toVoxel.y);
+	if ((fromRegionIndex < 0) || (toRegionIndex < 0))
+	{
+		return true;
+	}
+
+	return this->isRegionVisible(fromRegionIndex, toRegionIndex);
+}
+
+bool PotentiallyVisibleSet::isAreaVisible(const NewInt2 &fromVoxel, const NewInt2 &minVoxel,
+	const NewInt2 &maxVoxel) const
+{
+	if (!this->isInited())
+	{
+		return true;
+	}
+
+	const int fromRegionIndex = this->getRegionIndex(fromVoxel.x, fromVoxel.y);
+	if (fromRegionIndex < 0)
+	{
+		return true;
+	}
+
+	// Only the part of the area inside the level can be seen.
+	const int minRegionX = std::max(minVoxel.x, 0) >> PotentiallyVisibleSet::REGION_SHIFT;
+	const int minRegionZ = std::max(minVoxel.y, 0) >> PotentiallyVisibleSet::REGION_SHIFT;
+	const int maxRegionX = std::min(maxVoxel.x >> PotentiallyVisibleSet::REGION_SHIFT, this->regionCountX - 1);
+	const int maxRegionZ = std::min(maxVoxel.y >> PotentiallyVisibleSet::REGION_SHIFT, this->regionCountZ - 1);
+	for (int regionZ = minRegionZ; regionZ <= maxRegionZ; regionZ++)
+	{
+		for (int regionX = minRegionX; regionX <= maxRegionX; regionX++)
+		{
+			if (this->isRegionVisible(fromRegionIndex, regionX + (regionZ * this->regionCountX)))
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
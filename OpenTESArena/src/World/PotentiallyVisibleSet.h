@@ -0,0 +1,74 @@
+#ifndef POTENTIALLY_VISIBLE_SET_H
+#define POTENTIALLY_VISIBLE_SET_H
+
+#include <cstdint>
+#include <vector>
+
+#include "Coord.h"
+
+// Conservative region-to-region visibility for interiors, computed once when a level is loaded.
+// Interiors are static voxel mazes under a ceiling, so only full walls on the main floor block
+// sight; everything else (doors in particular) is treated as see-through so the set stays valid
+// no matter which doors are open.
+
+// The level is split into square regions of voxel columns. Each region stores the regions that
+// can be seen from anywhere inside it. For each of the eight octants of directions, the lines
+// leaving a region are swept column by column as a convex set of line parameters, which each open
+// voxel edge they cross clips. A column is visible if any line reaches it, so no line of sight is
+// missed regardless of distance.
+
+class VoxelGrid;
+
+class PotentiallyVisibleSet
+{
+public:
+	// Log2 width of each square region of voxel columns.
+	static constexpr int REGION_SHIFT = 2;
+private:
+	std::vector<uint64_t> visibleRegionBits; // One row of bits per region.
+	std::vector<uint8_t> opaqueColumns; // Voxel columns that block sight.
+	SNInt width;
+	WEInt depth;
+	int regionCountX, regionCountZ;
+	int wordsPerRegion;
+
+	// Returns the region containing the voxel column, or -1 if it is outside the level.
+	int getRegionIndex(SNInt x, WEInt z) const;
+
+	bool isRegionVisible(int fromRegionIndex, int toRegionIndex) const;
+	void setRegionVisible(int fromRegionIndex, int toRegionIndex);
+
+	// Recomputes the regions visible from each of the given regions.
+	void updateRegions(const std::vector<int> &regionIndices);
+public:
+	PotentiallyVisibleSet();
+
+	// Whether the set has been computed for the active level. When not, everything is visible.
+	bool isInited() const;
+
+	int getRegionCount() const;
+
+	// Number of regions visible from the given region, including itself.
+	int getVisibleRegionCount(int regionIndex) const;
+
+	// Recomputes visibility from the voxel grid's walls.
+	void init(const VoxelGrid &voxelGrid);
+
+	// Updates visibility after walls in the given voxel columns are cleared (i.e., faded away).
+	// Only regions that could already see those columns can gain lines of sight through them, so
+	// only those are recomputed.
+	void updateClearedColumns(const VoxelGrid &voxelGrid, const std::vector<NewInt2> &columns);
+
+	// Makes everything visible (i.e., for exteriors).
+	void clear();
+
+	// Returns whether anything in the target voxel column might be seen from the given voxel
+	// column. Voxel columns outside the level are always visible.
+	bool isVisible(const NewInt2 &fromVoxel, const NewInt2 &toVoxel) const;
+
+	// Returns whether any voxel column in the area might be seen from the given voxel column
+	// (i.e., for things like lights that affect their surroundings).
+	bool isAreaVisible(const NewInt2 &fromVoxel, const NewInt2 &minVoxel, const NewInt2 &maxVoxel) const;
+};
+
+#endif
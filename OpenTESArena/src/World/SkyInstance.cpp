@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 
 #include "ArenaSkyUtils.h"
@@ -15,81 +16,113 @@
 
 #include "components/debug/Debug.h"
 
+namespace
+{
+	// Small star directions are unit vectors, so each component is stored as a normalized 16-bit integer.
+	constexpr double SMALL_STAR_DIR_SCALE = 32767.0;
+
+	int16_t quantizeSmallStarComponent(double value)
+	{
+		const double clampedValue = std::clamp(value, -1.0, 1.0);
+		return static_cast<int16_t>(std::round(clampedValue * SMALL_STAR_DIR_SCALE));
+	}
+
+	double dequantizeSmallStarComponent(int16_t value)
+	{
+		return static_cast<double>(value) / SMALL_STAR_DIR_SCALE;
+	}
+}
+
 SkyInstance::ObjectInstance::ObjectInstance()
 {
-	this->type = static_cast<ObjectInstance::Type>(-1);
 	this->width = 0.0;
 	this->height = 0.0;
+	this->textureBuilderID = -1;
 }
 
-void SkyInstance::ObjectInstance::init(Type type, const Double3 &baseDirection, double width, double height)
+void SkyInstance::ObjectInstance::init(const Double3 &baseDirection, double width, double height,
+	TextureBuilderID textureBuilderID)
 {
-	this->type = type;
 	this->baseDirection = baseDirection;
+	this->transformedDirection = baseDirection;
 	this->width = width;
 	this->height = height;
+	this->textureBuilderID = textureBuilderID;
 }
 
-void SkyInstance::ObjectInstance::initGeneral(const Double3 &baseDirection, double width, double height,
-	TextureBuilderID textureBuilderID)
+const Double3 &SkyInstance::ObjectInstance::getBaseDirection() const
 {
-	this->init(ObjectInstance::Type::General, baseDirection, width, height);
-	this->general.textureBuilderID = textureBuilderID;
+	return this->baseDirection;
 }
 
-void SkyInstance::ObjectInstance::initSmallStar(const Double3 &baseDirection, double width, double height,
-	uint8_t paletteIndex)
+const Double3 &SkyInstance::ObjectInstance::getTransformedDirection() const
 {
-	this->init(ObjectInstance::Type::SmallStar, baseDirection, width, height);
-	this->smallStar.paletteIndex = paletteIndex;
+	return this->transformedDirection;
 }
 
-SkyInstance::ObjectInstance::Type SkyInstance::ObjectInstance::getType() const
+double SkyInstance::ObjectInstance::getWidth() const
 {
-	return this->type;
+	return this->width;
 }
 
-const Double3 &SkyInstance::ObjectInstance::getBaseDirection() const
+double SkyInstance::ObjectInstance::getHeight() const
 {
-	return this->baseDirection;
+	return this->height;
 }
 
-const Double3 &SkyInstance::ObjectInstance::getTransformedDirection() const
+TextureBuilderID SkyInstance::ObjectInstance::getTextureBuilderID() const
 {
-	return this->transformedDirection;
+	return this->textureBuilderID;
 }
 
-double SkyInstance::ObjectInstance::getWidth() const
+void SkyInstance::ObjectInstance::setTransformedDirection(const Double3 &direction)
 {
-	return this->width;
+	this->transformedDirection = direction;
 }
 
-double SkyInstance::ObjectInstance::getHeight() const
+void SkyInstance::ObjectInstance::setTextureBuilderID(TextureBuilderID textureBuilderID)
 {
-	return this->height;
+	this->textureBuilderID = textureBuilderID;
 }
 
-SkyInstance::ObjectInstance::General &SkyInstance::ObjectInstance::getGeneral()
+SkyInstance::SmallStarField::SmallStarField()
 {
-	DebugAssert(this->type == ObjectInstance::Type::General);
-	return this->general;
+	this->width = 0.0;
+	this->height = 0.0;
+	this->visible = false;
 }
 
-const SkyInstance::ObjectInstance::General &SkyInstance::ObjectInstance::getGeneral() const
+int SkyInstance::SmallStarField::getCount() const
 {
-	DebugAssert(this->type == ObjectInstance::Type::General);
-	return this->general;
+	return static_cast<int>(this->paletteIndices.size());
 }
 
-const SkyInstance::ObjectInstance::SmallStar &SkyInstance::ObjectInstance::getSmallStar() const
+void SkyInstance::SmallStarField::add(const Double3 &direction, uint8_t paletteIndex)
 {
-	DebugAssert(this->type == ObjectInstance::Type::SmallStar);
-	return this->smallStar;
+	const int16_t dirX = quantizeSmallStarComponent(direction.x);
+	const int16_t dirY = quantizeSmallStarComponent(direction.y);
+	const int16_t dirZ = quantizeSmallStarComponent(direction.z);
+	this->baseDirXs.push_back(dirX);
+	this->baseDirYs.push_back(dirY);
+	this->baseDirZs.push_back(dirZ);
+	this->dirXs.push_back(dirX);
+	this->dirYs.push_back(dirY);
+	this->dirZs.push_back(dirZ);
+	this->paletteIndices.push_back(paletteIndex);
 }
 
-void SkyInstance::ObjectInstance::setTransformedDirection(const Double3 &direction)
+void SkyInstance::SmallStarField::clear()
 {
-	this->transformedDirection = direction;
+	this->baseDirXs.clear();
+	this->baseDirYs.clear();
+	this->baseDirZs.clear();
+	this->dirXs.clear();
+	this->dirYs.clear();
+	this->dirZs.clear();
+	this->paletteIndices.clear();
+	this->width = 0.0;
+	this->height = 0.0;
+	this->visible = false;
 }
 
 SkyInstance::AnimInstance::AnimInstance(int objectIndex, const TextureBuilderIdGroup &textureBuilderIDs,
@@ -108,15 +141,7 @@ void SkyInstance::init(const SkyDefinition &skyDefinition, const SkyInfoDefiniti
 		TextureBuilderID textureBuilderID)
 	{
 		ObjectInstance objectInst;
-		objectInst.initGeneral(baseDirection, width, height, textureBuilderID);
-		this->objectInsts.emplace_back(std::move(objectInst));
-	};
-
-	auto addSmallStarObjectInst = [this](const Double3 &baseDirection, double width, double height,
-		uint8_t paletteIndex)
-	{
-		ObjectInstance objectInst;
-		objectInst.initSmallStar(baseDirection, width, height, paletteIndex);
+		objectInst.init(baseDirection, width, height, textureBuilderID);
 		this->objectInsts.emplace_back(std::move(objectInst));
 	};
 
@@ -126,6 +151,10 @@ void SkyInstance::init(const SkyDefinition &skyDefinition, const SkyInfoDefiniti
 		this->animInsts.emplace_back(objectIndex, textureBuilderIDs, targetSeconds);
 	};
 
+	this->objectInsts.clear();
+	this->animInsts.clear();
+	this->smallStars.clear();
+
 	// Spawn all sky objects from the ready-to-bake format. Any animated objects start on their first frame.
 	int landInstCount = 0;
 	for (int i = 0; i < skyDefinition.getLandPlacementDefCount(); i++)
@@ -222,19 +251,18 @@ void SkyInstance::init(const SkyDefinition &skyDefinition, const SkyInfoDefiniti
 		const SkyStarDefinition::Type starType = skyStarDef.getType();
 		if (starType == SkyStarDefinition::Type::Small)
 		{
-			// Small stars are 1x1 pixels.
+			// Small stars are 1x1 pixels and go in the star field instead of the object list.
 			const SkyStarDefinition::SmallStar &smallStar = skyStarDef.getSmallStar();
 			const uint8_t paletteIndex = smallStar.paletteIndex;
 			constexpr int imageWidth = 1;
 			constexpr int imageHeight = imageWidth;
-
-			double width, height;
-			SkyUtils::getSkyObjectDimensions(imageWidth, imageHeight, &width, &height);
+			SkyUtils::getSkyObjectDimensions(imageWidth, imageHeight, &this->smallStars.width,
+				&this->smallStars.height);
 
 			for (const Double3 &position : placementDef.positions)
 			{
 				// Use star direction directly.
-				addSmallStarObjectInst(position, width, height, paletteIndex);
+				this->smallStars.add(position, paletteIndex);
 			}
 		}
 		else if (starType == SkyStarDefinition::Type::Large)
@@ -259,13 +287,13 @@ void SkyInstance::init(const SkyDefinition &skyDefinition, const SkyInfoDefiniti
 				// Use star direction directly.
 				addGeneralObjectInst(position, width, height, *textureBuilderID);
 			}
+
+			starInstCount += static_cast<int>(placementDef.positions.size());
 		}
 		else
 		{
 			DebugNotImplementedMsg(std::to_string(static_cast<int>(starType)));
 		}
-
-		starInstCount += static_cast<int>(placementDef.positions.size());
 	}
 
 	this->starStart = this->airEnd;
@@ -393,38 +421,41 @@ int SkyInstance::getMoonEndIndex() const
 	return this->moonEnd;
 }
 
-bool SkyInstance::isObjectSmallStar(int objectIndex) const
-{
-	DebugAssertIndex(this->objectInsts, objectIndex);
-	return this->objectInsts[objectIndex].getType() != SkyInstance::ObjectInstance::Type::SmallStar;
-}
-
 void SkyInstance::getObject(int index, Double3 *outDirection, TextureBuilderID *outTextureBuilderID,
 	double *outWidth, double *outHeight) const
 {
 	DebugAssertIndex(this->objectInsts, index);
 	const ObjectInstance &objectInst = this->objectInsts[index];
 	*outDirection = objectInst.getTransformedDirection();
-
-	DebugAssert(objectInst.getType() == SkyInstance::ObjectInstance::Type::General);
-	*outTextureBuilderID = objectInst.getGeneral().textureBuilderID;
-
+	*outTextureBuilderID = objectInst.getTextureBuilderID();
 	*outWidth = objectInst.getWidth();
 	*outHeight = objectInst.getHeight();
 }
 
-void SkyInstance::getObjectSmallStar(int index, Double3 *outDirection, uint8_t *outPaletteIndex,
-	double *outWidth, double *outHeight) const
+int SkyInstance::getSmallStarCount() const
 {
-	DebugAssertIndex(this->objectInsts, index);
-	const ObjectInstance &objectInst = this->objectInsts[index];
-	*outDirection = objectInst.getTransformedDirection();
+	return this->smallStars.getCount();
+}
 
-	DebugAssert(objectInst.getType() == SkyInstance::ObjectInstance::Type::SmallStar);
-	*outPaletteIndex = objectInst.getSmallStar().paletteIndex;
+bool SkyInstance::areSmallStarsVisible() const
+{
+	return this->smallStars.visible;
+}
 
-	*outWidth = objectInst.getWidth();
-	*outHeight = objectInst.getHeight();
+void SkyInstance::getSmallStarDimensions(double *outWidth, double *outHeight) const
+{
+	*outWidth = this->smallStars.width;
+	*outHeight = this->smallStars.height;
+}
+
+void SkyInstance::getSmallStar(int index, Double3 *outDirection, uint8_t *outPaletteIndex) const
+{
+	DebugAssertIndex(this->smallStars.paletteIndices, index);
+	*outDirection = Double3(
+		dequantizeSmallStarComponent(this->smallStars.dirXs[index]),
+		dequantizeSmallStarComponent(this->smallStars.dirYs[index]),
+		dequantizeSmallStarComponent(this->smallStars.dirZs[index]));
+	*outPaletteIndex = this->smallStars.paletteIndices[index];
 }
 
 void SkyInstance::update(double dt, double latitude, double daytimePercent)
@@ -434,13 +465,6 @@ void SkyInstance::update(double dt, double latitude, double daytimePercent)
 	for (int i = 0; i < animInstCount; i++)
 	{
 		AnimInstance &animInst = this->animInsts[i];
-
-		// Small stars don't have animations.
-		if (this->isObjectSmallStar(animInst.objectIndex))
-		{
-			continue;
-		}
-
 		animInst.currentSeconds += dt;
 		if (animInst.currentSeconds >= animInst.targetSeconds)
 		{
@@ -454,10 +478,18 @@ void SkyInstance::update(double dt, double latitude, double daytimePercent)
 		
 		DebugAssertIndex(this->objectInsts, animInst.objectIndex);
 		ObjectInstance &objectInst = this->objectInsts[animInst.objectIndex];
+		objectInst.setTextureBuilderID(newTextureBuilderID);
+	}
 
-		DebugAssert(objectInst.getType() == SkyInstance::ObjectInstance::Type::General);
-		ObjectInstance::General &objectInstGeneral = objectInst.getGeneral();
-		objectInstGeneral.textureBuilderID = newTextureBuilderID;
+	// Small stars are only transformed when the sky is dark enough for them to be seen. They are
+	// updated in bulk over the packed arrays.
+	this->smallStars.visible = SkyUtils::canStarsBeVisible(daytimePercent);
+	if (this->smallStars.visible)
+	{
+		// @todo: actually transform direction based on latitude and time of day.
+		std::copy(this->smallStars.baseDirXs.begin(), this->smallStars.baseDirXs.end(), this->smallStars.dirXs.begin());
+		std::copy(this->smallStars.baseDirYs.begin(), this->smallStars.baseDirYs.end(), this->smallStars.dirYs.begin());
+		std::copy(this->smallStars.baseDirZs.begin(), this->smallStars.baseDirZs.end(), this->smallStars.dirZs.begin());
 	}
 
 	// Update transformed sky position of stars, suns, and moons.
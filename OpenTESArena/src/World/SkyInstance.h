@@ -22,54 +22,44 @@ class SkyInstance
 private:
 	class ObjectInstance
 	{
-	public:
-		// Slight breakage of the design since small stars don't have a 'texture'; in the future this should
-		// allocate a renderer texture ID instead of assuming 8-bit image handles.
-		enum class Type
-		{
-			General,
-			SmallStar
-		};
-
-		struct General
-		{
-			// Current texture of object (may change due to animation).
-			TextureBuilderID textureBuilderID;
-		};
-
-		struct SmallStar
-		{
-			uint8_t paletteIndex;
-		};
 	private:
 		Double3 baseDirection; // Position in sky before transformation.
 		Double3 transformedDirection; // Position in sky usable by other systems (may be updated frequently).
 		double width, height;
-		Type type;
-
-		union
-		{
-			General general;
-			SmallStar smallStar;
-		};
 
-		void init(Type type, const Double3 &baseDirection, double width, double height);
+		// Current texture of object (may change due to animation).
+		TextureBuilderID textureBuilderID;
 	public:
 		ObjectInstance();
 
-		void initGeneral(const Double3 &baseDirection, double width, double height, TextureBuilderID textureBuilderID);
-		void initSmallStar(const Double3 &baseDirection, double width, double height, uint8_t paletteIndex);
+		void init(const Double3 &baseDirection, double width, double height, TextureBuilderID textureBuilderID);
 
-		Type getType() const;
 		const Double3 &getBaseDirection() const;
 		const Double3 &getTransformedDirection() const;
 		double getWidth() const;
 		double getHeight() const;
-		General &getGeneral();
-		const General &getGeneral() const;
-		const SmallStar &getSmallStar() const;
+		TextureBuilderID getTextureBuilderID() const;
 
 		void setTransformedDirection(const Double3 &direction);
+		void setTextureBuilderID(TextureBuilderID textureBuilderID);
+	};
+
+	// Small stars are single pixels and can number in the thousands, so they are kept apart from
+	// other sky objects in packed arrays with quantized unit directions. They are only transformed
+	// when they might be seen.
+	struct SmallStarField
+	{
+		std::vector<int16_t> baseDirXs, baseDirYs, baseDirZs;
+		std::vector<int16_t> dirXs, dirYs, dirZs; // Transformed directions.
+		std::vector<uint8_t> paletteIndices;
+		double width, height; // Shared by all small stars.
+		bool visible;
+
+		SmallStarField();
+
+		int getCount() const;
+		void add(const Double3 &direction, uint8_t paletteIndex);
+		void clear();
 	};
 
 	// Animation data for each sky object with an animation.
@@ -84,12 +74,14 @@ private:
 
 	std::vector<ObjectInstance> objectInsts; // Each sky object instance.
 	std::vector<AnimInstance> animInsts; // Data for each sky object with an animation.
+	SmallStarField smallStars;
 	int landStart, landEnd, airStart, airEnd, starStart, starEnd, sunStart, sunEnd, moonStart, moonEnd;
 public:
 	void init(const SkyDefinition &skyDefinition, const SkyInfoDefinition &skyInfoDefinition,
 		TextureManager &textureManager);
 
-	// Start (inclusive) and end (exclusive) indices of each sky object type.
+	// Start (inclusive) and end (exclusive) indices of each sky object type. Small stars are not
+	// included.
 	int getLandStartIndex() const;
 	int getLandEndIndex() const;
 	int getAirStartIndex() const;
@@ -101,16 +93,15 @@ public:
 	int getMoonStartIndex() const;
 	int getMoonEndIndex() const;
 
-	// @todo: this is bad design; there should not be a small star type.
-	bool isObjectSmallStar(int objectIndex) const;
-
 	void getObject(int index, Double3 *outDirection, TextureBuilderID *outTextureBuilderID, double *outWidth,
 		double *outHeight) const;
 
-	// @todo: this is bad design; there should not be a small star type. Eventually get renderer
-	// resource IDs instead probably.
-	void getObjectSmallStar(int index, Double3 *outDirection, uint8_t *outPaletteIndex, double *outWidth,
-		double *outHeight) const;
+	// Small stars are separate from other sky objects. They are skipped during the day, in which
+	// case their directions are stale.
+	int getSmallStarCount() const;
+	bool areSmallStarsVisible() const;
+	void getSmallStarDimensions(double *outWidth, double *outHeight) const;
+	void getSmallStar(int index, Double3 *outDirection, uint8_t *outPaletteIndex) const;
 
 	void update(double dt, double latitude, double daytimePercent);
 };
@@ -1,4 +1,5 @@
 #include "SkyUtils.h"
+#include "../Game/ArenaClockUtils.h"
 #include "../Math/Constants.h"
 
 #include "components/debug/Debug.h"
@@ -49,3 +50,12 @@ int SkyUtils::getStarCountFromDensity(int starDensity)
 		DebugUnhandledReturnMsg(int, std::to_string(starDensity));
 	}
 }
+
+bool SkyUtils::canStarsBeVisible(double daytimePercent)
+{
+	const double endBrighteningPercent = ArenaClockUtils::AmbientEndBrightening.getPreciseTotalSeconds() /
+		static_cast<double>(Clock::SECONDS_IN_A_DAY);
+	const double startDimmingPercent = ArenaClockUtils::AmbientStartDimming.getPreciseTotalSeconds() /
+		static_cast<double>(Clock::SECONDS_IN_A_DAY);
+	return (daytimePercent < endBrighteningPercent) || (daytimePercent > startDimmingPercent);
+}
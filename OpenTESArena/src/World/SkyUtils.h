@@ -17,6 +17,10 @@ namespace SkyUtils
 
 	// Gets the number of stars to generate based on the given star density (new to this engine).
 	int getStarCountFromDensity(int starDensity);
+
+	// Returns whether stars might be visible at the given time of day, where 0 is midnight and 0.5 is
+	// noon. Outside of this window the sky is too bright for stars, so they can skip being updated.
+	bool canStarsBeVisible(double daytimePercent);
 }
 
 #endif
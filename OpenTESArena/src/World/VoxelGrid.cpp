@@ -4,11 +4,50 @@
 
 #include "components/debug/Debug.h"
 
+namespace
+{
+	int NextVoxelGridGeneration = 0;
+}
+
+void VoxelGrid::OccupancyLevel::init(int blockShift, SNInt width, int height, WEInt depth)
+{
+	const int blockWidth = 1 << blockShift;
+	this->blockShift = blockShift;
+	this->blockCountX = (width + blockWidth - 1) >> blockShift;
+	this->blockCountZ = (depth + blockWidth - 1) >> blockShift;
+
+	const int columnCount = this->blockCountX * this->blockCountZ;
+	this->layerCounts = std::vector<uint16_t>(columnCount * height, 0);
+	this->columnCounts = std::vector<int>(columnCount, 0);
+}
+
+int VoxelGrid::OccupancyLevel::getColumnIndex(SNInt x, WEInt z) const
+{
+	return (x >> this->blockShift) + ((z >> this->blockShift) * this->blockCountX);
+}
+
+int VoxelGrid::OccupancyLevel::getLayerIndex(SNInt x, int y, WEInt z) const
+{
+	return this->getColumnIndex(x, z) + (y * this->blockCountX * this->blockCountZ);
+}
+
 VoxelGrid::VoxelGrid(SNInt width, int height, WEInt depth)
 {
+	DebugAssert(height <= VoxelGrid::MAX_HEIGHT);
 	const int voxelCount = width * height * depth;
 	this->voxels = std::vector<uint16_t>(voxelCount, 0);
 
+	// All voxels start as air, so every occupancy block is empty.
+	for (int i = 0; i < VoxelGrid::OCCUPANCY_LEVEL_COUNT; i++)
+	{
+		this->occupancyLevels[i].init(VoxelGrid::OCCUPANCY_BLOCK_SHIFTS[i], width, height, depth);
+	}
+
+	this->columnMasks = std::vector<ColumnMask>(width * depth, 0);
+
+	this->generation = NextVoxelGridGeneration;
+	NextVoxelGridGeneration++;
+
 	this->width = width;
 	this->height = height;
 	this->depth = depth;
@@ -44,6 +83,11 @@ bool VoxelGrid::coordIsValid(SNInt x, int y, WEInt z) const
 		(z >= 0) && (z < this->depth);
 }
 
+int VoxelGrid::getGeneration() const
+{
+	return this->generation;
+}
+
 uint16_t VoxelGrid::getVoxel(SNInt x, int y, WEInt z) const
 {
 	const int index = this->getIndex(x, y, z);
@@ -87,8 +131,49 @@ uint16_t VoxelGrid::addVoxelDef(const VoxelDefinition &voxelDef)
 	return static_cast<uint16_t>(this->voxelDefs.size() - 1);
 }
 
+bool VoxelGrid::isOccupancyBlockEmpty(int level, SNInt x, int y, WEInt z) const
+{
+	DebugAssertIndex(this->occupancyLevels, level);
+	DebugAssert(this->coordIsValid(x, y, z));
+	const OccupancyLevel &occupancyLevel = this->occupancyLevels[level];
+	const int index = occupancyLevel.getLayerIndex(x, y, z);
+	return occupancyLevel.layerCounts.data()[index] == 0;
+}
+
+bool VoxelGrid::isOccupancyColumnBlockEmpty(int level, SNInt x, WEInt z) const
+{
+	DebugAssertIndex(this->occupancyLevels, level);
+	DebugAssert(this->coordIsValid(x, 0, z));
+	const OccupancyLevel &occupancyLevel = this->occupancyLevels[level];
+	const int index = occupancyLevel.getColumnIndex(x, z);
+	return occupancyLevel.columnCounts.data()[index] == 0;
+}
+
+VoxelGrid::ColumnMask VoxelGrid::getColumnMask(SNInt x, WEInt z) const
+{
+	DebugAssert(this->coordIsValid(x, 0, z));
+	return this->columnMasks.data()[x + (z * this->width)];
+}
+
 void VoxelGrid::setVoxel(SNInt x, int y, WEInt z, uint16_t id)
 {
 	const int index = this->getIndex(x, y, z);
-	this->voxels.data()[index] = id;
+	uint16_t &voxel = this->voxels.data()[index];
+
+	// ID 0 is always air. Only a change between air and non-air affects occupancy.
+	const int occupancyDelta = ((id != 0) ? 1 : 0) - ((voxel != 0) ? 1 : 0);
+	if (occupancyDelta != 0)
+	{
+		for (OccupancyLevel &occupancyLevel : this->occupancyLevels)
+		{
+			occupancyLevel.layerCounts[occupancyLevel.getLayerIndex(x, y, z)] += occupancyDelta;
+			occupancyLevel.columnCounts[occupancyLevel.getColumnIndex(x, z)] += occupancyDelta;
+		}
+
+		ColumnMask &columnMask = this->columnMasks[x + (z * this->width)];
+		const ColumnMask yBit = static_cast<ColumnMask>(1) << y;
+		columnMask = (id != 0) ? (columnMask | yBit) : (columnMask & ~yBit);
+	}
+
+	voxel = id;
 }
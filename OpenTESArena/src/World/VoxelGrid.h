@@ -1,6 +1,7 @@
 #ifndef VOXEL_GRID_H
 #define VOXEL_GRID_H
 
+#include <array>
 #include <cstdint>
 #include <functional>
 #include <optional>
@@ -16,13 +17,43 @@
 // there are over a few hundred unique voxel definitions, which mandates that the voxel
 // type itself be at least unsigned 16-bit.
 
+// The grid also keeps a coarse occupancy hierarchy over the XZ plane so ray casts can jump
+// across blocks of air instead of stepping through them one voxel at a time, and a mask of
+// non-air Y levels per voxel column so column drawing can skip empty heights.
+
 class VoxelGrid
 {
 public:
 	using VoxelDefPredicate = std::function<bool(const VoxelDefinition&)>;
+
+	// Log2 widths of each occupancy level's blocks, from coarsest to finest.
+	static constexpr std::array<int, 2> OCCUPANCY_BLOCK_SHIFTS = { 4, 2 };
+	static constexpr int OCCUPANCY_LEVEL_COUNT = static_cast<int>(OCCUPANCY_BLOCK_SHIFTS.size());
+
+	// Bit Y is set if the voxel column has a non-air voxel at that Y level.
+	using ColumnMask = uint64_t;
+	static constexpr int MAX_HEIGHT = 64;
 private:
+	// Number of non-air voxels in each square block of voxel columns at one granularity.
+	struct OccupancyLevel
+	{
+		int blockShift;
+		SNInt blockCountX;
+		WEInt blockCountZ;
+		std::vector<uint16_t> layerCounts; // Per block per Y level.
+		std::vector<int> columnCounts; // Per block across all Y levels.
+
+		void init(int blockShift, SNInt width, int height, WEInt depth);
+
+		int getColumnIndex(SNInt x, WEInt z) const;
+		int getLayerIndex(SNInt x, int y, WEInt z) const;
+	};
+
 	std::vector<uint16_t> voxels;
 	std::vector<VoxelDefinition> voxelDefs;
+	std::array<OccupancyLevel, OCCUPANCY_LEVEL_COUNT> occupancyLevels;
+	std::vector<ColumnMask> columnMasks;
+	int generation;
 	SNInt width;
 	int height;
 	WEInt depth;
@@ -40,6 +71,9 @@ public:
 	// Returns whether the given coordinate lies within the voxel grid.
 	bool coordIsValid(SNInt x, int y, WEInt z) const;
 
+	// Gets the value that identifies this voxel grid. Each new grid gets a new value.
+	int getGeneration() const;
+
 	// Convenience method for getting a voxel's ID.
 	uint16_t getVoxel(SNInt x, int y, WEInt z) const;
 
@@ -55,7 +89,18 @@ public:
 	// Adds a voxel definition and returns its assigned ID.
 	uint16_t addVoxelDef(const VoxelDefinition &voxelDef);
 
-	// Convenience method for setting a voxel's ID.
+	// Returns whether the given occupancy level's block containing the voxel has no non-air
+	// voxels on the voxel's Y level.
+	bool isOccupancyBlockEmpty(int level, SNInt x, int y, WEInt z) const;
+
+	// Returns whether the given occupancy level's block containing the voxel column has no
+	// non-air voxels at any Y level.
+	bool isOccupancyColumnBlockEmpty(int level, SNInt x, WEInt z) const;
+
+	// Gets the Y levels of the voxel column that have non-air voxels.
+	ColumnMask getColumnMask(SNInt x, WEInt z) const;
+
+	// Convenience method for setting a voxel's ID. Also keeps occupancy blocks up to date.
 	void setVoxel(SNInt x, int y, WEInt z, uint16_t id);
 };
 
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 
 #include "ChunkUtils.h"
@@ -236,3 +237,34 @@ void VoxelUtils::getSurroundingVoxels(const VoxelInt2 &voxel, int distance, Voxe
 	*outMinVoxel = VoxelInt2(voxel.x - distance, voxel.y - distance);
 	*outMaxVoxel = VoxelInt2(voxel.x + distance, voxel.y + distance);
 }
+
+int VoxelUtils::getDDABlockExitStepCount(int voxel, int blockShift, bool positiveDir)
+{
+	DebugAssert(voxel >= 0);
+	const int blockMask = (1 << blockShift) - 1;
+	const int blockOffset = voxel & blockMask;
+	return positiveDir ? ((blockMask - blockOffset) + 1) : (blockOffset + 1);
+}
+
+double VoxelUtils::getDDABoundaryDistance(double deltaDistSum, double deltaDist, int count)
+{
+	DebugAssert(count >= 1);
+
+	// Avoid (0 * infinity) for axes the ray is parallel to.
+	return (count > 1) ? (deltaDistSum + (static_cast<double>(count - 1) * deltaDist)) : deltaDistSum;
+}
+
+int VoxelUtils::getDDACrossingCount(double deltaDistSum, double deltaDist, double distance, bool inclusive,
+	int maxCount)
+{
+	// Negated comparisons so NaN sums (from a ray parallel to the axis) never cross.
+	if (inclusive ? !(deltaDistSum <= distance) : !(deltaDistSum < distance))
+	{
+		return 0;
+	}
+
+	const double boundaryCount = std::min((distance - deltaDistSum) / deltaDist, static_cast<double>(maxCount));
+	const int count = inclusive ? (static_cast<int>(boundaryCount) + 1) :
+		std::max(static_cast<int>(std::ceil(boundaryCount)), 1);
+	return std::min(count, maxCount);
+}
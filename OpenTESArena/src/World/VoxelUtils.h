@@ -67,6 +67,17 @@ namespace VoxelUtils
 	// clamp within any specified range.
 	void getSurroundingVoxels(const VoxelInt3 &voxel, int distance, VoxelInt3 *outMinVoxel, VoxelInt3 *outMaxVoxel);
 	void getSurroundingVoxels(const VoxelInt2 &voxel, int distance, VoxelInt2 *outMinVoxel, VoxelInt2 *outMaxVoxel);
+
+	// DDA helpers for jumping a ray across an aligned block of 2^blockShift voxels on one axis.
+	// Gets the number of steps along the axis for the ray to leave the voxel's block.
+	int getDDABlockExitStepCount(int voxel, int blockShift, bool positiveDir);
+
+	// Gets the ray distance of the axis' Nth voxel boundary (N >= 1) given the distance of the next one.
+	double getDDABoundaryDistance(double deltaDistSum, double deltaDist, int count);
+
+	// Gets how many of the axis' voxel boundaries lie before the given ray distance (or at it, if
+	// inclusive), up to some max.
+	int getDDACrossingCount(double deltaDistSum, double deltaDist, double distance, bool inclusive, int maxCount);
 }
 
 #endif
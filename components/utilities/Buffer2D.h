@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <memory>
 
+#include "BufferAllocator.h"
 #include "../debug/Debug.h"
 
 // Heap-allocated 1D array accessible as a 2D array.
@@ -14,7 +15,7 @@ template <typename T>
 class Buffer2D
 {
 private:
-	std::unique_ptr<T[]> data;
+	BufferPtr<T> data;
 	int width, height;
 
 	int getIndex(int x, int y) const
@@ -37,11 +38,11 @@ public:
 		this->init(width, height);
 	}
 
-	void init(int width, int height)
+	void init(int width, int height, BufferAllocation allocation = BufferAllocation::Default)
 	{
 		DebugAssert(width >= 0);
 		DebugAssert(height >= 0);
-		this->data = std::make_unique<T[]>(width * height);
+		this->data = BufferAllocator::allocate<T>(width * height, allocation);
 		this->width = width;
 		this->height = height;
 	}
@@ -0,0 +1,155 @@
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+
+#if defined(__linux__)
+#include <fstream>
+#include <limits>
+#include <string>
+
+#include <sys/mman.h>
+#endif
+
+#include "BufferAllocator.h"
+
+namespace
+{
+	bool largePagesEnabled = false;
+	std::atomic<size_t> largePageByteCount(0);
+
+	// Mapped size of each live large-page allocation, for unmapping.
+	std::unordered_map<void*, size_t> largePageMappings;
+	std::atomic<int> largePageMappingCount(0);
+	std::mutex largePageMutex;
+
+#if defined(__linux__)
+	// Reads the system's large page size from /proc/meminfo, or returns 0 if it isn't listed.
+	size_t readLargePageSize()
+	{
+		std::ifstream meminfo("/proc/meminfo");
+		std::string key;
+		while (meminfo >> key)
+		{
+			if (key == "Hugepagesize:")
+			{
+				size_t kilobytes;
+				if (meminfo >> kilobytes)
+				{
+					return kilobytes * 1024;
+				}
+
+				break;
+			}
+
+			meminfo.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+		}
+
+		return 0;
+	}
+
+	size_t getLargePageSize()
+	{
+		static const size_t largePageSize = readLargePageSize();
+		return largePageSize;
+	}
+#endif
+}
+
+bool BufferAllocator::isLargePagesEnabled()
+{
+	return largePagesEnabled;
+}
+
+void BufferAllocator::setLargePagesEnabled(bool enabled)
+{
+	largePagesEnabled = enabled;
+}
+
+size_t BufferAllocator::getLargePageByteCount()
+{
+	return largePageByteCount;
+}
+
+void *BufferAllocator::tryAllocateLargePages(size_t byteCount)
+{
+	if (!largePagesEnabled)
+	{
+		return nullptr;
+	}
+
+#if defined(__linux__)
+	// Smaller buffers can't fill a large page, so they stay on the heap.
+	const size_t largePageSize = getLargePageSize();
+	if ((largePageSize == 0) || (byteCount < largePageSize))
+	{
+		return nullptr;
+	}
+
+	const size_t mappedByteCount = ((byteCount + largePageSize - 1) / largePageSize) * largePageSize;
+	void *ptr = MAP_FAILED;
+
+#if defined(MAP_HUGETLB)
+	// Explicit huge pages only work if the system has some reserved, so this often fails.
+	ptr = mmap(nullptr, mappedByteCount, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+
+	if (ptr == MAP_FAILED)
+	{
+		// Fall back to a regular mapping and ask for transparent huge pages.
+		ptr = mmap(nullptr, mappedByteCount, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (ptr == MAP_FAILED)
+		{
+			return nullptr;
+		}
+
+#if defined(MADV_HUGEPAGE)
+		madvise(ptr, mappedByteCount, MADV_HUGEPAGE);
+#endif
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(largePageMutex);
+		largePageMappings.emplace(ptr, mappedByteCount);
+	}
+
+	largePageMappingCount++;
+	largePageByteCount += mappedByteCount;
+	return ptr;
+#else
+	// Other platforms need special privileges for large pages, so use the heap.
+	static_cast<void>(byteCount);
+	return nullptr;
+#endif
+}
+
+bool BufferAllocator::tryFreeLargePages(void *ptr)
+{
+	// Most buffers are never large-page backed, so skip the lookup when there are none.
+	if ((ptr == nullptr) || (largePageMappingCount == 0))
+	{
+		return false;
+	}
+
+	size_t mappedByteCount;
+	{
+		std::lock_guard<std::mutex> lock(largePageMutex);
+		const auto iter = largePageMappings.find(ptr);
+		if (iter == largePageMappings.end())
+		{
+			return false;
+		}
+
+		mappedByteCount = iter->second;
+		largePageMappings.erase(iter);
+	}
+
+#if defined(__linux__)
+	munmap(ptr, mappedByteCount);
+#endif
+
+	largePageMappingCount--;
+	largePageByteCount -= mappedByteCount;
+	return true;
+}